@@ -5,17 +5,27 @@
 #include "Weather.h"              // Definition for Weather data structure
 #include "Forecast.h"             // Definition for Forecast data structure
 #include "Property.h"             // Definition for Property data structure
+#include "TimeFormat.h"           // Location time zones and arithmetic time formatting
+#include "DerivedMetrics.h"       // Dew point, heat index, wind chill, apparent temperature
+#include "Metrics.h"              // Stage timers and request counters
+#include "Trace.h"                // Optional span tracing
+#include "CircuitBreaker.h"       // Per-host fail-fast state
+#include "TaskScheduler.h"        // I/O and CPU pools for batch requests
+#include "JsonFields.h"           // Single-pass field lookups with compile-time hashed names
 #include "httplib.h"              // External HTTP library
 #include "nlohmann/json.hpp"      // External JSON library
 
 #include <iostream>     // For error output (cerr)
-#include <sstream>      // For string manipulation (time formatting)
-#include <iomanip>      // For stream manipulators (put_time, setprecision)
 #include <stdexcept>    // For exception handling (json::exception)
 #include <utility>      // For std::move
-#include <ctime>        // For time conversions (epoch)
 #include <string>       // For std::string usage
 #include <memory>       // For std::unique_ptr, std::make_unique
+#include <chrono>       // For timing the HTTP round trip
+#include <cstdint>      // For int64_t trace timestamps
+#include <thread>       // For sleeping between retries
+#include <atomic>       // For the parallel build failure flag
+#include <vector>       // For batch results, per-day slots and derived-metric columns
+#include <algorithm>    // For std::max
 
 // Use standard namespace for convenience.
 using namespace std;
@@ -24,146 +34,579 @@ using json = nlohmann::json;
 
 // --- Constructor / Destructor ---
 
-// Initializes the HTTP client with the base URL and sets timeouts.
-APIConverter::APIConverter(const string& apiBaseUrl) {
-    client = make_unique<httplib::Client>(apiBaseUrl.c_str());
-    client->set_connection_timeout(5, 0); // 5 seconds connection timeout
-    client->set_read_timeout(10, 0);      // 10 seconds read timeout
-    units = "Metric"; // Default to Metric units
-}
+// Stores the base URL; HTTP clients are created when the first request needs one.
+APIConverter::APIConverter(const string& apiBaseUrl)
+    : baseUrl(apiBaseUrl), breaker(CircuitBreaker::forHost(apiBaseUrl)), lastGoodResponses("responses"),
+      cacheTtlSeconds(0) {}
 
 // Default destructor handles unique_ptr<httplib::Client> cleanup.
 APIConverter::~APIConverter() = default;
 
 // --- Configuration ---
 
-// Stores the provided API key.
-void APIConverter::setApiKey(const string& key) { apiKey = key; }
-// Stores the provided location identifier.
-void APIConverter::setLocation(const string& loc) { location = loc; }
+// Replaces the retry/backoff settings used for all requests.
+void APIConverter::setRetryPolicy(const RetryPolicy& policy) { retryPolicy = policy; }
+// Shares a rate limiter with this converter.
+void APIConverter::setRateLimiter(shared_ptr<RateLimiter> limiter) { rateLimiter = move(limiter); }
+// Shares a CPU pool with this converter.
+void APIConverter::setTaskScheduler(shared_ptr<TaskScheduler> scheduler) { taskScheduler = move(scheduler); }
+// Reuses responses for 'ttl' (clamped to >= 0).
+void APIConverter::setCacheTtl(chrono::seconds ttl) { cacheTtlSeconds.store(ttl.count() > 0 ? ttl.count() : 0); }
 
-// Sets the units if valid ("Metric" or "Imperial"), returns success status.
-bool APIConverter::setUnits(const string& unit) {
-     if (unit == "Metric" || unit == "Imperial") {
-        units = unit;
-        return true;
-    }
-    return false; // Indicate invalid unit provided
+void APIConverter::setLocationResolver(shared_ptr<LocationResolver> resolver) { locationResolver = move(resolver); }
+
+void APIConverter::setCacheLimits(size_t budgetBytes, EvictionPolicy policy) {
+    lastGoodResponses.setPolicy(policy);
+    lastGoodResponses.setBudget(budgetBytes);
 }
 
-// --- Helper: Safe JSON Access ---
+// --- Helper: JSON Field Tables ---
 namespace { // Anonymous namespace for internal linkage helpers
-
-    // Safely extracts a double value from a JSON object.
-    double getJsonDouble(const json& obj, const string& key, double defaultVal = 0.0) {
-        return obj.contains(key) && obj[key].is_number() ? obj[key].get<double>() : defaultVal;
+    using JsonFields::FieldValue;
+
+    // Members read from each kind of response object. Names are hashed at compile time, and
+    // each object's members are found in one pass (or, for lazy hours, one search per member).
+    enum LocationField { LOC_NAME, LOC_REGION, LOC_COUNTRY, LOC_LAT, LOC_LON, LOC_TZ_ID, LOC_LOCALTIME_EPOCH, LOC_LOCALTIME,
+                         LOCATION_FIELD_COUNT };
+    constexpr const char* LOCATION_FIELD_NAMES[LOCATION_FIELD_COUNT] = {
+        "name", "region", "country", "lat", "lon", "tz_id", "localtime_epoch", "localtime"};
+    constexpr auto LOCATION_FIELDS = JsonFields::makeTable(LOCATION_FIELD_NAMES);
+
+    // Hourly members (of forecast hours and the "current" block; metric and imperial side by side).
+    enum HourField {
+        HOUR_TIME_EPOCH, HOUR_TIME, HOUR_TEMP_C, HOUR_TEMP_F, HOUR_FEELSLIKE_C, HOUR_FEELSLIKE_F,
+        HOUR_WIND_KPH, HOUR_WIND_MPH, HOUR_WIND_DEGREE, HOUR_HUMIDITY, HOUR_VIS_KM, HOUR_VIS_MILES,
+        HOUR_GUST_KPH, HOUR_GUST_MPH, HOUR_PRECIP_MM, HOUR_PRECIP_IN, HOUR_CLOUD, HOUR_PRESSURE_MB,
+        HOUR_PRESSURE_IN, HOUR_UV, HOUR_CHANCE_OF_RAIN, HOUR_CHANCE_OF_SNOW, HOUR_LAST_UPDATED_EPOCH,
+        HOUR_CONDITION, HOUR_FIELD_COUNT
+    };
+    constexpr const char* HOUR_FIELD_NAMES[HOUR_FIELD_COUNT] = {
+        "time_epoch", "time", "temp_c", "temp_f", "feelslike_c", "feelslike_f",
+        "wind_kph", "wind_mph", "wind_degree", "humidity", "vis_km", "vis_miles",
+        "gust_kph", "gust_mph", "precip_mm", "precip_in", "cloud", "pressure_mb",
+        "pressure_in", "uv", "chance_of_rain", "chance_of_snow", "last_updated_epoch",
+        "condition"};
+    constexpr auto HOUR_FIELDS = JsonFields::makeTable(HOUR_FIELD_NAMES);
+    using HourValues = JsonFields::Fields<HOUR_FIELD_COUNT>;
+
+    // Reads single hour members by name, for lazy hours that decode one property at a time
+    // (indexed like HourValues).
+    struct HourLookup {
+        const json& hour;
+        FieldValue operator[](HourField field) const { return HOUR_FIELDS.find(hour, field); }
+    };
+
+    // Day summary members (the "day" block of a forecast day).
+    enum DayField {
+        DAY_AVGTEMP_C, DAY_AVGTEMP_F, DAY_MAXWIND_KPH, DAY_MAXWIND_MPH, DAY_AVGHUMIDITY,
+        DAY_TOTALPRECIP_MM, DAY_TOTALPRECIP_IN, DAY_AVGVIS_KM, DAY_AVGVIS_MILES, DAY_UV, DAY_FIELD_COUNT
+    };
+    constexpr const char* DAY_FIELD_NAMES[DAY_FIELD_COUNT] = {
+        "avgtemp_c", "avgtemp_f", "maxwind_kph", "maxwind_mph", "avghumidity",
+        "totalprecip_mm", "totalprecip_in", "avgvis_km", "avgvis_miles", "uv"};
+    constexpr auto DAY_FIELDS = JsonFields::makeTable(DAY_FIELD_NAMES);
+
+    // Members of a "forecastday" entry.
+    enum ForecastDayField { FDAY_DATE, FDAY_DAY, FDAY_HOUR, FORECASTDAY_FIELD_COUNT };
+    constexpr const char* FORECASTDAY_FIELD_NAMES[FORECASTDAY_FIELD_COUNT] = {"date", "day", "hour"};
+    constexpr auto FORECASTDAY_FIELDS = JsonFields::makeTable(FORECASTDAY_FIELD_NAMES);
+
+    // Property names and fixed units, interned once and shared by every forecast hour.
+    const InternedString NAME_TEMPERATURE("Temperature");
+    const InternedString NAME_FEELS_LIKE("Feels Like");
+    const InternedString NAME_WIND_SPEED("Wind Speed");
+    const InternedString NAME_WIND_DIR("Wind Dir");
+    const InternedString NAME_HUMIDITY("Humidity");
+    const InternedString NAME_VISIBILITY("Visibility");
+    const InternedString NAME_GUST_SPEED("Gust Speed");
+    const InternedString NAME_PRECIPITATION("Precipitation");
+    const InternedString NAME_CLOUD_COVER("Cloud Cover");
+    const InternedString NAME_PRESSURE("Pressure");
+    const InternedString NAME_PRECIP_CHANCE("Precip Chance");
+    const InternedString NAME_AVG_TEMP("Avg Temp");
+    const InternedString NAME_MAX_WIND("Max Wind");
+    const InternedString NAME_AVG_HUMIDITY("Avg Humidity");
+    const InternedString NAME_TOTAL_PRECIP("Total Precip");
+    const InternedString NAME_AVG_VISIBILITY("Avg Visibility");
+    const InternedString NAME_MAX_UV("Max UV");
+    const InternedString NAME_AVG_DEW_POINT("Avg Dew Point");
+    const InternedString NAME_UV_INDEX("UV Index");
+    const InternedString NAME_LAST_UPDATED("Last Updated");
+    const InternedString UNIT_PERCENT("%");
+    const InternedString UNIT_EPOCH("Epoch");
+    const InternedString UNIT_NONE;
+
+    // Unit labels for one unit system, interned once per response.
+    struct UnitLabels {
+        bool isImperial;
+        InternedString tempUnit, speedUnit, precipUnit, visUnit, dirUnit, pressureUnit;
+
+        explicit UnitLabels(bool imperial)
+            : isImperial(imperial),
+              tempUnit(imperial ? "\370F" : "\370C"), // Degree symbol: \370
+              speedUnit(imperial ? "mph" : "km/h"),
+              precipUnit(imperial ? "in" : "mm"),
+              visUnit(imperial ? "miles" : "km"),
+              dirUnit("\370"), // Degree symbol for wind direction
+              pressureUnit(imperial ? "in" : "mb") {}
+    };
+
+    // Reads the "location" block, deriving the location's UTC offset once from its
+    // localtime/localtime_epoch pair (host TZ settings play no part).
+    LocationInfo parseLocation(const json& data) {
+        LocationInfo info;
+        FieldValue block = JsonFields::find(data, "location");
+        if (!block.present()) { return info; }
+        const auto loc = LOCATION_FIELDS.resolve(block.value());
+        info.name = loc[LOC_NAME].text();
+        info.region = loc[LOC_REGION].text();
+        info.country = loc[LOC_COUNTRY].text();
+        info.tzId = loc[LOC_TZ_ID].text("UTC");
+        info.hasCoordinates = loc[LOC_LAT].present() && loc[LOC_LON].present();
+        info.latitude = loc[LOC_LAT].number();
+        info.longitude = loc[LOC_LON].number();
+        info.utcOffsetSeconds = TimeFormat::utcOffsetFromLocal(loc[LOC_LOCALTIME_EPOCH].integer(),
+                                                               loc[LOC_LOCALTIME].text(""));
+        return info;
     }
-    // Safely extracts a string value from a JSON object.
-    string getJsonString(const json& obj, const string& key, const string& defaultVal = "N/A") {
-         return obj.contains(key) && obj[key].is_string() ? obj[key].get<string>() : defaultVal;
+
+    // Chance of any precipitation in an hour (rain or snow). 'hour' is a HourValues or HourLookup.
+    template <typename HourMembers>
+    double hourPrecipChance(const HourMembers& hour) {
+        return max(hour[HOUR_CHANCE_OF_RAIN].number(), hour[HOUR_CHANCE_OF_SNOW].number());
     }
-    // Safely extracts a long long integer value from a JSON object.
-    long long getJsonLong(const json& obj, const string& key, long long defaultVal = 0) {
-         return obj.contains(key) && obj[key].is_number_integer() ? obj[key].get<long long>() : defaultVal;
+
+    // Properties reported for each forecast hour (the derived ones are computed per day).
+    const PropertyIndex HOURLY_FIELDS[] = {TEMPERATURE, FEELS_LIKE, WIND_SPEED, WIND_DIRECTION, HUMIDITY,
+                                           VISIBILITY, GUST_SPEED, PRECIPITATION, CLOUD, PRESSURE,
+                                           PRECIP_PROBABILITY};
+
+    // Decodes one property of a forecast hour. Returns nullptr for properties not reported
+    // per hour. Used both up front (eager, from resolved HourValues) and on first access
+    // (lazy, through a HourLookup).
+    template <typename HourMembers>
+    Property* decodeHourProperty(const HourMembers& hour, PropertyIndex index, const UnitLabels& labels) {
+        bool isImperial = labels.isImperial;
+        switch (index) {
+            case TEMPERATURE: return new Property(NAME_TEMPERATURE, hour[isImperial ? HOUR_TEMP_F : HOUR_TEMP_C].number(), labels.tempUnit);
+            case FEELS_LIKE: return new Property(NAME_FEELS_LIKE, hour[isImperial ? HOUR_FEELSLIKE_F : HOUR_FEELSLIKE_C].number(), labels.tempUnit);
+            case WIND_SPEED: return new Property(NAME_WIND_SPEED, hour[isImperial ? HOUR_WIND_MPH : HOUR_WIND_KPH].number(), labels.speedUnit);
+            case WIND_DIRECTION: return new Property(NAME_WIND_DIR, hour[HOUR_WIND_DEGREE].number(), labels.dirUnit);
+            case HUMIDITY: return new Property(NAME_HUMIDITY, hour[HOUR_HUMIDITY].number(), UNIT_PERCENT);
+            case VISIBILITY: return new Property(NAME_VISIBILITY, hour[isImperial ? HOUR_VIS_MILES : HOUR_VIS_KM].number(), labels.visUnit);
+            case GUST_SPEED: return new Property(NAME_GUST_SPEED, hour[isImperial ? HOUR_GUST_MPH : HOUR_GUST_KPH].number(), labels.speedUnit);
+            case PRECIPITATION: return new Property(NAME_PRECIPITATION, hour[isImperial ? HOUR_PRECIP_IN : HOUR_PRECIP_MM].number(), labels.precipUnit);
+            case CLOUD: return new Property(NAME_CLOUD_COVER, hour[HOUR_CLOUD].number(), UNIT_PERCENT);
+            case PRESSURE: return new Property(NAME_PRESSURE, hour[isImperial ? HOUR_PRESSURE_IN : HOUR_PRESSURE_MB].number(), labels.pressureUnit);
+            case PRECIP_PROBABILITY: return new Property(NAME_PRECIP_CHANCE, hourPrecipChance(hour), UNIT_PERCENT);
+            default: return nullptr;
+        }
     }
-    // Safely extracts an integer value from a JSON object.
-     int getJsonInt(const json& obj, const string& key, int defaultVal = 0) {
-         return obj.contains(key) && obj[key].is_number_integer() ? obj[key].get<int>() : defaultVal;
+
+    // A parsed forecast response, kept alive by lazy hours that still decode from it.
+    struct ForecastDocument {
+        json data;
+        UnitLabels labels;
+        explicit ForecastDocument(bool imperial) : labels(imperial) {}
+    };
+
+    // Lazy property source for one forecast hour: its node in the shared parsed document.
+    class HourSource : public PropertySource {
+    private:
+        shared_ptr<const ForecastDocument> document; // Owns the JSON 'hourData' points into.
+        const json* hourData;
+
+    public:
+        HourSource(shared_ptr<const ForecastDocument> doc, const json* hour) : document(move(doc)), hourData(hour) {}
+        // Reads from the immutable document only, so concurrent calls are safe.
+        Property* decode(PropertyIndex index) const override {
+            return decodeHourProperty(HourLookup{*hourData}, index, document->labels);
+        }
+    };
+
+    // How hours are decoded: which fields, and whether up front or on first access.
+    struct DecodeOptions {
+        FieldMask fields;
+        shared_ptr<const ForecastDocument> lazyDocument; // Set in lazy mode (nullptr = eager).
+    };
+
+    // Builds one day's forecast (summary plus hourly details) from its "forecastday" entry.
+    // Touches nothing outside 'dayData' (and the read-only document), so days can be built
+    // concurrently. Only properties in 'options.fields' are produced.
+    DailyForecast buildDailyForecast(const json& dayData, const UnitLabels& labels, int utcOffsetSeconds,
+                                     const DecodeOptions& options) {
+        TRACE_SCOPE("build.day", "parse");
+        bool isImperial = labels.isImperial;
+        const FieldMask fields = options.fields;
+        const auto entry = FORECASTDAY_FIELDS.resolve(dayData);
+        string dateStr = entry[FDAY_DATE].text("Unknown Date");
+
+        // --- Process Daily Summary ---
+        Weather dayWeatherSummary; // Weather object for the day's summary.
+        if (entry[FDAY_DAY].present()) {
+            const auto day = DAY_FIELDS.resolve(entry[FDAY_DAY].value());
+            // Populate daily summary Weather object.
+            if (fields.has(TEMPERATURE)) { dayWeatherSummary.setProperty(TEMPERATURE, new Property(NAME_AVG_TEMP, day[isImperial ? DAY_AVGTEMP_F : DAY_AVGTEMP_C].number(), labels.tempUnit)); }
+            if (fields.has(WIND_SPEED)) { dayWeatherSummary.setProperty(WIND_SPEED, new Property(NAME_MAX_WIND, day[isImperial ? DAY_MAXWIND_MPH : DAY_MAXWIND_KPH].number(), labels.speedUnit)); }
+            if (fields.has(HUMIDITY)) { dayWeatherSummary.setProperty(HUMIDITY, new Property(NAME_AVG_HUMIDITY, day[DAY_AVGHUMIDITY].number(), UNIT_PERCENT)); }
+            if (fields.has(PRECIPITATION)) { dayWeatherSummary.setProperty(PRECIPITATION, new Property(NAME_TOTAL_PRECIP, day[isImperial ? DAY_TOTALPRECIP_IN : DAY_TOTALPRECIP_MM].number(), labels.precipUnit)); }
+            if (fields.has(VISIBILITY)) { dayWeatherSummary.setProperty(VISIBILITY, new Property(NAME_AVG_VISIBILITY, day[isImperial ? DAY_AVGVIS_MILES : DAY_AVGVIS_KM].number(), labels.visUnit)); }
+            if (fields.has(UV)) { dayWeatherSummary.setProperty(UV, new Property(NAME_MAX_UV, day[DAY_UV].number(), UNIT_NONE)); }
+        }
+        // --- Process Hourly Details ---
+        // Derived metrics and the day's precip rollup need whole columns, so they are read
+        // up front (as plain doubles) only when one of them was asked for.
+        const bool wantDerived = fields.hasAny(DerivedMetrics::derivedFields());
+        const bool wantChance = fields.has(PRECIP_PROBABILITY);
+        vector<Weather> hourlyWeathers;
+        vector<InternedString> hourTimes; // Interned: every day repeats the same 24 labels.
+        vector<long long> hourEpochs;
+        // Metric input columns for the derived-metrics batch (the API reports both unit systems).
+        vector<double> tempC, humidity, windKph, precipChance;
+        if (entry[FDAY_HOUR].present()) {
+            // Each hour's offset comes from its own local "time", so hours after a DST change
+            // (even within this day) are labelled correctly.
+            int offset = utcOffsetSeconds;
+            const auto& hours = entry[FDAY_HOUR].value();
+            hourlyWeathers.reserve(hours.size());
+            // Reads the per-hour columns (derived-metric inputs, precip chance, time) from
+            // resolved values or single lookups.
+            auto readColumns = [&](const auto& hour) {
+                if (wantDerived) {
+                    tempC.push_back(hour[HOUR_TEMP_C].number());
+                    humidity.push_back(hour[HOUR_HUMIDITY].number());
+                    windKph.push_back(hour[HOUR_WIND_KPH].number());
+                }
+                if (wantChance) { precipChance.push_back(hourPrecipChance(hour)); }
+
+                // Format the hour in the location's time zone (integer math, no localtime/strftime).
+                long long epochTime = hour[HOUR_TIME_EPOCH].integer();
+                offset = TimeFormat::utcOffsetFromLocal(epochTime, hour[HOUR_TIME].text(""), offset);
+                hourTimes.push_back(TimeFormat::formatHourMinute(epochTime, offset));
+                hourEpochs.push_back(epochTime);
+            };
+            // Iterate through each hour's data for the current day.
+            for (const auto& hourData : hours) {
+                Weather hourlyWeather; // Weather object for this specific hour.
+
+                if (options.lazyDocument) {
+                    // Lazy: keep a handle on this hour's node; getProperty decodes on demand.
+                    // Only the few columns below are read now, one search each.
+                    hourlyWeather.setLazySource(make_shared<HourSource>(options.lazyDocument, &hourData), fields);
+                    readColumns(HourLookup{hourData});
+                } else {
+                    // Eager: find all hour members in one pass, then populate the requested properties.
+                    const HourValues hour = HOUR_FIELDS.resolve(hourData);
+                    for (PropertyIndex index : HOURLY_FIELDS) {
+                        if (fields.has(index)) { hourlyWeather.setProperty(index, decodeHourProperty(hour, index, labels)); }
+                    }
+                    readColumns(hour);
+                }
+                hourlyWeathers.push_back(move(hourlyWeather));
+            }
+        }
+
+        // --- Derived Metrics (one batch for all hours of the day) ---
+        if (!hourlyWeathers.empty() && wantDerived) {
+            TRACE_SCOPE("derive.day", "parse");
+            vector<Weather*> targets;
+            targets.reserve(hourlyWeathers.size());
+            for (auto& weather : hourlyWeathers) { targets.push_back(&weather); }
+            DerivedMetrics::addToWeather(targets.data(), tempC.data(), humidity.data(), windKph.data(),
+                                         targets.size(), isImperial, fields);
+
+            // Day rollup: the mean dew point.
+            if (fields.has(DEW_POINT)) {
+                double dewSum = 0.0;
+                for (const auto& weather : hourlyWeathers) { dewSum += weather.getProperty(DEW_POINT)->getValue(); }
+                dayWeatherSummary.setProperty(DEW_POINT, new Property(NAME_AVG_DEW_POINT, dewSum / hourlyWeathers.size(), labels.tempUnit));
+            }
+        }
+        // Day rollup: chance of precipitation in any hour.
+        if (!precipChance.empty()) {
+            dayWeatherSummary.setProperty(PRECIP_PROBABILITY, new Property(NAME_PRECIP_CHANCE,
+                DerivedMetrics::precipProbabilityRollup(precipChance.data(), precipChance.size()), UNIT_PERCENT));
+        }
+
+        // Create DailyForecast object, transferring ownership of summary weather data.
+        DailyForecast dailyForecast(dateStr, move(dayWeatherSummary));
+        for (size_t i = 0; i < hourlyWeathers.size(); ++i) {
+            // Add the hourly forecast data to the current day's forecast.
+            // Transfers ownership of hourly weather data via move.
+            dailyForecast.addHourlyForecast(HourlyForecast(move(hourlyWeathers[i]), hourTimes[i], hourEpochs[i]));
+        }
+        return dailyForecast;
     }
+
+    // Responses at least this large (about 8+ forecast days) build their days in parallel
+    // when a scheduler is available; smaller ones are not worth the task overhead.
+    const size_t PARALLEL_BUILD_MIN_BYTES = 96 * 1024;
 } // end anonymous namespace
 
+// --- HTTP Helpers ---
+
+// Reuses an idle client if there is one; otherwise creates one with the standard timeouts.
+unique_ptr<httplib::Client> APIConverter::acquireClient() {
+    {
+        lock_guard<mutex> lock(clientsMutex);
+        if (!idleClients.empty()) {
+            unique_ptr<httplib::Client> client = move(idleClients.back());
+            idleClients.pop_back();
+            return client;
+        }
+    }
+    auto client = make_unique<httplib::Client>(baseUrl.c_str());
+    client->set_connection_timeout(5, 0); // 5 seconds connection timeout
+    client->set_read_timeout(10, 0);      // 10 seconds read timeout
+    // Called after DNS resolution, just before connect: marks the boundary in traces.
+    client->set_socket_options([](httplib::socket_t) { Trace::recordInstant("http.socket_created", "net"); });
+    return client;
+}
+
+void APIConverter::releaseClient(unique_ptr<httplib::Client> client) {
+    lock_guard<mutex> lock(clientsMutex);
+    idleClients.push_back(move(client));
+}
+
+// Performs a single GET request and records latency, byte and error metrics for it.
+// The body is streamed through a content receiver so the trace can separate the wait for
+// response headers (DNS, connect, upstream processing) from reading the body.
+bool APIConverter::fetchOnce(const string& path, string& body, int& status, string& retryAfter, string& errorDetail) {
+    TRACE_SCOPE("http.get", "net");
+    Metrics::increment(MetricCounter::REQUESTS);
+    body.clear();
+
+    auto fetchStart = chrono::steady_clock::now();
+    int64_t waitStart = Trace::isEnabled() ? Trace::nowMicros() : -1;
+    int64_t headersAt = -1;
+    unique_ptr<httplib::Client> client = acquireClient();
+    httplib::Result res = client->Get(path.c_str(),
+        [&](const httplib::Response&) { // Headers received.
+            if (waitStart >= 0) {
+                headersAt = Trace::nowMicros();
+                Trace::recordSpan("http.wait_headers", "net", waitStart, headersAt - waitStart);
+            }
+            return true;
+        },
+        [&](const char* data, size_t length) { // Body chunk received.
+            body.append(data, length);
+            return true;
+        });
+    if (headersAt >= 0) {
+        Trace::recordSpan("http.read_body", "net", headersAt, Trace::nowMicros() - headersAt);
+    }
+    Metrics::recordLatency(MetricStage::FETCH, chrono::steady_clock::now() - fetchStart);
+    releaseClient(move(client));
+
+    if (!res) { // No response object: network-level failure.
+        Metrics::recordTransportError(static_cast<int>(res.error()));
+        status = -1;
+        errorDetail = " HTTP request failed (Error code: " + httplib::to_string(res.error()) + "). Check URL and network.";
+        return false;
+    }
+    Metrics::increment(MetricCounter::BYTES_RECEIVED, body.size());
+    status = res->status;
+    if (res->status != 200) { // Response received but not successful.
+        Metrics::recordHttpStatus(res->status);
+        retryAfter = res->get_header_value("Retry-After");
+        errorDetail = " Status code: " + to_string(res->status);
+        return false;
+    }
+    return true;
+}
+
+// Wraps fetchOnce with the rate limiter, the retry policy and the per-host circuit breaker.
+// Transient failures (network errors, 408/429/5xx) are retried with jittered exponential
+// backoff, honouring Retry-After, within the policy's total time budget. If upstream stays
+// unavailable, the last good response for the same path is served instead (if any).
+bool APIConverter::fetch(const string& path, RequestPriority priority, string& body, string& errorDetail) {
+    auto callStart = chrono::steady_clock::now();
+
+    // Fresh enough: answer from the cache without spending an API call.
+    long long ttl = cacheTtlSeconds.load();
+    if (ttl > 0) {
+        CachedResponse cached;
+        if (lastGoodResponses.get(path, cached) && callStart - cached.fetchedAt < chrono::seconds(ttl)) {
+            Metrics::increment(MetricCounter::CACHE_HITS);
+            body = move(cached.body);
+            return true;
+        }
+        Metrics::increment(MetricCounter::CACHE_MISSES);
+    }
+
+    for (int attempt = 1; ; ++attempt) {
+        if (!breaker->allowRequest()) { // Fail fast while the host is considered down.
+            Metrics::increment(MetricCounter::CIRCUIT_REJECTIONS);
+            errorDetail = " Upstream unavailable (circuit open, next attempt in "
+                        + to_string((breaker->remainingOpenTime().count() + 999) / 1000) + "s).";
+            break;
+        }
+
+        // Every attempt (retries included) is a billable API call.
+        if (rateLimiter) {
+            TRACE_SCOPE("ratelimit.wait", "net");
+            if (!rateLimiter->acquire(priority, errorDetail)) {
+                Metrics::increment(MetricCounter::RATE_LIMITED);
+                breaker->cancelRequest(); // Not sent: a HALF_OPEN probe must not stay in flight.
+                break;
+            }
+        }
+
+        int status = 0;
+        string retryAfter;
+        if (fetchOnce(path, body, status, retryAfter, errorDetail)) {
+            breaker->recordSuccess();
+            // Remember for reuse and stale serving; fresh for the TTL, then first to go under TTL-weighted eviction.
+            auto fetchedAt = chrono::steady_clock::now();
+            lastGoodResponses.put(path, CachedResponse{body, fetchedAt}, stringHeapBytes(body),
+                                  fetchedAt + chrono::seconds(cacheTtlSeconds.load()));
+            return true;
+        }
+
+        bool transportError = (status < 0);
+        // Only network errors and 5xx count against host health; 4xx (bad key, bad location,
+        // throttling) means the host answered.
+        if (transportError || status >= 500) { breaker->recordFailure(); } else { breaker->recordSuccess(); }
+        if (!transportError && !RetryPolicy::isRetryableStatus(status)) {
+            return false; // Permanent error: retrying or serving stale data would hide it.
+        }
+        if (attempt >= retryPolicy.maxAttempts) { break; }
+
+        chrono::milliseconds delay = retryPolicy.backoffDelay(attempt);
+        chrono::milliseconds serverDelay = RetryPolicy::parseRetryAfter(retryAfter);
+        if (serverDelay.count() >= 0) { // Server told us when to come back (429/503).
+            if (serverDelay > retryPolicy.maxRetryAfter) { break; }
+            delay = serverDelay;
+        }
+        if (chrono::steady_clock::now() - callStart + delay > retryPolicy.totalBudget) { break; }
+
+        Metrics::increment(MetricCounter::RETRIES);
+        TRACE_SCOPE("http.backoff", "net");
+        this_thread::sleep_for(delay);
+    }
+
+    // Upstream unavailable (or request shed): fall back to the last good response for this request.
+    CachedResponse cached;
+    if (!lastGoodResponses.get(path, cached)) {
+        return false;
+    }
+    cerr << "Warning: Live data unavailable." << errorDetail << " Showing last retrieved data." << endl;
+    Metrics::increment(MetricCounter::STALE_RESPONSES);
+    body = move(cached.body);
+    return true;
+}
+
 // --- API Interaction ---
 
 // Fetches and parses the current weather data from the API.
-unique_ptr<CurrentWeatherReport> APIConverter::getCurrentWeather() {
+unique_ptr<CurrentWeatherReport> APIConverter::getCurrentWeather(const WeatherQuery& query, string* responseBody) {
+    TRACE_SCOPE("getCurrentWeather", "api");
     // Pre-flight checks for necessary configuration.
-    if (apiKey.empty() || location.empty()) {
+    if (query.getApiKey().empty() || query.getLocation().empty()) {
         cerr << "Error: API Key or Location is not set for APIConverter." << endl;
         return nullptr;
     }
-    if (!client) {
-         cerr << "Error: HTTP client not initialized." << endl;
-         return nullptr;
-    }
 
     // Construct the API request URL.
-    string apiUrl = "/v1/current.json?key=" + apiKey + "&q=" + location + "&aqi=no";
+    const string location = upstreamLocation(query.getLocation());
+    string apiUrl = "/v1/current.json?key=" + query.getApiKey() + "&q=" + location + "&aqi=no";
     // Perform the GET request.
-    httplib::Result res = client->Get(apiUrl.c_str());
+    string body, errorDetail;
+    if (!fetch(apiUrl, query.getPriority(), body, errorDetail)) { // Handle HTTP request errors (network issue, bad status code).
+        cerr << "Error fetching current weather data." << errorDetail << endl;
+        return nullptr; // Indicate failure.
+    }
+    LocationInfo site;
+    unique_ptr<CurrentWeatherReport> report = parseCurrentWeather(body, query, &site);
+    if (report) { learnLocation(location, site); }
+    if (report && responseBody != nullptr) { *responseBody = move(body); }
+    return report;
+}
 
+// Parses a current.json response body and builds the report. Uses no member state.
+unique_ptr<CurrentWeatherReport> APIConverter::parseCurrentWeather(const string& body, const WeatherQuery& query,
+                                                                   LocationInfo* locationOut) {
     Weather currentConditions; // Weather object to hold parsed data.
-
-    // Check for successful HTTP response.
-    if (res && res->status == 200) {
-        try {
-            json data = json::parse(res->body); // Parse the JSON response body.
-
-            // Display location information if available.
-            if (data.contains("location")) {
-                 const auto& loc = data["location"];
-                 cout << "Showing weather for: "
-                      << getJsonString(loc, "name") << ", "
-                      << getJsonString(loc, "region") << ", "
-                      << getJsonString(loc, "country") << endl;
+    try {
+        json data;
+        {
+            ScopedTimer parseTimer(MetricStage::PARSE);
+            TRACE_SCOPE("json.parse", "parse");
+            data = json::parse(body); // Parse the JSON response body.
+        }
+        ScopedTimer buildTimer(MetricStage::BUILD);
+        TRACE_SCOPE("build.current", "parse");
+
+        // Display location information if available.
+        LocationInfo location = parseLocation(data);
+        if (JsonFields::find(data, "location").present()) {
+             cout << "Showing weather for: "
+                  << location.name << ", " << location.region << ", " << location.country << endl;
+        }
+        // Times (e.g., Last Updated) are shown in the location's zone.
+        currentConditions.setTimeZone(location.utcOffsetSeconds, location.tzId);
+        if (locationOut != nullptr) { *locationOut = location; }
+
+        // Process the 'current' weather data block.
+        FieldValue currentBlock = JsonFields::find(data, "current");
+        if (currentBlock.present()) {
+            // All members of the block, found in one pass (it has the hourly layout).
+            const HourValues current = HOUR_FIELDS.resolve(currentBlock.value());
+            bool isImperial = query.isImperial();
+
+            // Determine unit strings based on the selected unit system (interned).
+            const InternedString tempUnit = isImperial ? "\370F" : "\370C";   // Degree symbol: \370
+            const InternedString speedUnit = isImperial ? "mph" : "km/h";
+            const InternedString precipUnit = isImperial ? "in" : "mm";
+            const InternedString pressureUnit = isImperial ? "in" : "mb";
+            const InternedString visUnit = isImperial ? "miles" : "km";
+            const InternedString dirUnit = "\370"; // Degree symbol for wind direction
+
+            // Populate the Weather object from the resolved members, skipping properties
+            // outside the query's field projection. Dynamically allocates Property objects.
+            const FieldMask fields = query.getFields();
+            if (fields.has(TEMPERATURE)) { currentConditions.setProperty(TEMPERATURE, new Property(NAME_TEMPERATURE, current[isImperial ? HOUR_TEMP_F : HOUR_TEMP_C].number(), tempUnit)); }
+            if (fields.has(FEELS_LIKE)) { currentConditions.setProperty(FEELS_LIKE, new Property(NAME_FEELS_LIKE, current[isImperial ? HOUR_FEELSLIKE_F : HOUR_FEELSLIKE_C].number(), tempUnit)); }
+            if (fields.has(WIND_SPEED)) { currentConditions.setProperty(WIND_SPEED, new Property(NAME_WIND_SPEED, current[isImperial ? HOUR_WIND_MPH : HOUR_WIND_KPH].number(), speedUnit)); }
+            if (fields.has(WIND_DIRECTION)) { currentConditions.setProperty(WIND_DIRECTION, new Property(NAME_WIND_DIR, current[HOUR_WIND_DEGREE].number(), dirUnit)); }
+            if (fields.has(HUMIDITY)) { currentConditions.setProperty(HUMIDITY, new Property(NAME_HUMIDITY, current[HOUR_HUMIDITY].number(), UNIT_PERCENT)); }
+            if (fields.has(PRESSURE)) { currentConditions.setProperty(PRESSURE, new Property(NAME_PRESSURE, current[isImperial ? HOUR_PRESSURE_IN : HOUR_PRESSURE_MB].number(), pressureUnit)); }
+            if (fields.has(VISIBILITY)) { currentConditions.setProperty(VISIBILITY, new Property(NAME_VISIBILITY, current[isImperial ? HOUR_VIS_MILES : HOUR_VIS_KM].number(), visUnit)); }
+            if (fields.has(UV)) { currentConditions.setProperty(UV, new Property(NAME_UV_INDEX, current[HOUR_UV].number(), UNIT_NONE)); }
+            if (fields.has(GUST_SPEED)) { currentConditions.setProperty(GUST_SPEED, new Property(NAME_GUST_SPEED, current[isImperial ? HOUR_GUST_MPH : HOUR_GUST_KPH].number(), speedUnit)); }
+            if (fields.has(PRECIPITATION)) { currentConditions.setProperty(PRECIPITATION, new Property(NAME_PRECIPITATION, current[isImperial ? HOUR_PRECIP_IN : HOUR_PRECIP_MM].number(), precipUnit)); }
+            if (fields.has(CLOUD)) { currentConditions.setProperty(CLOUD, new Property(NAME_CLOUD_COVER, current[HOUR_CLOUD].number(), UNIT_PERCENT)); }
+
+            // Derived comfort indicators (a batch of one).
+            if (fields.hasAny(DerivedMetrics::derivedFields())) {
+                double tempC = current[HOUR_TEMP_C].number();
+                double humidity = current[HOUR_HUMIDITY].number();
+                double windKph = current[HOUR_WIND_KPH].number();
+                Weather* target = &currentConditions;
+                DerivedMetrics::addToWeather(&target, &tempC, &humidity, &windKph, 1, isImperial, fields);
             }
 
-            // Process the 'current' weather data block.
-            if (data.contains("current")) {
-                const auto& current = data["current"];
-                bool isImperial = (units == "Imperial");
-
-                // Determine unit strings based on the selected unit system.
-                string tempUnit = isImperial ? "\370F" : "\370C";   // Degree symbol: \370
-                string speedUnit = isImperial ? "mph" : "km/h";
-                string precipUnit = isImperial ? "in" : "mm";
-                string pressureUnit = isImperial ? "in" : "mb";
-                string visUnit = isImperial ? "miles" : "km";
-                string dirUnit = "\370"; // Degree symbol for wind direction
-
-                // Populate the Weather object using safe JSON helpers.
-                // Dynamically allocates Property objects.
-                currentConditions.setProperty(TEMPERATURE, new Property("Temperature", getJsonDouble(current, isImperial ? "temp_f" : "temp_c"), tempUnit));
-                currentConditions.setProperty(FEELS_LIKE, new Property("Feels Like", getJsonDouble(current, isImperial ? "feelslike_f" : "feelslike_c"), tempUnit));
-                currentConditions.setProperty(WIND_SPEED, new Property("Wind Speed", getJsonDouble(current, isImperial ? "wind_mph" : "wind_kph"), speedUnit));
-                currentConditions.setProperty(WIND_DIRECTION, new Property("Wind Dir", getJsonDouble(current, "wind_degree"), dirUnit));
-                currentConditions.setProperty(HUMIDITY, new Property("Humidity", getJsonDouble(current, "humidity"), "%"));
-                currentConditions.setProperty(PRESSURE, new Property("Pressure", getJsonDouble(current, isImperial ? "pressure_in" : "pressure_mb"), pressureUnit));
-                currentConditions.setProperty(VISIBILITY, new Property("Visibility", getJsonDouble(current, isImperial ? "vis_miles" : "vis_km"), visUnit));
-                currentConditions.setProperty(UV, new Property("UV Index", getJsonDouble(current, "uv"), ""));
-                currentConditions.setProperty(GUST_SPEED, new Property("Gust Speed", getJsonDouble(current, isImperial ? "gust_mph" : "gust_kph"), speedUnit));
-                currentConditions.setProperty(PRECIPITATION, new Property("Precipitation", getJsonDouble(current, isImperial ? "precip_in" : "precip_mm"), precipUnit));
-                currentConditions.setProperty(CLOUD, new Property("Cloud Cover", getJsonDouble(current, "cloud"), "%"));
-
-                // Store epoch time as a double value in a Property.
-                long long epoch_ll = getJsonLong(current, "last_updated_epoch");
-                currentConditions.setProperty(LAST_UPDATED, new Property("Last Updated", static_cast<double>(epoch_ll), "Epoch"));
-
-                // Optionally log the text condition description.
-                 if (current.contains("condition") && current["condition"].contains("text")) {
-                      cout << "Condition: " << getJsonString(current["condition"], "text") << endl;
-                 }
+            // Store epoch time as a double value in a Property.
+            long long epoch_ll = current[HOUR_LAST_UPDATED_EPOCH].integer();
+            if (fields.has(LAST_UPDATED)) { currentConditions.setProperty(LAST_UPDATED, new Property(NAME_LAST_UPDATED, static_cast<double>(epoch_ll), UNIT_EPOCH)); }
 
-            } else {
-                 cerr << "Warning: 'current' data block missing in API response." << endl;
-                 // Proceed without current data, report might be empty.
-            }
+            // Optionally log the text condition description.
+             FieldValue conditionText = JsonFields::find(current[HOUR_CONDITION].value(), "text");
+             if (conditionText.present()) {
+                  cout << "Condition: " << conditionText.text() << endl;
+             }
 
-        } catch (const json::exception& e) { // Handle JSON parsing errors.
-            cerr << "JSON Error processing current weather: " << e.what() << endl;
-            return nullptr; // Indicate failure.
-        } catch (const exception& e) { // Handle other potential errors during processing.
-            cerr << "Error processing current weather data: " << e.what() << endl;
-             return nullptr;
+        } else {
+             cerr << "Warning: 'current' data block missing in API response." << endl;
+             // Proceed without current data, report might be empty.
         }
-    } else { // Handle HTTP request errors (network issue, bad status code).
-        string errorMsg = "Error fetching current weather data.";
-         if (res) { // If response object exists, include status code.
-            errorMsg += " Status code: " + to_string(res->status);
-        } else { // If no response object, use httplib error code.
-            errorMsg += " HTTP request failed (Error code: " + httplib::to_string(res.error()) + "). Check URL and network.";
-        }
-        cerr << errorMsg << endl;
+
+    } catch (const json::exception& e) { // Handle JSON parsing errors.
+        cerr << "JSON Error processing current weather: " << e.what() << endl;
         return nullptr; // Indicate failure.
+    } catch (const exception& e) { // Handle other potential errors during processing.
+        cerr << "Error processing current weather data: " << e.what() << endl;
+         return nullptr;
     }
 
     // If successful, create and return the report object, transferring ownership of Weather data.
@@ -171,113 +614,146 @@ unique_ptr<CurrentWeatherReport> APIConverter::getCurrentWeather() {
 }
 
 
+// Checks the query and day count before any network access.
+bool APIConverter::validateForecastRequest(const WeatherQuery& query, int days) {
+    if (query.getApiKey().empty() || query.getLocation().empty()) { cerr << "Error: API Key or Location not set." << endl; return false; }
+    if (days < 1 || days > 14) { cerr << "Error: Invalid forecast days requested (1-14)." << endl; return false; } // WeatherAPI limit
+    return true;
+}
+
+string APIConverter::upstreamLocation(const string& location) const {
+    return locationResolver ? locationResolver->resolve(location) : location;
+}
+
+void APIConverter::learnLocation(const string& upstream, const LocationInfo& location) const {
+    if (locationResolver) { locationResolver->learn(upstream, location); }
+}
+
+string APIConverter::forecastPath(const WeatherQuery& query, const string& location, int days) {
+    return "/v1/forecast.json?key=" + query.getApiKey() + "&q=" + location
+         + "&days=" + to_string(days) + "&aqi=no&alerts=no";
+}
+
 // Fetches and parses forecast weather data from the API.
-unique_ptr<ForecastReport> APIConverter::getForecastReport(int days, ForecastReport::DetailLevel detail) {
+unique_ptr<ForecastReport> APIConverter::getForecastReport(const WeatherQuery& query, int days, ForecastReport::DetailLevel detail,
+                                                           string* responseBody) {
+    TRACE_SCOPE("getForecastReport", "api");
     // Pre-flight checks.
-     if (apiKey.empty() || location.empty() ) { cerr << "Error: API Key or Location not set." << endl; return nullptr; }
-     if (days < 1 || days > 3) { cerr << "Error: Invalid forecast days requested (1-3)." << endl; return nullptr; } // WeatherAPI limit
-     if (!client) { cerr << "Error: HTTP client not initialized." << endl; return nullptr; }
+    if (!validateForecastRequest(query, days)) { return nullptr; }
 
-    // Construct forecast API request URL.
-    string apiUrl = "/v1/forecast.json?key=" + apiKey + "&q=" + location + "&days=" + to_string(days) + "&aqi=no&alerts=no";
     // Perform GET request.
-    httplib::Result res = client->Get(apiUrl.c_str());
+    const string location = upstreamLocation(query.getLocation());
+    string body, errorDetail;
+    if (!fetch(forecastPath(query, location, days), query.getPriority(), body, errorDetail)) { // Handle HTTP request errors.
+        cerr << "Error fetching forecast data." << errorDetail << endl;
+        return nullptr;
+    }
+    unique_ptr<ForecastReport> report = parseForecastReport(body, query, detail, taskScheduler.get());
+    if (report) { learnLocation(location, report->getForecast().getLocation()); }
+    if (report && responseBody != nullptr) { *responseBody = move(body); }
+    return report;
+}
+
+// Runs each request on the I/O pool; a completed response is handed straight to the CPU
+// pool, so parsing overlaps with requests that are still waiting on the network.
+vector<unique_ptr<ForecastReport>> APIConverter::getForecastReports(const vector<WeatherQuery>& queries, int days,
+                                                                   ForecastReport::DetailLevel detail,
+                                                                   TaskScheduler& scheduler) {
+    TRACE_SCOPE("getForecastReports", "api");
+    vector<unique_ptr<ForecastReport>> reports(queries.size());
+    TaskGroup group;
+
+    for (size_t i = 0; i < queries.size(); ++i) {
+        if (!validateForecastRequest(queries[i], days)) { continue; }
+        group.add();
+        scheduler.submitIo([this, &queries, &reports, &group, &scheduler, i, days, detail]() {
+            const string location = upstreamLocation(queries[i].getLocation());
+            string body, errorDetail;
+            if (!fetch(forecastPath(queries[i], location, days), queries[i].getPriority(), body, errorDetail)) {
+                cerr << "Error fetching forecast data for '" << queries[i].getLocation() << "'." << errorDetail << endl;
+                group.done();
+                return;
+            }
+            // Each task writes only its own slot, so no lock is needed on 'reports'.
+            scheduler.submitCpu([this, &queries, &reports, &group, &scheduler, i, detail, body, location]() {
+                reports[i] = parseForecastReport(body, queries[i], detail, &scheduler);
+                if (reports[i]) { learnLocation(location, reports[i]->getForecast().getLocation()); }
+                group.done();
+            });
+        });
+    }
+    group.wait();
+    return reports;
+}
 
+// Parses a forecast response body and builds the report. Uses no member state.
+// Large multi-day responses build each DailyForecast as a separate CPU task and assemble
+// them in the API's (date) order; the JSON text itself is still parsed in one pass.
+unique_ptr<ForecastReport> APIConverter::parseForecastReport(const string& body, const WeatherQuery& query,
+                                                             ForecastReport::DetailLevel detail,
+                                                             TaskScheduler* scheduler) {
     Forecast forecastDataContainer; // Forecast object to hold parsed data.
 
-    // Check for successful HTTP response.
-    if (res && res->status == 200) {
-         try {
-            json data = json::parse(res->body); // Parse JSON response.
-
-            // Check for the main forecast data array.
-            if (data.contains("forecast") && data["forecast"].contains("forecastday")) {
-                 bool isImperial = (units == "Imperial"); // Check units once.
-
-                 // Determine unit strings based on the selected unit system.
-                 string tempUnit = isImperial ? "\370F" : "\370C";
-                 string speedUnit = isImperial ? "mph" : "km/h";
-                 string precipUnit = isImperial ? "in" : "mm";
-                 string visUnit = isImperial ? "miles" : "km";
-                 string dirUnit = "\370"; // Degree symbol for wind direction
-                 string pressureUnit = isImperial ? "in" : "mb";
-
-                 // Iterate through each day in the forecast array.
-                 for (const auto& dayData : data["forecast"]["forecastday"]) {
-                     string dateStr = getJsonString(dayData, "date", "Unknown Date");
-
-                     // --- Process Daily Summary ---
-                     Weather dayWeatherSummary; // Weather object for the day's summary.
-                     if (dayData.contains("day")) {
-                          const auto& day = dayData["day"];
-                          // Populate daily summary Weather object.
-                          dayWeatherSummary.setProperty(TEMPERATURE, new Property("Avg Temp", getJsonDouble(day, isImperial ? "avgtemp_f" : "avgtemp_c"), tempUnit));
-                          dayWeatherSummary.setProperty(WIND_SPEED, new Property("Max Wind", getJsonDouble(day, isImperial ? "maxwind_mph" : "maxwind_kph"), speedUnit));
-                          dayWeatherSummary.setProperty(HUMIDITY, new Property("Avg Humidity", getJsonDouble(day, "avghumidity"), "%"));
-                          dayWeatherSummary.setProperty(PRECIPITATION, new Property("Total Precip", getJsonDouble(day, isImperial ? "totalprecip_in" : "totalprecip_mm"), precipUnit));
-                          dayWeatherSummary.setProperty(VISIBILITY, new Property("Avg Visibility", getJsonDouble(day, isImperial ? "avgvis_miles" : "avgvis_km"), visUnit));
-                          dayWeatherSummary.setProperty(UV, new Property("Max UV", getJsonDouble(day, "uv"), ""));
-                     }
-                     // Create DailyForecast object, transferring ownership of summary weather data.
-                     DailyForecast dailyForecast(dateStr, move(dayWeatherSummary));
-
-                     // --- Process Hourly Details ---
-                      if (dayData.contains("hour")) {
-                          // Iterate through each hour's data for the current day.
-                          for (const auto& hourData : dayData["hour"]) {
-                             Weather hourlyWeather; // Weather object for this specific hour.
-
-                             // Populate hourly Weather object.
-                             hourlyWeather.setProperty(TEMPERATURE, new Property("Temperature", getJsonDouble(hourData, isImperial ? "temp_f" : "temp_c"), tempUnit));
-                             hourlyWeather.setProperty(FEELS_LIKE, new Property("Feels Like", getJsonDouble(hourData, isImperial ? "feelslike_f" : "feelslike_c"), tempUnit));
-                             hourlyWeather.setProperty(WIND_SPEED, new Property("Wind Speed", getJsonDouble(hourData, isImperial ? "wind_mph" : "wind_kph"), speedUnit));
-                             hourlyWeather.setProperty(WIND_DIRECTION, new Property("Wind Dir", getJsonDouble(hourData, "wind_degree"), dirUnit));
-                             hourlyWeather.setProperty(HUMIDITY, new Property("Humidity", getJsonDouble(hourData, "humidity"), "%"));
-                             hourlyWeather.setProperty(VISIBILITY, new Property("Visibility", getJsonDouble(hourData, isImperial ? "vis_miles" : "vis_km"), visUnit));
-                             hourlyWeather.setProperty(GUST_SPEED, new Property("Gust Speed", getJsonDouble(hourData, isImperial ? "gust_mph" : "gust_kph"), speedUnit));
-                             hourlyWeather.setProperty(PRECIPITATION, new Property("Precipitation", getJsonDouble(hourData, isImperial ? "precip_in" : "precip_mm"), precipUnit));
-                             hourlyWeather.setProperty(CLOUD, new Property("Cloud Cover", getJsonDouble(hourData, "cloud"), "%"));
-                             hourlyWeather.setProperty(PRESSURE, new Property("Pressure", getJsonDouble(hourData, isImperial ? "pressure_in" : "pressure_mb"), pressureUnit));
-
-                             // Convert epoch time to HH:MM string format.
-                             long long epochTimeLL = getJsonLong(hourData, "time_epoch");
-                             time_t epochTime = static_cast<time_t>(epochTimeLL);
-                             tm timeinfo = {};
-                             #ifdef _WIN32 // Platform-specific safe time conversion.
-                                 localtime_s(&timeinfo, &epochTime);
-                             #else
-                                 localtime_r(&epochTime, &timeinfo); // POSIX version
-                             #endif
-                             stringstream timeStream;
-                             timeStream << put_time(&timeinfo, "%H:%M"); // Format as HH:MM.
-                             string timeStr = timeStream.str();
-
-                             // Add the hourly forecast data to the current day's forecast.
-                             // Transfers ownership of hourlyWeather data via move.
-                             dailyForecast.addHourlyForecast(HourlyForecast(move(hourlyWeather), timeStr));
-                          }
-                     }
-                     // Add the completed daily forecast (with hourly data) to the main container.
-                     // Transfers ownership of dailyForecast data via move.
-                     forecastDataContainer.addDailyForecast(move(dailyForecast));
-                 }
-             } else {
-                 cerr << "Warning: 'forecast'/'forecastday' data block missing in API response." << endl;
-             }
+    try {
+        // Parsed response and unit labels (checked once). Lazy hours share ownership of it.
+        auto document = make_shared<ForecastDocument>(query.isImperial());
+        {
+            ScopedTimer parseTimer(MetricStage::PARSE);
+            TRACE_SCOPE("json.parse", "parse");
+            document->data = json::parse(body); // Parse JSON response.
+        }
+        ScopedTimer buildTimer(MetricStage::BUILD);
+        TRACE_SCOPE("build.forecast", "parse");
+        const json& data = document->data;
+        const UnitLabels& labels = document->labels;
+        DecodeOptions options;
+        options.fields = query.getFields();
+        if (query.isLazy()) { options.lazyDocument = document; }
+
+        // Check for the main forecast data array.
+        FieldValue forecastDaysValue = JsonFields::find(JsonFields::find(data, "forecast").value(), "forecastday");
+        if (forecastDaysValue.present()) {
+            const json& forecastDays = forecastDaysValue.value();
+            LocationInfo location = parseLocation(data);
+            const int utcOffset = location.utcOffsetSeconds;
+            forecastDataContainer.setLocation(move(location));
+
+            if (scheduler != nullptr && forecastDays.size() > 1 && body.size() >= PARALLEL_BUILD_MIN_BYTES) {
+                // One task per day; each writes only its own slot.
+                vector<unique_ptr<DailyForecast>> days(forecastDays.size());
+                atomic<bool> failed(false);
+                TaskGroup group;
+                group.add(static_cast<int>(days.size()));
+                for (size_t i = 0; i < days.size(); ++i) {
+                    scheduler->submitCpu([&, i]() {
+                        try {
+                            days[i] = make_unique<DailyForecast>(buildDailyForecast(forecastDays[i], labels, utcOffset, options));
+                        } catch (const exception& e) {
+                            cerr << "Error processing forecast day " << i + 1 << ": " << e.what() << endl;
+                            failed = true;
+                        }
+                        group.done();
+                    });
+                }
+                scheduler->wait(group);
+                if (failed) { return nullptr; }
+                for (auto& day : days) { forecastDataContainer.addDailyForecast(move(*day)); }
+            } else {
+                // Iterate through each day in the forecast array.
+                for (const auto& dayData : forecastDays) {
+                    // Transfers ownership of the day's data via move.
+                    forecastDataContainer.addDailyForecast(buildDailyForecast(dayData, labels, utcOffset, options));
+                }
+            }
+        } else {
+            cerr << "Warning: 'forecast'/'forecastday' data block missing in API response." << endl;
+        }
 
-         } catch (const json::exception& e) { // Handle JSON parsing errors.
-             cerr << "JSON Error processing forecast: " << e.what() << endl;
-             return nullptr;
-         } catch (const exception& e) { // Handle other processing errors.
-              cerr << "Error processing forecast data: " << e.what() << endl;
-             return nullptr;
-         }
-    } else { // Handle HTTP request errors.
-        string errorMsg = "Error fetching forecast data.";
-         if (res) {
-            errorMsg += " Status code: " + to_string(res->status);
-        } else { errorMsg += " HTTP request failed (Error code: " + httplib::to_string(res.error()) + ")."; }
-        cerr << errorMsg << endl;
+    } catch (const json::exception& e) { // Handle JSON parsing errors.
+        cerr << "JSON Error processing forecast: " << e.what() << endl;
+        return nullptr;
+    } catch (const exception& e) { // Handle other processing errors.
+        cerr << "Error processing forecast data: " << e.what() << endl;
         return nullptr;
     }
 
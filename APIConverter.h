@@ -3,26 +3,84 @@
 #define APICONVERTER_H
 
 #include <string>
-#include <memory> // For std::unique_ptr
+#include <memory> // For std::unique_ptr, std::shared_ptr
+#include <atomic> // For the response cache lifetime
+#include <chrono> // For response ages
+#include <mutex>  // For guarding the client pool
+#include <vector> // For the idle client pool and batch results
+#include "RetryPolicy.h" // Retry/backoff settings (held by value)
+#include "RateLimiter.h" // Shared rate limiter
+#include "WeatherQuery.h" // Per-call request parameters
+#include "BudgetCache.h" // Memory-budgeted last-good-response store
+#include "LocationResolver.h" // Query normalization and nearby-site reuse
 
 // Forward declarations to minimize header dependencies
 #include "ForecastReport.h" // Needed for DetailLevel enum definition
 namespace httplib { class Client; } // Forward declare external library class
 class CurrentWeatherReport;
+class CircuitBreaker;
+class TaskScheduler;
 // class ForecastReport; // Already included for DetailLevel
 
 // Handles interaction with the weather API, fetching data and converting it
 // into report objects (CurrentWeatherReport, ForecastReport).
+// Request parameters arrive per call as a WeatherQuery, so once configured a single
+// converter can be shared by several threads (configuration setters are not thread-safe
+// and should be called before sharing).
 class APIConverter {
 private:
-    // Manages the HTTP client connection using a smart pointer.
-    std::unique_ptr<httplib::Client> client;
-    // API key for authentication.
-    std::string apiKey;
-    // Target location for weather data (e.g., "City", "lat,lon").
-    std::string location;
-    // Units for retrieved data ("Metric" or "Imperial").
-    std::string units;
+    // Base URL every client connects to.
+    std::string baseUrl;
+    // Idle HTTP clients. httplib::Client serializes requests on one instance, so each
+    // in-flight request borrows its own client; they are created on demand and reused.
+    std::vector<std::unique_ptr<httplib::Client>> idleClients;
+    std::mutex clientsMutex; // Guards idleClients.
+
+    // Retry/backoff settings for idempotent GET requests.
+    RetryPolicy retryPolicy;
+    // Health state shared by every converter talking to the same host.
+    std::shared_ptr<CircuitBreaker> breaker;
+    // A successful response body and when it arrived.
+    struct CachedResponse {
+        std::string body;
+        std::chrono::steady_clock::time_point fetchedAt;
+    };
+    // Last successful response per request path: reused while younger than the cache TTL, and
+    // served when upstream is unavailable. Held within a memory budget ("responses" in metrics).
+    BudgetCache<CachedResponse> lastGoodResponses;
+    // How long a response is reused without a new API call, in seconds (0 = always fetch).
+    std::atomic<long long> cacheTtlSeconds;
+    // Token bucket and quota shared with other request paths (nullptr = unlimited).
+    std::shared_ptr<RateLimiter> rateLimiter;
+    // Optional CPU pool used to build large forecasts in parallel (nullptr = sequential).
+    std::shared_ptr<TaskScheduler> taskScheduler;
+    // Maps typed locations to the location requested, and learns sites from responses
+    // (nullptr = locations are sent as typed).
+    std::shared_ptr<LocationResolver> locationResolver;
+
+    // Takes an idle client from the pool, or creates a configured one.
+    std::unique_ptr<httplib::Client> acquireClient();
+    // Returns a client to the pool for reuse.
+    void releaseClient(std::unique_ptr<httplib::Client> client);
+    // Returns the location to request for 'location' (unchanged without a resolver).
+    std::string upstreamLocation(const std::string& location) const;
+    // Tells the resolver that requesting 'upstream' returned 'location'.
+    void learnLocation(const std::string& upstream, const LocationInfo& location) const;
+    // Builds the forecast request path for 'query', requesting 'location'.
+    static std::string forecastPath(const WeatherQuery& query, const std::string& location, int days);
+    // Returns false (and prints why) if a forecast request for 'query' cannot be made.
+    static bool validateForecastRequest(const WeatherQuery& query, int days);
+
+    // Performs one GET request for 'path' and records fetch latency, bytes and errors.
+    // Returns true and fills 'body' on HTTP 200. Otherwise returns false and sets 'status'
+    // (-1 for network errors), 'retryAfter' (header value, if any) and 'errorDetail'.
+    bool fetchOnce(const std::string& path, std::string& body, int& status,
+                   std::string& retryAfter, std::string& errorDetail);
+    // Performs a GET request with rate limiting, retries, backoff and circuit breaking, falling
+    // back to the last good response when upstream is unavailable. Responses younger than the
+    // cache TTL are served without a request.
+    // Returns true and fills 'body' on success; otherwise returns false and fills 'errorDetail'.
+    bool fetch(const std::string& path, RequestPriority priority, std::string& body, std::string& errorDetail);
 
 public:
     // Constructor: Initializes the HTTP client with the base API URL.
@@ -36,22 +94,55 @@ public:
 
     // --- Configuration Methods ---
 
-    // Sets the API key required for requests.
-    void setApiKey(const std::string& key);
-    // Sets the location for which to fetch weather data.
-    void setLocation(const std::string& loc);
-    // Sets the desired units ("Metric" or "Imperial"). Returns false if invalid.
-    bool setUnits(const std::string& unit);
+    // Replaces the retry/backoff policy applied to every request.
+    void setRetryPolicy(const RetryPolicy& policy);
+    // Sets the rate limiter/quota manager consulted before every API call (nullptr = none).
+    void setRateLimiter(std::shared_ptr<RateLimiter> limiter);
+    // Sets the scheduler used to build large multi-day forecasts in parallel (nullptr = none).
+    void setTaskScheduler(std::shared_ptr<TaskScheduler> scheduler);
+    // Sets how long a successful response is reused for identical requests (0 = off).
+    // Safe to change while requests are in flight (e.g., on a settings reload).
+    void setCacheTtl(std::chrono::seconds ttl);
+    // Sets the memory budget of the response store (0 = unlimited) and what it evicts first.
+    // Safe to change while requests are in flight.
+    void setCacheLimits(std::size_t budgetBytes, EvictionPolicy policy);
+    // Sets the resolver that normalizes locations before requests (nullptr = none). Nearby
+    // and same-place queries then share one request, and so one cached response.
+    void setLocationResolver(std::shared_ptr<LocationResolver> resolver);
 
     // --- API Interaction Methods ---
 
-    // Fetches current weather data from the API.
-    // Returns a unique_ptr to a CurrentWeatherReport, or nullptr on failure.
-    std::unique_ptr<CurrentWeatherReport> getCurrentWeather();
+    // Fetches current weather data for 'query' from the API.
+    // Returns a unique_ptr to a CurrentWeatherReport, or nullptr on failure. If 'responseBody'
+    // is set, it receives the response the report was built from (e.g., to cache it on disk).
+    std::unique_ptr<CurrentWeatherReport> getCurrentWeather(const WeatherQuery& query, std::string* responseBody = nullptr);
+
+    // Fetches forecast data (daily/hourly) for 'query' from the API for a specified number of days.
+    // Returns a unique_ptr to a ForecastReport, or nullptr on failure. 'responseBody' as above.
+    std::unique_ptr<ForecastReport> getForecastReport(const WeatherQuery& query, int days, ForecastReport::DetailLevel detail,
+                                                      std::string* responseBody = nullptr);
+
+    // Fetches forecasts for several queries at once: requests run on the scheduler's I/O pool
+    // and each response is parsed on its CPU pool as soon as it arrives.
+    // Returns one entry per query, in the same order (nullptr where that query failed).
+    std::vector<std::unique_ptr<ForecastReport>> getForecastReports(const std::vector<WeatherQuery>& queries, int days,
+                                                                    ForecastReport::DetailLevel detail,
+                                                                    TaskScheduler& scheduler);
+
+    // --- Parsing ---
+
+    // Converts a current.json response body into a report (no network access). Returns
+    // nullptr and prints an error if the body is invalid. 'location', if set, receives the
+    // response's location block.
+    static std::unique_ptr<CurrentWeatherReport> parseCurrentWeather(const std::string& body, const WeatherQuery& query,
+                                                                     LocationInfo* location = nullptr);
 
-    // Fetches forecast data (daily/hourly) from the API for a specified number of days.
-    // Returns a unique_ptr to a ForecastReport, or nullptr on failure.
-    std::unique_ptr<ForecastReport> getForecastReport(int days, ForecastReport::DetailLevel detail);
+    // Converts a forecast.json response body into a report (no network access, safe to call
+    // from several threads). Returns nullptr and prints an error if the body is invalid.
+    // With a scheduler, large multi-day responses build their days in parallel on its CPU pool.
+    static std::unique_ptr<ForecastReport> parseForecastReport(const std::string& body, const WeatherQuery& query,
+                                                               ForecastReport::DetailLevel detail,
+                                                               TaskScheduler* scheduler = nullptr);
 };
 
 #endif // APICONVERTER_H
\ No newline at end of file
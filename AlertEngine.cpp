@@ -0,0 +1,417 @@
+// AlertEngine.cpp
+#include "AlertEngine.h"
+#include "Forecast.h"      // Forecast, DailyForecast, HourlyForecast
+#include "ForecastMerge.h" // ForecastChangeSet
+#include "TimeFormat.h"    // Location-local dates and times for events
+#include "Property.h"      // Property values and units
+#include "Metrics.h"       // Alert event counter
+
+#include <iostream>    // For error output (cerr)
+#include <sstream>     // For tokenizing rule lines and formatting events
+#include <iomanip>     // For std::setprecision
+#include <algorithm>   // For std::min, std::max
+#include <cctype>      // For std::tolower
+#include <cmath>       // For std::isnan
+#include <cstdlib>     // For std::strtod
+#include <ctime>       // For std::time (file sink timestamps)
+#include <limits>      // For quiet_NaN
+#include <utility>     // For std::move
+
+// --- Internal Helper Functions (Anonymous Namespace) ---
+namespace {
+    const long long SECONDS_PER_HOUR = 3600;
+    const long long SECONDS_PER_DAY = 86400;
+    const int MAX_WINDOW_HOURS = 14 * 24; // Longest forecast the API returns.
+
+    // Rule property names (lower case) and the properties they refer to.
+    struct PropertyName {
+        const char* name;
+        PropertyIndex index;
+    };
+    const PropertyName PROPERTY_NAMES[] = {
+        {"temp", TEMPERATURE}, {"temperature", TEMPERATURE}, {"feelslike", FEELS_LIKE},
+        {"wind", WIND_SPEED}, {"winddir", WIND_DIRECTION}, {"humidity", HUMIDITY},
+        {"pressure", PRESSURE}, {"visibility", VISIBILITY}, {"uv", UV},
+        {"gust", GUST_SPEED}, {"gusts", GUST_SPEED}, {"precip", PRECIPITATION},
+        {"cloud", CLOUD}, {"dewpoint", DEW_POINT}, {"heatindex", HEAT_INDEX},
+        {"windchill", WIND_CHILL}, {"apparent", APPARENT_TEMP}, {"precipchance", PRECIP_PROBABILITY},
+    };
+
+    std::string toLower(std::string s) {
+        for (char& c : s) { c = static_cast<char>(std::tolower(static_cast<unsigned char>(c))); }
+        return s;
+    }
+
+    std::string trim(const std::string& s) {
+        size_t first = s.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) { return ""; }
+        size_t last = s.find_last_not_of(" \t\r\n");
+        return s.substr(first, last - first + 1);
+    }
+
+    const char* comparisonSymbol(AlertComparison comparison) {
+        switch (comparison) {
+            case AlertComparison::GREATER: return ">";
+            case AlertComparison::GREATER_EQUAL: return ">=";
+            case AlertComparison::LESS: return "<";
+            default: return "<=";
+        }
+    }
+
+    // True if the rule looks for high values (so the window maximum decides).
+    bool testsMaximum(AlertComparison comparison) {
+        return comparison == AlertComparison::GREATER || comparison == AlertComparison::GREATER_EQUAL;
+    }
+
+    bool compare(double value, AlertComparison comparison, double threshold) {
+        switch (comparison) {
+            case AlertComparison::GREATER: return value > threshold;
+            case AlertComparison::GREATER_EQUAL: return value >= threshold;
+            case AlertComparison::LESS: return value < threshold;
+            default: return value <= threshold;
+        }
+    }
+
+    // Parses a whole token as a number.
+    bool parseNumber(const std::string& token, double& value) {
+        if (token.empty()) { return false; }
+        char* end = nullptr;
+        value = std::strtod(token.c_str(), &end);
+        return end == token.c_str() + token.size();
+    }
+} // end anonymous namespace
+
+// --- Sinks ---
+
+std::string StreamAlertSink::formatEvent(const AlertEvent& event) {
+    std::ostringstream line;
+    line << (event.triggered ? "[ALERT] " : "[CLEAR] ") << event.rule << " @ " << event.location << ": ";
+    if (std::isnan(event.value)) {
+        line << "no data";
+    } else {
+        line << std::fixed << std::setprecision(1) << event.value;
+        if (!event.unit.empty()) { line << " " << event.unit; }
+        if (!event.when.empty()) { line << " at " << event.when; }
+        line.unsetf(std::ios::floatfield); // Thresholds as written in the rule.
+        line << std::setprecision(6);
+    }
+    line << " (" << (event.triggered ? "" : "no longer ") << comparisonSymbol(event.comparison) << " "
+         << event.threshold << ")";
+    return line.str();
+}
+
+void StreamAlertSink::emit(const AlertEvent& event) {
+    std::string line = StreamAlertSink::formatEvent(event);
+    std::lock_guard<std::mutex> lock(mutex);
+    os << line << "\n";
+    os.flush();
+}
+
+FileAlertSink::FileAlertSink(const std::string& path) : out(path, std::ios::app) {
+    if (!out.is_open()) {
+        std::cerr << "Warning: Could not open alert log '" << path << "' for writing." << std::endl;
+    }
+}
+
+void FileAlertSink::emit(const AlertEvent& event) {
+    // Prefix each line with the UTC time it was written.
+    std::string line = TimeFormat::formatDateTime(static_cast<long long>(std::time(nullptr)), 0) + "Z "
+                     + StreamAlertSink::formatEvent(event);
+    std::lock_guard<std::mutex> lock(mutex);
+    out << line << "\n";
+    out.flush();
+}
+
+void RecentAlertSink::emit(const AlertEvent& event) {
+    std::string line = StreamAlertSink::formatEvent(event);
+    std::lock_guard<std::mutex> lock(mutex);
+    lines.push_back(std::move(line));
+    while (lines.size() > capacity) { lines.pop_front(); }
+}
+
+std::vector<std::string> RecentAlertSink::getLines() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::vector<std::string>(lines.begin(), lines.end());
+}
+
+void RecentAlertSink::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    lines.clear();
+}
+
+// --- Rules ---
+
+bool AlertEngine::parseRule(const std::string& line, AlertRule& rule, std::string& error) {
+    size_t colon = line.find(':');
+    if (colon == std::string::npos) { error = "expected '<name>: <condition>'"; return false; }
+    rule.name = trim(line.substr(0, colon));
+    if (rule.name.empty()) { error = "missing rule name"; return false; }
+
+    std::istringstream tokens(line.substr(colon + 1));
+    std::string propertyName, op, valueText;
+    if (!(tokens >> propertyName >> op >> valueText)) { error = "expected '<property> <op> <value>'"; return false; }
+
+    propertyName = toLower(propertyName);
+    bool known = false;
+    for (const auto& entry : PROPERTY_NAMES) {
+        if (propertyName == entry.name) { rule.property = entry.index; known = true; break; }
+    }
+    if (!known) { error = "unknown property '" + propertyName + "'"; return false; }
+
+    if (op == ">") { rule.comparison = AlertComparison::GREATER; }
+    else if (op == ">=") { rule.comparison = AlertComparison::GREATER_EQUAL; }
+    else if (op == "<") { rule.comparison = AlertComparison::LESS; }
+    else if (op == "<=") { rule.comparison = AlertComparison::LESS_EQUAL; }
+    else { error = "unknown operator '" + op + "' (use >, >=, < or <=)"; return false; }
+
+    if (!parseNumber(valueText, rule.threshold)) { error = "invalid value '" + valueText + "'"; return false; }
+
+    // Scope: "next <N>h" (also "next <N> h"/"next <N> hours"), "today" or "tomorrow".
+    rule.scope = AlertScope::NEXT_HOURS;
+    rule.hours = 24;
+    std::string scope;
+    if (tokens >> scope) {
+        scope = toLower(scope);
+        if (scope == "today") {
+            rule.scope = AlertScope::TODAY;
+        } else if (scope == "tomorrow") {
+            rule.scope = AlertScope::TOMORROW;
+        } else if (scope == "next") {
+            std::string count;
+            if (!(tokens >> count)) { error = "expected an hour count after 'next'"; return false; }
+            count = toLower(count);
+            if (!count.empty() && count.back() == 'h') {
+                count.pop_back();
+            } else {
+                std::string unit;
+                if (tokens >> unit && toLower(unit) != "h" && toLower(unit) != "hours") {
+                    error = "expected hours after 'next " + count + "'";
+                    return false;
+                }
+            }
+            double hours = 0.0;
+            if (!parseNumber(count, hours) || hours < 1 || hours > MAX_WINDOW_HOURS || hours != static_cast<int>(hours)) {
+                error = "invalid hour count '" + count + "' (1-" + std::to_string(MAX_WINDOW_HOURS) + ")";
+                return false;
+            }
+            rule.hours = static_cast<int>(hours);
+        } else {
+            error = "unknown scope '" + scope + "' (use 'next <N>h', 'today' or 'tomorrow')";
+            return false;
+        }
+    }
+    std::string extra;
+    if (tokens >> extra) { error = "unexpected '" + extra + "'"; return false; }
+    return true;
+}
+
+bool AlertEngine::loadRules(const std::string& path) {
+    std::ifstream infile(path);
+    if (!infile.is_open()) {
+        return false;
+    }
+    rules.clear();
+    for (auto& group : hourlyRules) { group.clear(); }
+    for (auto& group : dailyRules) { group.clear(); }
+    fields = FieldMask();
+    maxHours = 0;
+    {
+        std::lock_guard<std::mutex> lock(statesMutex);
+        states.clear(); // Rule indices change.
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(infile, line)) {
+        ++lineNumber;
+        std::string text = trim(line);
+        if (text.empty() || text[0] == '#') { continue; }
+        AlertRule rule;
+        std::string error;
+        if (parseRule(text, rule, error)) {
+            addRule(rule);
+        } else {
+            std::cerr << "Warning: Skipping alert rule on line " << lineNumber << " of '" << path << "': " << error << std::endl;
+        }
+    }
+    return true;
+}
+
+void AlertEngine::addRule(const AlertRule& rule) {
+    size_t index = rules.size();
+    rules.push_back(rule);
+    if (rule.scope == AlertScope::NEXT_HOURS) {
+        hourlyRules[rule.property].push_back(index);
+        maxHours = std::max(maxHours, rule.hours);
+    } else {
+        dailyRules[rule.property].push_back(index);
+    }
+    fields = fields.with(rule.property);
+}
+
+// --- Evaluation ---
+
+std::vector<char>& AlertEngine::stateFor(const std::string& location) {
+    std::lock_guard<std::mutex> lock(statesMutex);
+    std::vector<char>& state = states[location]; // std::map references stay valid on insert.
+    state.resize(rules.size(), 0);
+    return state;
+}
+
+std::size_t AlertEngine::evaluate(const std::string& location, const Forecast& forecast, long long nowEpoch,
+                                  AlertSink& sink) {
+    return evaluateFields(location, forecast, nowEpoch, FieldMask::all(), sink);
+}
+
+std::size_t AlertEngine::evaluateChanges(const std::string& location, const Forecast& forecast,
+                                         const ForecastChangeSet& changes, long long nowEpoch, AlertSink& sink) {
+    if (!changes.addedHours.empty() || !changes.addedDays.empty() || !changes.droppedDays.empty()) {
+        return evaluate(location, forecast, nowEpoch, sink);
+    }
+    FieldMask touched;
+    for (const auto& change : changes.changes) { touched = touched.with(change.index); }
+    if (!touched.hasAny(fields)) { return 0; }
+    return evaluateFields(location, forecast, nowEpoch, touched, sink);
+}
+
+std::size_t AlertEngine::evaluateFields(const std::string& location, const Forecast& forecast, long long nowEpoch,
+                                        FieldMask only, AlertSink& sink) {
+    if (rules.empty() || !only.hasAny(fields)) { return 0; }
+    std::vector<char>& state = stateFor(location);
+    const int offset = forecast.getLocation().utcOffsetSeconds;
+    const double noValue = std::numeric_limits<double>::quiet_NaN();
+    std::size_t emitted = 0;
+
+    // Emits an event if rule 'r' changed state.
+    auto update = [&](size_t r, bool matches, double value, const Property* prop, const std::string& when) {
+        if (static_cast<bool>(state[r]) == matches) { return; }
+        state[r] = matches ? 1 : 0;
+        const AlertRule& rule = rules[r];
+        AlertEvent event{location, rule.name, matches, rule.property, rule.comparison, rule.threshold, value,
+                         prop != nullptr ? prop->getUnit() : std::string(), when};
+        sink.emit(event);
+        Metrics::increment(MetricCounter::ALERTS_EMITTED);
+        ++emitted;
+    };
+
+    // --- Hourly rules ---
+    // Upcoming hours (the current one included), up to the longest window. The column
+    // buffers are per thread and reused, so steady-state evaluation does not allocate.
+    thread_local std::vector<const HourlyForecast*> upcoming;
+    thread_local std::vector<double> values;
+    thread_local std::vector<const Property*> props;
+    thread_local std::vector<int> maxAt, minAt; // Running extremes: cell within the first k+1 hours.
+    upcoming.clear();
+    if (maxHours > 0) {
+        for (const auto& day : forecast.getDailyForecasts()) {
+            for (const auto& hour : day.getHourlyForecasts()) {
+                if (hour.getEpoch() + SECONDS_PER_HOUR <= nowEpoch) { continue; } // Already over.
+                if (upcoming.size() < static_cast<size_t>(maxHours)) { upcoming.push_back(&hour); }
+            }
+        }
+    }
+    const size_t count = upcoming.size();
+
+    // Properties with hourly rules to evaluate this time.
+    PropertyIndex active[NUM_PROPERTIES];
+    size_t activeCount = 0;
+    for (int p = 0; p < NUM_PROPERTIES; ++p) {
+        const PropertyIndex index = static_cast<PropertyIndex>(p);
+        if (!hourlyRules[p].empty() && only.has(index)) { active[activeCount++] = index; }
+    }
+
+    // Gather hour by hour (each hour's properties sit together), one row per hour.
+    props.resize(count * activeCount);
+    values.resize(count * activeCount);
+    for (size_t k = 0; k < count; ++k) {
+        const Weather& weather = upcoming[k]->getWeather();
+        for (size_t a = 0; a < activeCount; ++a) {
+            const Property* prop = weather.getProperty(active[a]);
+            props[k * activeCount + a] = prop;
+            values[k * activeCount + a] = (prop != nullptr) ? prop->getValue() : noValue;
+        }
+    }
+
+    maxAt.resize(count);
+    minAt.resize(count);
+    for (size_t a = 0; a < activeCount; ++a) {
+        const PropertyIndex index = active[a];
+
+        // One pass down the column: running maximum/minimum positions.
+        int highest = -1, lowest = -1;
+        for (size_t k = 0; k < count; ++k) {
+            const size_t cell = k * activeCount + a;
+            if (props[cell] != nullptr) {
+                if (highest < 0 || values[cell] > values[highest]) { highest = static_cast<int>(cell); }
+                if (lowest < 0 || values[cell] < values[lowest]) { lowest = static_cast<int>(cell); }
+            }
+            maxAt[k] = highest;
+            minAt[k] = lowest;
+        }
+
+        // Each rule is then a lookup at the end of its window.
+        for (size_t r : hourlyRules[index]) {
+            const AlertRule& rule = rules[r];
+            size_t window = std::min(static_cast<size_t>(rule.hours), count);
+            int at = (window == 0) ? -1 : (testsMaximum(rule.comparison) ? maxAt[window - 1] : minAt[window - 1]);
+            if (at < 0) {
+                update(r, false, noValue, nullptr, "");
+                continue;
+            }
+            bool matches = compare(values[at], rule.comparison, rule.threshold);
+            if (static_cast<bool>(state[r]) != matches) {
+                update(r, matches, values[at], props[at],
+                       TimeFormat::formatDateTime(upcoming[at / activeCount]->getEpoch(), offset).substr(0, 16));
+            }
+        }
+    }
+
+    // --- Daily rules ---
+    const DailyForecast* today = nullptr;
+    const DailyForecast* tomorrow = nullptr;
+    const std::string todayDate = TimeFormat::formatDateTime(nowEpoch, offset).substr(0, 10);
+    const std::string tomorrowDate = TimeFormat::formatDateTime(nowEpoch + SECONDS_PER_DAY, offset).substr(0, 10);
+    for (const auto& day : forecast.getDailyForecasts()) {
+        if (day.getDate() == todayDate) { today = &day; }
+        if (day.getDate() == tomorrowDate) { tomorrow = &day; }
+    }
+    for (int p = 0; p < NUM_PROPERTIES; ++p) {
+        const PropertyIndex index = static_cast<PropertyIndex>(p);
+        if (dailyRules[p].empty() || !only.has(index)) { continue; }
+        for (size_t r : dailyRules[p]) {
+            const AlertRule& rule = rules[r];
+            const DailyForecast* day = (rule.scope == AlertScope::TODAY) ? today : tomorrow;
+            if (day == nullptr) {
+                update(r, false, noValue, nullptr, "");
+                continue;
+            }
+            // The day's highest (or lowest) hourly value, as for hourly rules. Precipitation is
+            // the day's total, and a day without hourly values falls back to its summary.
+            const Property* prop = nullptr;
+            const HourlyForecast* at = nullptr;
+            if (index != PRECIPITATION) {
+                const bool maximum = testsMaximum(rule.comparison);
+                for (const auto& hour : day->getHourlyForecasts()) {
+                    const Property* candidate = hour.getWeather().getProperty(index);
+                    if (candidate == nullptr) { continue; }
+                    if (prop == nullptr || (maximum ? candidate->getValue() > prop->getValue()
+                                                    : candidate->getValue() < prop->getValue())) {
+                        prop = candidate;
+                        at = &hour;
+                    }
+                }
+            }
+            if (prop == nullptr) { prop = day->getDayWeather().getProperty(index); }
+            if (prop == nullptr) {
+                update(r, false, noValue, nullptr, "");
+                continue;
+            }
+            bool matches = compare(prop->getValue(), rule.comparison, rule.threshold);
+            if (static_cast<bool>(state[r]) != matches) {
+                update(r, matches, prop->getValue(), prop,
+                       at != nullptr ? TimeFormat::formatDateTime(at->getEpoch(), offset).substr(0, 16) : day->getDate());
+            }
+        }
+    }
+    return emitted;
+}
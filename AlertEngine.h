@@ -0,0 +1,160 @@
+// AlertEngine.h
+#ifndef ALERTENGINE_H
+#define ALERTENGINE_H
+
+#include "Weather.h"       // PropertyIndex, FieldMask
+#include <cstddef>         // For size_t
+#include <deque>           // For RecentAlertSink
+#include <fstream>         // For FileAlertSink
+#include <map>             // For per-location alert state
+#include <mutex>           // For guarding state and sinks
+#include <ostream>         // For StreamAlertSink
+#include <string>          // For rule names and text
+#include <vector>          // For rule lists
+
+class Forecast;
+struct ForecastChangeSet;
+
+// How a rule compares a value with its threshold.
+enum class AlertComparison { GREATER, GREATER_EQUAL, LESS, LESS_EQUAL };
+
+// Which part of a forecast a rule looks at.
+enum class AlertScope {
+    NEXT_HOURS, // Hourly values in the next 'hours' hours (starting with the current hour).
+    TODAY,      // Today's hourly values (in the location's time zone); precipitation: the day's total.
+    TOMORROW    // Tomorrow's hourly values; precipitation: the day's total.
+};
+
+// One user-defined condition, e.g. "gusts: gust > 60 next 12h".
+// Thresholds are in the forecast's display units (the configured unit system).
+struct AlertRule {
+    std::string name;           // Label shown in alert events.
+    PropertyIndex property;     // Value tested.
+    AlertComparison comparison; // How it is tested.
+    double threshold;           // What it is tested against.
+    AlertScope scope;           // Where in the forecast it is tested.
+    int hours;                  // Window length for NEXT_HOURS.
+};
+
+// A rule starting or stopping to match for a location.
+struct AlertEvent {
+    std::string location; // Location label passed to evaluate().
+    std::string rule;     // Rule name.
+    bool triggered;       // true when the rule started matching, false when it cleared.
+    PropertyIndex property;
+    AlertComparison comparison;
+    double threshold;
+    double value;         // The extreme value in the rule's scope (NaN if none).
+    std::string unit;     // Unit of 'value' (empty if unknown).
+    std::string when;     // Where the value occurs: local "YYYY-MM-DD HH:MM" or a date.
+};
+
+// Receives alert events. Implementations must be safe to call from several threads.
+class AlertSink {
+  public:
+  virtual ~AlertSink() = default;
+  virtual void emit(const AlertEvent& event) = 0;
+};
+
+// Writes one line per event to a stream (e.g., std::cout).
+class StreamAlertSink : public AlertSink {
+  public:
+  explicit StreamAlertSink(std::ostream& stream) : os(stream) {}
+  void emit(const AlertEvent& event) override;
+  // Formats an event as a single line (without newline).
+  static std::string formatEvent(const AlertEvent& event);
+
+  private:
+  std::ostream& os;
+  std::mutex mutex; // Keeps lines from different threads apart.
+};
+
+// Appends one line per event to a file.
+class FileAlertSink : public AlertSink {
+  public:
+  explicit FileAlertSink(const std::string& path);
+  // Returns true if the file could be opened for appending.
+  bool isOpen() const { return out.is_open(); }
+  void emit(const AlertEvent& event) override;
+
+  private:
+  std::ofstream out;
+  std::mutex mutex;
+};
+
+// Keeps the last few events as formatted lines, for screens that are redrawn in full (where
+// printed lines would be overwritten at once).
+class RecentAlertSink : public AlertSink {
+  public:
+  explicit RecentAlertSink(std::size_t maxLines = 5) : capacity(maxLines) {}
+  void emit(const AlertEvent& event) override;
+  // Returns the kept lines, oldest first.
+  std::vector<std::string> getLines() const;
+  void clear();
+
+  private:
+  std::size_t capacity;
+  std::deque<std::string> lines;
+  mutable std::mutex mutex;
+};
+
+// Evaluates threshold rules against forecasts and emits an event whenever a rule starts or
+// stops matching for a location.
+// Rules are compiled into per-property groups; evaluating a forecast makes one pass over its
+// upcoming hours to build running maxima/minima for the properties in use, after which every
+// hourly rule is a single lookup and comparison (independent of its window length).
+class AlertEngine {
+  public:
+  AlertEngine() = default;
+
+  // --- Rules ---
+
+  // Parses one rule line: "<name>: <property> <op> <value> [next <N>h | today | tomorrow]".
+  // Properties: temp, feelslike, wind, winddir, humidity, pressure, visibility, uv, gust,
+  // precip, cloud, dewpoint, heatindex, windchill, apparent, precipchance.
+  // Operators: > >= < <=. The scope defaults to "next 24h".
+  // Returns false and sets 'error' if the line is invalid.
+  static bool parseRule(const std::string& line, AlertRule& rule, std::string& error);
+
+  // Loads rules from a file (one per line; blank lines and lines starting with '#' are
+  // skipped), replacing the current rules. Invalid lines are reported and skipped.
+  // Returns false if the file could not be opened.
+  bool loadRules(const std::string& path);
+  // Adds a rule. Not thread-safe with evaluation: set up rules before evaluating.
+  void addRule(const AlertRule& rule);
+  // Returns the current rules.
+  const std::vector<AlertRule>& getRules() const { return rules; }
+  // Returns the properties referenced by any rule (e.g., as a field projection for fetching).
+  FieldMask getFields() const { return fields; }
+
+  // --- Evaluation ---
+
+  // Evaluates every rule against 'forecast' for 'location' at time 'nowEpoch' (Unix time)
+  // and emits events for rules whose state changed. Returns the number of events emitted.
+  // Different locations may be evaluated concurrently.
+  std::size_t evaluate(const std::string& location, const Forecast& forecast, long long nowEpoch, AlertSink& sink);
+  // Like evaluate(), but only re-evaluates rules on properties touched by 'changes' (as
+  // returned by ForecastMerge::merge); all rules if hours or days were added or dropped.
+  std::size_t evaluateChanges(const std::string& location, const Forecast& forecast,
+                              const ForecastChangeSet& changes, long long nowEpoch, AlertSink& sink);
+
+  private:
+  std::vector<AlertRule> rules;
+  // Compiled form: rule indices grouped by property, for hourly and daily scopes.
+  std::vector<std::size_t> hourlyRules[NUM_PROPERTIES];
+  std::vector<std::size_t> dailyRules[NUM_PROPERTIES];
+  FieldMask fields;  // Properties used by any rule.
+  int maxHours = 0;  // Longest NEXT_HOURS window.
+
+  // Whether each rule matched at the last evaluation, per location.
+  std::map<std::string, std::vector<char>> states;
+  std::mutex statesMutex; // Guards the map itself (each location's vector is touched by one caller).
+
+  // Evaluates the rules on properties in 'only'.
+  std::size_t evaluateFields(const std::string& location, const Forecast& forecast, long long nowEpoch,
+                             FieldMask only, AlertSink& sink);
+  // Returns the state vector for 'location', creating it if needed.
+  std::vector<char>& stateFor(const std::string& location);
+};
+
+#endif // ALERTENGINE_H
@@ -0,0 +1,129 @@
+// AtomicFileWriter.cpp
+#include "AtomicFileWriter.h"
+
+#include <cstdio>      // For std::rename, std::remove
+#include <cstring>     // For std::strerror
+#include <cerrno>      // For errno
+#include <iostream>    // For error output (cerr)
+#include <utility>     // For std::move
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>   // For MoveFileExA
+#include <io.h>        // For _commit, _fileno
+#else
+#include <fcntl.h>     // For open
+#include <unistd.h>    // For write, fsync, close
+#include <sys/stat.h>  // For stat (keeping permissions)
+#endif
+
+// --- Constructor / Destructor ---
+
+AtomicFileWriter::AtomicFileWriter() : writing(false), stopping(false) {}
+
+AtomicFileWriter::~AtomicFileWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    if (writer.joinable()) { writer.join(); } // run() drains 'pending' before returning.
+}
+
+// --- Queueing ---
+
+void AtomicFileWriter::submit(const std::string& path, std::string contents) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending[path] = std::move(contents); // Replaces an older write that has not started yet.
+        if (!writer.joinable()) { writer = std::thread(&AtomicFileWriter::run, this); }
+    }
+    wakeup.notify_one();
+}
+
+void AtomicFileWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return pending.empty() && !writing; });
+}
+
+void AtomicFileWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeup.wait(lock, [this] { return stopping || !pending.empty(); });
+        if (pending.empty()) { return; } // Stopping and drained.
+
+        auto next = pending.begin();
+        std::string path = next->first;
+        std::string contents = std::move(next->second);
+        pending.erase(next);
+        writing = true;
+
+        lock.unlock();
+        std::string error;
+        if (!writeFile(path, contents, error)) {
+            std::cerr << "Error: Could not save '" << path << "': " << error << std::endl;
+        }
+        lock.lock();
+
+        writing = false;
+        if (pending.empty()) { idle.notify_all(); }
+    }
+}
+
+// --- Atomic Replacement ---
+
+bool AtomicFileWriter::writeFile(const std::string& path, const std::string& contents, std::string& error) {
+    const std::string tempPath = path + ".tmp";
+#ifdef _WIN32
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (file == nullptr) { error = std::strerror(errno); return false; }
+    bool ok = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size()
+           && std::fflush(file) == 0 && _commit(_fileno(file)) == 0;
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) { error = "write failed"; std::remove(tempPath.c_str()); return false; }
+    if (!MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        error = "rename failed (error " + std::to_string(GetLastError()) + ")";
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+#else
+    // Keep the permissions of the file being replaced (new files get 0644 minus umask).
+    mode_t mode = 0644;
+    struct stat existing;
+    if (stat(path.c_str(), &existing) == 0) { mode = existing.st_mode & 07777; }
+
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, mode);
+    if (fd < 0) { error = std::strerror(errno); return false; }
+    size_t written = 0;
+    while (written < contents.size()) {
+        ssize_t n = write(fd, contents.data() + written, contents.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) { continue; }
+            error = std::strerror(errno);
+            close(fd);
+            std::remove(tempPath.c_str());
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    // Contents must be on disk before the rename makes them visible.
+    // Close even if the sync failed, so the descriptor never leaks.
+    int synced = fsync(fd);
+    int syncError = errno;
+    int closed = close(fd);
+    if (synced != 0 || closed != 0) {
+        error = std::strerror(synced != 0 ? syncError : errno);
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        error = std::strerror(errno);
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+#endif
+}
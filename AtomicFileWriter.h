@@ -0,0 +1,47 @@
+// AtomicFileWriter.h
+#ifndef ATOMICFILEWRITER_H
+#define ATOMICFILEWRITER_H
+
+#include <condition_variable> // For waking the writer thread
+#include <map>                // For pending writes by path
+#include <mutex>              // For guarding pending writes
+#include <string>             // For paths and contents
+#include <thread>             // For the writer thread
+
+// Replaces files atomically (write a temporary file, flush it to disk, rename it over the
+// target), so readers and crashes never see a half-written file.
+// submit() hands the work to a background thread, so callers (e.g., the UI) never block on
+// disk I/O. Writes to the same path are coalesced: only the latest contents are written.
+class AtomicFileWriter {
+  public:
+  // The writer thread starts on the first submit().
+  AtomicFileWriter();
+  // Finishes queued writes, then stops the writer thread.
+  ~AtomicFileWriter();
+
+  AtomicFileWriter(const AtomicFileWriter&) = delete;
+  AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+
+  // Queues 'contents' to replace the file at 'path'. Errors are reported on cerr.
+  void submit(const std::string& path, std::string contents);
+  // Blocks until every write queued so far has finished.
+  void flush();
+
+  // Writes 'contents' to "<path>.tmp", flushes it to disk and renames it over 'path' (keeping
+  // the old file's permissions). Returns false and sets 'error' on failure.
+  static bool writeFile(const std::string& path, const std::string& contents, std::string& error);
+
+  private:
+  std::map<std::string, std::string> pending; // Latest contents per path, not yet written.
+  bool writing;                               // A write is in progress on the writer thread.
+  bool stopping;
+  std::mutex mutex;
+  std::condition_variable wakeup;             // Signals the writer thread.
+  std::condition_variable idle;               // Signals flush() callers.
+  std::thread writer;
+
+  // Writer thread: writes pending files until stopped.
+  void run();
+};
+
+#endif // ATOMICFILEWRITER_H
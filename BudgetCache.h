@@ -0,0 +1,220 @@
+// BudgetCache.h
+#ifndef BUDGETCACHE_H
+#define BUDGETCACHE_H
+
+#include "Metrics.h"     // Occupancy and eviction gauges
+#include <chrono>        // For expiry times
+#include <cstddef>       // For size_t
+#include <cstdint>       // For use counts
+#include <list>          // For the recency order
+#include <memory>        // For the shared gauges
+#include <mutex>         // For guarding the entries
+#include <string>        // For keys
+#include <unordered_map> // For the entries (nodes never move, so the recency list can point at keys)
+#include <utility>       // For std::move
+
+// Which entry a BudgetCache drops when a new value does not fit its budget.
+enum class EvictionPolicy {
+    LRU,         // Least recently used.
+    LFU,         // Least frequently used (ties: least recently used).
+    TTL_WEIGHTED // Expired entries first (largest first), then the least remaining lifetime per byte.
+};
+
+// Parses a policy name as used in settings ("lru", "lfu" or "ttl"). Returns false if unknown.
+inline bool parseEvictionPolicy(const std::string& name, EvictionPolicy& policy) {
+    if (name == "lru") { policy = EvictionPolicy::LRU; return true; }
+    if (name == "lfu") { policy = EvictionPolicy::LFU; return true; }
+    if (name == "ttl") { policy = EvictionPolicy::TTL_WEIGHTED; return true; }
+    return false;
+}
+
+// Returns the heap bytes owned by 'text' (0 while it fits the small-string buffer).
+inline std::size_t stringHeapBytes(const std::string& text) {
+    static const std::size_t inlineCapacity = std::string().capacity();
+    return (text.capacity() > inlineCapacity) ? text.capacity() + 1 : 0;
+}
+
+// String-keyed cache holding at most 'budget' bytes. Callers say how many heap bytes each
+// value owns; the cache adds its own per-entry cost (node, key and recency link), so the
+// charged total tracks the memory the cache actually keeps alive. A put that does not fit
+// evicts entries by the configured policy until it does. Expiry times only weigh evictions
+// (TTL_WEIGHTED); get still returns expired values, so callers can serve stale data.
+// LFU and TTL_WEIGHTED scan the entries for a victim, which is fine for the few thousand
+// entries these caches hold. Occupancy is exported through Metrics. Safe to use from
+// several threads.
+template <typename V>
+class BudgetCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 'name' labels the cache in the metrics exports. 'budget' of 0 = unlimited.
+    explicit BudgetCache(const std::string& name, std::size_t budget = 0, EvictionPolicy policy = EvictionPolicy::LRU)
+        : budgetBytes(budget), evictionPolicy(policy), chargedBytes(0), gauges(std::make_shared<CacheGauges>()) {
+        gauges->budgetBytes.store(budget, std::memory_order_relaxed);
+        Metrics::registerCache(name, gauges);
+    }
+
+    // Disable copy operations (the gauges are registered once per cache).
+    BudgetCache(const BudgetCache&) = delete;
+    BudgetCache& operator=(const BudgetCache&) = delete;
+
+    // --- Configuration ---
+
+    // Changes the budget (0 = unlimited), evicting at once if the cache is now over it.
+    void setBudget(std::size_t budget) {
+        std::lock_guard<std::mutex> lock(mutex);
+        budgetBytes = budget;
+        gauges->budgetBytes.store(budget, std::memory_order_relaxed);
+        evictUntilFits(0, Clock::now());
+        publish();
+    }
+    void setPolicy(EvictionPolicy policy) {
+        std::lock_guard<std::mutex> lock(mutex);
+        evictionPolicy = policy;
+    }
+
+    // --- Access ---
+
+    // Stores 'value' under 'key', replacing any previous value. 'bytes' is the heap the value
+    // owns (not counting sizeof(V)); 'expiresAt' is when it stops being fresh. Returns false
+    // (and drops any previous value for 'key') if the value alone exceeds the budget.
+    bool put(const std::string& key, V value, std::size_t bytes, Clock::time_point expiresAt) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::uint64_t uses = 0;
+        auto found = entries.find(key);
+        if (found != entries.end()) {
+            uses = found->second.uses;
+            remove(found);
+        }
+        std::size_t charge = bytes + stringHeapBytes(key) + ENTRY_OVERHEAD;
+        if (budgetBytes > 0 && charge > budgetBytes) {
+            publish();
+            return false;
+        }
+        evictUntilFits(charge, Clock::now());
+
+        auto inserted = entries.emplace(key, Slot{std::move(value), charge, expiresAt, uses + 1, recency.end()}).first;
+        recency.push_front(&inserted->first);
+        inserted->second.position = recency.begin();
+        chargedBytes += charge;
+        publish();
+        return true;
+    }
+
+    // Copies the value for 'key' into 'out' and counts the use. Returns false if absent.
+    bool get(const std::string& key, V& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = entries.find(key);
+        if (found == entries.end()) { return false; }
+        Slot& slot = found->second;
+        ++slot.uses;
+        recency.splice(recency.begin(), recency, slot.position);
+        out = slot.value;
+        return true;
+    }
+
+    // Returns true if 'key' is cached (without counting a use).
+    bool contains(const std::string& key) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.count(key) != 0;
+    }
+
+    // Removes the value for 'key', if any.
+    void erase(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = entries.find(key);
+        if (found != entries.end()) { remove(found); }
+        publish();
+    }
+
+    // Removes every value (not counted as evictions).
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        recency.clear();
+        chargedBytes = 0;
+        publish();
+    }
+
+    // Bytes currently charged against the budget, and the number of values held.
+    std::size_t bytes() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return chargedBytes;
+    }
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+private:
+    struct Slot {
+        V value;
+        std::size_t charge;                          // Bytes charged for this entry.
+        Clock::time_point expiresAt;                 // End of freshness (TTL_WEIGHTED only).
+        std::uint64_t uses;                          // Puts and gets (LFU only).
+        std::list<const std::string*>::iterator position; // Place in 'recency'.
+    };
+    using Map = std::unordered_map<std::string, Slot>;
+
+    // Fixed cost of one entry: the hash node (key and slot, next pointer, cached hash), about
+    // one bucket, and the recency list node (two links and the key pointer).
+    static const std::size_t ENTRY_OVERHEAD = sizeof(typename Map::value_type) + 6 * sizeof(void*);
+
+    Map entries;
+    std::list<const std::string*> recency; // Keys, most recently used first.
+    std::size_t budgetBytes;
+    EvictionPolicy evictionPolicy;
+    std::size_t chargedBytes;
+    std::shared_ptr<CacheGauges> gauges;
+    mutable std::mutex mutex; // Guards everything above except 'gauges' (atomics).
+
+    void remove(typename Map::iterator found) {
+        chargedBytes -= found->second.charge;
+        recency.erase(found->second.position);
+        entries.erase(found);
+    }
+
+    // Picks the entry the policy drops next. 'entries' must not be empty.
+    typename Map::iterator victim(Clock::time_point now) {
+        if (evictionPolicy == EvictionPolicy::LRU) { return entries.find(*recency.back()); }
+
+        // Walk from least to most recently used, so ties go to the least recent entry.
+        typename Map::iterator best = entries.end();
+        for (auto key = recency.rbegin(); key != recency.rend(); ++key) {
+            auto candidate = entries.find(**key);
+            if (best == entries.end() || worse(candidate->second, best->second, now)) { best = candidate; }
+        }
+        return best;
+    }
+
+    // Returns true if 'a' should be evicted before 'b' under the (non-LRU) policy.
+    bool worse(const Slot& a, const Slot& b, Clock::time_point now) const {
+        if (evictionPolicy == EvictionPolicy::LFU) { return a.uses < b.uses; }
+        bool aExpired = a.expiresAt <= now, bExpired = b.expiresAt <= now;
+        if (aExpired != bExpired) { return aExpired; }
+        if (aExpired) { return a.charge > b.charge; }
+        // Seconds of freshness left per byte held: lowest is worth keeping least.
+        double aScore = std::chrono::duration<double>(a.expiresAt - now).count() / static_cast<double>(a.charge);
+        double bScore = std::chrono::duration<double>(b.expiresAt - now).count() / static_cast<double>(b.charge);
+        return aScore < bScore;
+    }
+
+    // Evicts until 'incoming' more bytes fit the budget.
+    void evictUntilFits(std::size_t incoming, Clock::time_point now) {
+        if (budgetBytes == 0) { return; }
+        while (!entries.empty() && chargedBytes + incoming > budgetBytes) {
+            auto found = victim(now);
+            gauges->evictions.fetch_add(1, std::memory_order_relaxed);
+            gauges->evictedBytes.fetch_add(found->second.charge, std::memory_order_relaxed);
+            remove(found);
+        }
+    }
+
+    // Copies the occupancy to the exported gauges.
+    void publish() {
+        gauges->entries.store(entries.size(), std::memory_order_relaxed);
+        gauges->bytes.store(chargedBytes, std::memory_order_relaxed);
+    }
+};
+
+#endif // BUDGETCACHE_H
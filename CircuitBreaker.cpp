@@ -0,0 +1,75 @@
+// CircuitBreaker.cpp
+#include "CircuitBreaker.h"
+
+#include <map> // For the per-host registry
+
+// --- Constructor ---
+
+CircuitBreaker::CircuitBreaker(int threshold, std::chrono::milliseconds cooldown)
+    : state(State::CLOSED), consecutiveFailures(0), probeInFlight(false),
+      failureThreshold(threshold > 0 ? threshold : 1), openDuration(cooldown) {}
+
+// --- State Transitions ---
+
+bool CircuitBreaker::allowRequest() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state == State::OPEN) {
+        if (std::chrono::steady_clock::now() - openedAt < openDuration) {
+            return false; // Still cooling down: fail fast.
+        }
+        state = State::HALF_OPEN; // Cool-down over: allow one probe.
+        probeInFlight = false;
+    }
+    if (state == State::HALF_OPEN) {
+        if (probeInFlight) { return false; }
+        probeInFlight = true;
+    }
+    return true;
+}
+
+void CircuitBreaker::recordSuccess() {
+    std::lock_guard<std::mutex> lock(mutex);
+    state = State::CLOSED;
+    consecutiveFailures = 0;
+    probeInFlight = false;
+}
+
+void CircuitBreaker::recordFailure() {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++consecutiveFailures;
+    if (state == State::HALF_OPEN || consecutiveFailures >= failureThreshold) {
+        state = State::OPEN;
+        openedAt = std::chrono::steady_clock::now();
+        probeInFlight = false;
+    }
+}
+
+void CircuitBreaker::cancelRequest() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state == State::HALF_OPEN) { probeInFlight = false; }
+}
+
+// --- Accessors ---
+
+CircuitBreaker::State CircuitBreaker::getState() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return state;
+}
+
+std::chrono::milliseconds CircuitBreaker::remainingOpenTime() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state != State::OPEN) { return std::chrono::milliseconds(0); }
+    auto remaining = openDuration - std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - openedAt);
+    return remaining.count() > 0 ? remaining : std::chrono::milliseconds(0);
+}
+
+// --- Per-Host Registry ---
+
+std::shared_ptr<CircuitBreaker> CircuitBreaker::forHost(const std::string& host) {
+    static std::mutex registryMutex;
+    static std::map<std::string, std::shared_ptr<CircuitBreaker>> breakers;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto& breaker = breakers[host];
+    if (!breaker) { breaker = std::make_shared<CircuitBreaker>(); }
+    return breaker;
+}
@@ -0,0 +1,55 @@
+// CircuitBreaker.h
+#ifndef CIRCUITBREAKER_H
+#define CIRCUITBREAKER_H
+
+#include <chrono> // For the open-state cool-down
+#include <memory> // For std::shared_ptr (per-host registry)
+#include <mutex>  // For thread-safe state transitions
+#include <string> // For host keys
+
+// Per-host circuit breaker protecting callers from a degraded upstream.
+// CLOSED: requests flow normally. After 'failureThreshold' consecutive failures it trips to
+// OPEN: requests fail fast (no network wait) for 'openDuration'. Then HALF_OPEN: a single
+// probe request is let through; success closes the breaker, failure re-opens it.
+class CircuitBreaker {
+  public:
+  enum class State { CLOSED, OPEN, HALF_OPEN };
+
+  private:
+  mutable std::mutex mutex;                          // Guards all state below.
+  State state;                                       // Current state.
+  int consecutiveFailures;                           // Failures since the last success.
+  bool probeInFlight;                                // True while a HALF_OPEN probe is outstanding.
+  std::chrono::steady_clock::time_point openedAt;    // When the breaker last tripped.
+  int failureThreshold;                              // Failures needed to trip.
+  std::chrono::milliseconds openDuration;            // How long to fail fast before probing.
+
+  public:
+  // Constructor: Starts CLOSED with the given trip threshold and cool-down.
+  explicit CircuitBreaker(int threshold = 5, std::chrono::milliseconds cooldown = std::chrono::seconds(30));
+
+  // Disable copy operations (holds a mutex and shared state).
+  CircuitBreaker(const CircuitBreaker&) = delete;
+  CircuitBreaker& operator=(const CircuitBreaker&) = delete;
+
+  // Returns true if a request may be sent now. In HALF_OPEN only one caller gets true.
+  bool allowRequest();
+  // Records a successful request (closes the breaker).
+  void recordSuccess();
+  // Records a failed request (may trip or re-open the breaker).
+  void recordFailure();
+  // Returns the slot of a request allowed by allowRequest() but never sent (e.g., shed by
+  // the rate limiter), so a HALF_OPEN breaker lets the next caller probe instead.
+  void cancelRequest();
+
+  // Returns the current state.
+  State getState() const;
+  // Returns how long until an OPEN breaker will allow a probe (zero if not OPEN).
+  std::chrono::milliseconds remainingOpenTime() const;
+
+  // Returns the shared breaker for 'host', creating it on first use, so every
+  // APIConverter talking to the same host sees the same health state.
+  static std::shared_ptr<CircuitBreaker> forHost(const std::string& host);
+};
+
+#endif // CIRCUITBREAKER_H
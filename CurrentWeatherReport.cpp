@@ -1,5 +1,6 @@
 // CurrentWeatherReport.cpp
 #include "CurrentWeatherReport.h"
+#include "Trace.h" // Optional span tracing of rendering
 #include <utility> // For std::move
 #include <ostream> // For std::ostream parameter in display
 
@@ -14,12 +15,13 @@ std::string CurrentWeatherReport::getReportType() const {
 
 // Displays the current weather report to the output stream.
 void CurrentWeatherReport::display(std::ostream& os) const {
+  TRACE_SCOPE("CurrentWeatherReport::display", "render");
   // Print a header for clarity.
-  os << "\n=== " << getReportType() << " ===" << std::endl;
+  os << "\n=== " << getReportType() << " ===\n";
   // Delegate the detailed data formatting to the Weather object's helper method.
   currentConditions.displayData(os);
   // Print a matching footer.
-  os << "============================" << std::endl;
+  os << "============================\n";
 }
 
 // Provides const access to the contained Weather data object.
@@ -0,0 +1,105 @@
+// DashboardReport.cpp
+#include "DashboardReport.h"
+#include "Trace.h"    // Optional span tracing of rendering
+#include <cmath>      // For std::isnan
+#include <cstdio>     // For std::snprintf
+#include <utility>    // For std::move
+
+// --- Helper Functions (Anonymous Namespace) ---
+namespace {
+    const int LOCATION_WIDTH = 22;
+
+    // Appends 'value' in a right-aligned column of 'width', or "--" if it is unavailable.
+    void appendValue(std::string& out, double value, int width, int precision, bool showSign = false) {
+        char cell[32];
+        if (std::isnan(value)) {
+            std::snprintf(cell, sizeof(cell), "%*s", width, "--");
+        } else {
+            std::snprintf(cell, sizeof(cell), showSign ? "%+*.*f" : "%*.*f", width, precision, value);
+        }
+        out += cell;
+    }
+
+    // Appends an age as "45s", "12m" or "3h".
+    void appendAge(std::string& out, long long seconds) {
+        char cell[32];
+        if (seconds < 60) {
+            std::snprintf(cell, sizeof(cell), "%lds", static_cast<long>(seconds));
+        } else if (seconds < 3600) {
+            std::snprintf(cell, sizeof(cell), "%ldm", static_cast<long>(seconds / 60));
+        } else {
+            std::snprintf(cell, sizeof(cell), "%ldh", static_cast<long>(seconds / 3600));
+        }
+        out += cell;
+    }
+
+    // Pads or truncates 'text' to 'width' columns.
+    void appendColumn(std::string& out, const std::string& text, int width) {
+        size_t length = text.size() < static_cast<size_t>(width) ? text.size() : static_cast<size_t>(width);
+        out.append(text, 0, length);
+        out.append(static_cast<size_t>(width) - length, ' ');
+    }
+} // end anonymous namespace
+
+// --- Constructor ---
+
+DashboardReport::DashboardReport(std::vector<DashboardRow> dashboardRows, std::string tempUnit,
+                                 std::string speedUnit, std::string precipitationUnit)
+    : rows(std::move(dashboardRows)), temperatureUnit(std::move(tempUnit)),
+      windUnit(std::move(speedUnit)), precipUnit(std::move(precipitationUnit)) {}
+
+// --- Overridden Methods ---
+
+std::string DashboardReport::getReportType() const {
+    return "Watchlist Dashboard";
+}
+
+void DashboardReport::display(std::ostream& os) const {
+    TRACE_SCOPE("DashboardReport::display", "render");
+    std::string out;
+    out.reserve(256 + rows.size() * 96); // About one line per row.
+
+    out += "\n--- " + getReportType() + " ---\n";
+    if (rows.empty()) {
+        out += "(No locations in the watchlist)\n";
+    } else {
+        out += "  ";
+        appendColumn(out, "Location", LOCATION_WIDTH);
+        out += " | ";
+        appendColumn(out, "Temp " + temperatureUnit, 13);
+        out += " | ";
+        appendColumn(out, "Wind " + windUnit, 15);
+        out += " | ";
+        appendColumn(out, "Precip " + precipUnit, 9);
+        out += " | Next hr | Age\n";
+        out += "  " + std::string(LOCATION_WIDTH, ' ') + " |    now  chg1h |     now   chg1h |       now |  chance |\n";
+        out += "  " + std::string(LOCATION_WIDTH, '-') + "-+---------------+-----------------+-----------+---------+-----\n";
+
+        for (const auto& row : rows) {
+            out += "  ";
+            appendColumn(out, row.location, LOCATION_WIDTH);
+            if (!row.hasData) {
+                out += " | (no data yet)\n";
+                continue;
+            }
+            out += " | ";
+            appendValue(out, row.temperature, 6, 1);
+            appendValue(out, row.temperatureChange, 7, 1, true);
+            out += " | ";
+            appendValue(out, row.windSpeed, 7, 1);
+            appendValue(out, row.windChange, 8, 1, true);
+            out += " | ";
+            appendValue(out, row.precipitation, 9, 1);
+            out += " | ";
+            appendValue(out, row.nextPrecipChance, 6, 0);
+            out += std::isnan(row.nextPrecipChance) ? "  | " : "% | ";
+            appendAge(out, row.ageSeconds);
+            if (row.stale) { out += " (stale)"; }
+            out += '\n';
+        }
+    }
+    out += "--- End of " + getReportType() + " ---\n";
+
+    os.write(out.data(), static_cast<std::streamsize>(out.size()));
+    os.flush();
+}
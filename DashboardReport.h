@@ -0,0 +1,48 @@
+// DashboardReport.h
+#ifndef DASHBOARDREPORT_H
+#define DASHBOARDREPORT_H
+
+#include "WeatherReport.h" // Base class interface
+#include <string>          // For location names and units
+#include <vector>          // For the rows
+#include <ostream>         // For display method parameter
+
+// One watchlist location on the dashboard. Values are NaN where unavailable.
+struct DashboardRow {
+    std::string location;     // As listed in the watchlist.
+    bool hasData;             // false until the first successful fetch.
+    bool stale;               // The last refresh failed; values are from an earlier one.
+    double temperature;       // Current hour.
+    double windSpeed;         // Current hour.
+    double precipitation;     // Current hour.
+    double temperatureChange; // Next hour minus current hour.
+    double windChange;        // Next hour minus current hour.
+    double nextPrecipChance;  // Next hour's chance of precipitation (percent).
+    long long ageSeconds;     // Time since the data was fetched.
+};
+
+// Compact multi-site view: one row per watchlist location with the current hour's
+// temperature, wind and precipitation, and how the next hour differs.
+class DashboardReport : public WeatherReport {
+  private:
+  std::vector<DashboardRow> rows;
+  // Units of the value columns (from the first location with data).
+  std::string temperatureUnit, windUnit, precipUnit;
+
+  public:
+  DashboardReport(std::vector<DashboardRow> dashboardRows, std::string tempUnit,
+                  std::string speedUnit, std::string precipitationUnit);
+
+  // --- Overridden Virtual Methods ---
+
+  std::string getReportType() const override;
+  // Formats the whole table into one buffer and writes it with a single call, so a large
+  // dashboard appears at once instead of row by row.
+  void display(std::ostream& os) const override;
+
+  // --- Specific Getter ---
+
+  const std::vector<DashboardRow>& getRows() const { return rows; }
+};
+
+#endif // DASHBOARDREPORT_H
@@ -0,0 +1,97 @@
+// DerivedMetrics.cpp
+#include "DerivedMetrics.h"
+#include "Property.h"  // Property objects stored in Weather
+
+#include <cmath>       // For exp, log, pow
+#include <vector>      // For scratch output columns
+#include <string>      // For unit labels
+#include <algorithm>   // For std::max, std::min
+
+// --- Internal Helper Functions (Anonymous Namespace) ---
+namespace {
+    // Magnus coefficients (Alduchov & Eskridge), valid for -40C..50C.
+    const double MAGNUS_A = 17.625;
+    const double MAGNUS_B = 243.04;
+
+    double celsiusToFahrenheit(double c) { return c * 9.0 / 5.0 + 32.0; }
+    double fahrenheitToCelsius(double f) { return (f - 32.0) * 5.0 / 9.0; }
+
+    // Names and units of the stored properties, interned once.
+    const InternedString NAME_DEW_POINT("Dew Point");
+    const InternedString NAME_HEAT_INDEX("Heat Index");
+    const InternedString NAME_WIND_CHILL("Wind Chill");
+    const InternedString NAME_APPARENT_TEMP("Apparent Temp");
+    const InternedString DEGREES_C("\370C"); // Degree symbol: \370
+    const InternedString DEGREES_F("\370F");
+} // end anonymous namespace
+
+// --- Batch Computation ---
+
+void DerivedMetrics::computeBatch(const double* tempC, const double* humidity, const double* windKph, std::size_t count,
+                                  double* dewPointC, double* heatIndexC, double* windChillC, double* apparentC) {
+    // Each loop reads and writes whole columns; conditions are expressed as selects, not
+    // branches, so every element takes the same path.
+
+    // Dew point.
+    for (std::size_t i = 0; i < count; ++i) {
+        double rh = std::min(100.0, std::max(1.0, humidity[i])); // log(0) guard
+        double gamma = std::log(rh / 100.0) + MAGNUS_A * tempC[i] / (MAGNUS_B + tempC[i]);
+        dewPointC[i] = MAGNUS_B * gamma / (MAGNUS_A - gamma);
+    }
+
+    // Heat index (computed in Fahrenheit, as the regression is defined).
+    for (std::size_t i = 0; i < count; ++i) {
+        double t = celsiusToFahrenheit(tempC[i]);
+        double rh = humidity[i];
+        double simple = 0.5 * (t + 61.0 + (t - 68.0) * 1.2 + rh * 0.094);
+        double full = -42.379 + 2.04901523 * t + 10.14333127 * rh - 0.22475541 * t * rh
+                    - 6.83783e-3 * t * t - 5.481717e-2 * rh * rh + 1.22874e-3 * t * t * rh
+                    + 8.5282e-4 * t * rh * rh - 1.99e-6 * t * t * rh * rh;
+        double useFull = ((simple + t) * 0.5 >= 80.0) ? 1.0 : 0.0;
+        heatIndexC[i] = fahrenheitToCelsius(useFull * full + (1.0 - useFull) * simple);
+    }
+
+    // Wind chill.
+    for (std::size_t i = 0; i < count; ++i) {
+        double t = tempC[i];
+        double v = std::pow(std::max(windKph[i], 0.0), 0.16);
+        double chill = 13.12 + 0.6215 * t - 11.37 * v + 0.3965 * t * v;
+        double applies = (t <= 10.0 && windKph[i] >= 4.8) ? 1.0 : 0.0;
+        windChillC[i] = applies * std::min(chill, t) + (1.0 - applies) * t;
+    }
+
+    // Apparent temperature (wind in m/s, vapour pressure in hPa).
+    for (std::size_t i = 0; i < count; ++i) {
+        double t = tempC[i];
+        double vapour = humidity[i] / 100.0 * 6.105 * std::exp(17.27 * t / (237.7 + t));
+        apparentC[i] = t + 0.33 * vapour - 0.70 * (windKph[i] / 3.6) - 4.00;
+    }
+}
+
+double DerivedMetrics::precipProbabilityRollup(const double* percents, std::size_t count) {
+    double highest = 0.0;
+    for (std::size_t i = 0; i < count; ++i) { highest = std::max(highest, percents[i]); }
+    return std::min(100.0, highest);
+}
+
+// --- Weather Integration ---
+
+void DerivedMetrics::addToWeather(Weather* const* targets, const double* tempC, const double* humidity,
+                                  const double* windKph, std::size_t count, bool imperial, FieldMask fields) {
+    std::vector<double> dew(count), heat(count), chill(count), apparent(count);
+    computeBatch(tempC, humidity, windKph, count, dew.data(), heat.data(), chill.data(), apparent.data());
+
+    const InternedString tempUnit = imperial ? DEGREES_F : DEGREES_C;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (imperial) {
+            dew[i] = celsiusToFahrenheit(dew[i]);
+            heat[i] = celsiusToFahrenheit(heat[i]);
+            chill[i] = celsiusToFahrenheit(chill[i]);
+            apparent[i] = celsiusToFahrenheit(apparent[i]);
+        }
+        if (fields.has(DEW_POINT)) { targets[i]->setProperty(DEW_POINT, new Property(NAME_DEW_POINT, dew[i], tempUnit)); }
+        if (fields.has(HEAT_INDEX)) { targets[i]->setProperty(HEAT_INDEX, new Property(NAME_HEAT_INDEX, heat[i], tempUnit)); }
+        if (fields.has(WIND_CHILL)) { targets[i]->setProperty(WIND_CHILL, new Property(NAME_WIND_CHILL, chill[i], tempUnit)); }
+        if (fields.has(APPARENT_TEMP)) { targets[i]->setProperty(APPARENT_TEMP, new Property(NAME_APPARENT_TEMP, apparent[i], tempUnit)); }
+    }
+}
@@ -0,0 +1,47 @@
+// DerivedMetrics.h
+#ifndef DERIVEDMETRICS_H
+#define DERIVEDMETRICS_H
+
+#include "Weather.h" // FieldMask (which derived properties to store)
+#include <cstddef>   // For size_t
+
+// Computes indicators that the API does not report directly (dew point, heat index, wind chill,
+// apparent temperature) for whole batches of readings at once, e.g. all hours of a day.
+// Inputs and outputs are plain arrays (one value per reading) in metric units; the batch loops
+// are branch-free so the compiler can vectorize them.
+class DerivedMetrics {
+  public:
+  // Delete constructor to prevent instantiation of this utility class.
+  DerivedMetrics() = delete;
+
+  // --- Batch Computation ---
+
+  // Fills the four output arrays ('count' entries each) from temperature (C), relative
+  // humidity (%) and wind speed (km/h).
+  // Dew point: Magnus formula. Heat index: NWS (Rothfusz) regression, or Steadman's simple
+  // form below 80F. Wind chill: Environment Canada/NWS formula, equal to the temperature
+  // when it is above 10C or the wind is below 4.8 km/h. Apparent temperature: Steadman
+  // (Australian BoM) formula including humidity and wind.
+  static void computeBatch(const double* tempC, const double* humidity, const double* windKph, std::size_t count,
+                           double* dewPointC, double* heatIndexC, double* windChillC, double* apparentC);
+
+  // Returns the chance (%) of precipitation in any of 'count' periods, given each period's
+  // chance (%). Uses the maximum, as WeatherAPI does for its daily figure.
+  static double precipProbabilityRollup(const double* percents, std::size_t count);
+
+  // --- Weather Integration ---
+
+  // Computes the derived values for 'count' readings and stores them as DEW_POINT, HEAT_INDEX,
+  // WIND_CHILL and APPARENT_TEMP properties on 'targets[i]', in the display unit system.
+  // Only the properties in 'fields' are stored.
+  static void addToWeather(Weather* const* targets, const double* tempC, const double* humidity,
+                           const double* windKph, std::size_t count, bool imperial,
+                           FieldMask fields = FieldMask::all());
+
+  // The properties addToWeather can store.
+  static constexpr FieldMask derivedFields() {
+      return FieldMask().with(DEW_POINT).with(HEAT_INDEX).with(WIND_CHILL).with(APPARENT_TEMP);
+  }
+};
+
+#endif // DERIVEDMETRICS_H
@@ -3,36 +3,47 @@
 #define FORECAST_H
 
 #include "Weather.h" // Dependency for weather data container
+#include "TimeFormat.h" // LocationInfo (forecast location and time zone)
 #include <vector>    // For storing lists of forecasts
 #include <string>    // For date and time strings
+#include <cstddef>   // For sizeBytes
 
 // Represents weather conditions for a specific hour within a day.
 class HourlyForecast {
 private:
     Weather weather; // Weather data for this hour.
-    std::string time; // Time identifier (e.g., "HH:MM").
+    InternedString time; // Time identifier in the location's time zone (e.g., "HH:MM"), shared by equal hours.
+    long long epoch;  // Start of the hour (Unix time, UTC).
+
+    friend class ForecastMerge; // Updates entries in place on refresh.
 
 public:
-    // Constructor: Initializes with weather data and time string.
+    // Constructor: Initializes with weather data, time string and the hour's epoch.
     // Takes Weather by const reference and copies it, or could be modified to move.
-    HourlyForecast(Weather w, const std::string& t) : weather(std::move(w)), time(t) {} // Now moves Weather
+    HourlyForecast(Weather w, InternedString t, long long e = 0) : weather(std::move(w)), time(t), epoch(e) {} // Now moves Weather
     // Provides read-only access to the hourly weather data.
     const Weather& getWeather() const { return weather; }
     // Provides read-only access to the time string.
-    std::string getTime() const { return time; }
+    const std::string& getTime() const { return time; }
+    // Returns the start of the hour as Unix time (0 if unknown).
+    long long getEpoch() const { return epoch; }
+    // Returns the bytes this hour holds, itself included (see Weather::sizeBytes).
+    std::size_t sizeBytes() const { return sizeof(HourlyForecast) - sizeof(Weather) + weather.sizeBytes(); }
 };
 
 // Represents the forecast for a single day, containing daily summary and hourly details.
 class DailyForecast {
 private:
-    std::string date; // Date identifier (e.g., "YYYY-MM-DD").
+    InternedString date; // Date identifier (e.g., "YYYY-MM-DD"), shared by every location's same day.
     Weather dayWeather; // Summary weather data for the entire day.
     std::vector<HourlyForecast> hourlyForecasts; // List of hourly forecasts for this day.
 
+    friend class ForecastMerge; // Updates entries in place on refresh.
+
 public:
     // Constructor: Initializes with date and daily summary weather.
     // Takes Weather by const reference and copies it, or could be modified to move.
-    DailyForecast(const std::string& d, Weather dw) : date(d), dayWeather(std::move(dw)) {} // Now moves Weather
+    DailyForecast(InternedString d, Weather dw) : date(d), dayWeather(std::move(dw)) {} // Now moves Weather
     // Adds an hourly forecast entry to this day's list.
     // Takes HourlyForecast by const reference and copies it, or could be modified to move.
     void addHourlyForecast(HourlyForecast forecast) { // Now takes by value and moves
@@ -43,15 +54,31 @@ public:
     // Provides read-only access to the daily summary weather data.
     const Weather& getDayWeather() const { return dayWeather; }
     // Provides read-only access to the date string.
-    std::string getDate() const { return date; }
+    const std::string& getDate() const { return date; }
+    // Returns the bytes this day holds, itself included: the summary, the hour vector's
+    // capacity and what each hour holds beyond its slot.
+    std::size_t sizeBytes() const {
+        std::size_t bytes = sizeof(DailyForecast) - sizeof(Weather) + dayWeather.sizeBytes()
+                          + hourlyForecasts.capacity() * sizeof(HourlyForecast);
+        for (const auto& hour : hourlyForecasts) { bytes += hour.sizeBytes() - sizeof(HourlyForecast); }
+        return bytes;
+    }
 };
 
 // Top-level container for the entire forecast period, holding multiple daily forecasts.
 class Forecast {
 private:
     std::vector<DailyForecast> dailyForecasts; // List of daily forecasts.
+    LocationInfo location; // Where (and in which time zone) the forecast applies.
+
+    friend class ForecastMerge; // Updates entries in place on refresh.
 
 public:
+    // Sets the forecast location and its time zone.
+    void setLocation(LocationInfo info) { location = std::move(info); }
+    // Provides read-only access to the forecast location.
+    const LocationInfo& getLocation() const { return location; }
+
     // Adds a daily forecast entry to the main list.
     // Takes DailyForecast by const reference and copies it, or could be modified to move.
     void addDailyForecast(DailyForecast forecast) { // Now takes by value and moves
@@ -59,6 +86,12 @@ public:
     }
     // Provides read-only access to the vector of daily forecasts.
     const std::vector<DailyForecast>& getDailyForecasts() const { return dailyForecasts; }
+    // Returns the bytes this forecast holds, itself included (the location's strings are interned).
+    std::size_t sizeBytes() const {
+        std::size_t bytes = sizeof(Forecast) + dailyForecasts.capacity() * sizeof(DailyForecast);
+        for (const auto& day : dailyForecasts) { bytes += day.sizeBytes() - sizeof(DailyForecast); }
+        return bytes;
+    }
 
     // Note: Display methods previously here are now moved to ForecastReport.
 };
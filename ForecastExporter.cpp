@@ -0,0 +1,734 @@
+// ForecastExporter.cpp
+#include "ForecastExporter.h"
+#include "Forecast.h"    // Days and hours to export
+#include "Property.h"    // Property values
+#include "Trace.h"       // Optional span tracing
+#include <algorithm>     // For std::max, std::min
+#include <cctype>        // For std::tolower
+#include <cmath>         // For std::fabs, std::llround, std::isnan
+#include <cstdint>       // For fixed-width integers (Arrow layout)
+#include <cstdio>        // For std::FILE, std::fopen, std::fwrite
+#include <cstring>       // For std::memcpy, std::memset
+#include <iostream>      // For error output (cerr)
+#include <vector>        // For buffers and columns
+
+// --- Internal Helper Functions (Anonymous Namespace) ---
+namespace {
+    // Column names, in PropertyIndex order.
+    const char* const PROPERTY_COLUMNS[NUM_PROPERTIES] = {
+        "temperature", "feels_like", "wind_speed", "wind_direction", "humidity", "pressure",
+        "visibility", "uv", "gust_speed", "precipitation", "cloud", "last_updated",
+        "dew_point", "heat_index", "wind_chill", "apparent_temperature", "precip_probability"
+    };
+
+    // Longest text a single number can take (sign, 19 digits, point, 6 decimals, or "%.17g").
+    const std::size_t MAX_NUMBER_CHARS = 40;
+
+    // Buffered output file. Small writes are gathered in one large buffer; writes of at least
+    // half the buffer go straight to the file.
+    class OutputFile {
+      public:
+      OutputFile(const std::string& path, std::size_t bufferBytes)
+          : file(std::fopen(path.c_str(), "wb")), buffer(std::max<std::size_t>(bufferBytes, 4096)),
+            used(0), written(0), error(file == nullptr) {
+          if (file != nullptr) { std::setvbuf(file, nullptr, _IONBF, 0); } // Already buffered here.
+      }
+      ~OutputFile() { close(); }
+
+      OutputFile(const OutputFile&) = delete;
+      OutputFile& operator=(const OutputFile&) = delete;
+
+      bool isOpen() const { return file != nullptr; }
+      bool failed() const { return error; }
+      // Bytes written so far (including buffered ones).
+      unsigned long long position() const { return written + used; }
+
+      // Returns room for at least 'n' (<= 4096) bytes; report what was used with commit().
+      char* reserve(std::size_t n) {
+          if (buffer.size() - used < n) { flush(); }
+          return buffer.data() + used;
+      }
+      void commit(std::size_t n) { used += n; }
+
+      void put(char c) { *reserve(1) = c; ++used; }
+      void write(const void* data, std::size_t n) {
+          if (n <= buffer.size() - used) {
+              std::memcpy(buffer.data() + used, data, n);
+              used += n;
+              return;
+          }
+          flush();
+          if (n >= buffer.size() / 2) {
+              writeThrough(data, n);
+          } else {
+              std::memcpy(buffer.data(), data, n);
+              used = n;
+          }
+      }
+      void write(const std::string& text) { write(text.data(), text.size()); }
+      void zeros(std::size_t n) {
+          static const char ZEROS[64] = {};
+          while (n > 0) {
+              std::size_t chunk = std::min<std::size_t>(n, sizeof(ZEROS));
+              write(ZEROS, chunk);
+              n -= chunk;
+          }
+      }
+
+      void flush() {
+          if (used > 0) {
+              writeThrough(buffer.data(), used);
+              used = 0;
+          }
+      }
+      // Flushes and closes. Returns false if any write failed.
+      bool close() {
+          if (file == nullptr) { return !error; }
+          flush();
+          if (std::fclose(file) != 0) { error = true; }
+          file = nullptr;
+          return !error;
+      }
+
+      private:
+      std::FILE* file;
+      std::vector<char> buffer;
+      std::size_t used;
+      unsigned long long written; // Bytes handed to the file.
+      bool error;
+
+      void writeThrough(const void* data, std::size_t n) {
+          if (file == nullptr || error) { return; }
+          if (std::fwrite(data, 1, n, file) != n) { error = true; }
+          written += n;
+      }
+    };
+
+    // --- Number Formatting (no locale, no allocation) ---
+
+    // Writes the decimal digits of 'value' to 'out'; returns the number of characters.
+    std::size_t formatUnsigned(char* out, unsigned long long value) {
+        char digits[20];
+        std::size_t count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        for (std::size_t i = 0; i < count; ++i) { out[i] = digits[count - 1 - i]; }
+        return count;
+    }
+
+    std::size_t formatInteger(char* out, long long value) {
+        if (value < 0) {
+            out[0] = '-';
+            return 1 + formatUnsigned(out + 1, 0ULL - static_cast<unsigned long long>(value));
+        }
+        return formatUnsigned(out, static_cast<unsigned long long>(value));
+    }
+
+    // Writes 'value' rounded to 'decimals' fractional digits, dropping trailing zeros
+    // (e.g., 12.5, -3, 0.25). Falls back to "%.17g" for magnitudes beyond exact integers.
+    std::size_t formatDecimal(char* out, double value, int decimals) {
+        static const long long POW10[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+        const long long scale = POW10[decimals];
+        double scaled = value * static_cast<double>(scale);
+        if (!(std::fabs(scaled) < 9.0e15)) {
+            return static_cast<std::size_t>(std::snprintf(out, MAX_NUMBER_CHARS, "%.17g", value));
+        }
+        long long units = std::llround(scaled);
+        std::size_t length = 0;
+        if (units < 0) {
+            out[length++] = '-';
+            units = -units;
+        }
+        length += formatUnsigned(out + length, static_cast<unsigned long long>(units / scale));
+        long long fraction = units % scale;
+        if (fraction != 0) {
+            int digits = decimals;
+            while (fraction % 10 == 0) { fraction /= 10; --digits; }
+            out[length++] = '.';
+            for (int i = digits - 1; i >= 0; --i) {
+                out[length + static_cast<std::size_t>(i)] = static_cast<char>('0' + fraction % 10);
+                fraction /= 10;
+            }
+            length += static_cast<std::size_t>(digits);
+        }
+        return length;
+    }
+
+    // --- Minimal FlatBuffers Builder (for Arrow IPC metadata) ---
+
+    // Builds a FlatBuffer back to front, as the reference builder does: children are created
+    // first, so every offset points forward in the finished buffer. Only what the Arrow
+    // Schema/Message/Footer tables need: scalars, strings, tables, and vectors of offsets or
+    // structs. Assumes a little-endian host.
+    class FlatBuilder {
+      public:
+      FlatBuilder() : buf(1024), head(1024), minAlign(1), tableStart(0) {}
+
+      // Bytes written so far; also the "end offset" returned for each object.
+      std::uint32_t size() const { return static_cast<std::uint32_t>(buf.size() - head); }
+
+      std::uint32_t createString(const std::string& text) {
+          align(4, text.size() + 1);
+          zeros(1);
+          bytes(text.data(), text.size());
+          push<std::uint32_t>(static_cast<std::uint32_t>(text.size()));
+          return size();
+      }
+      // 'data' holds 'count' structs of 'elementSize' bytes, already laid out.
+      std::uint32_t createStructVector(const void* data, std::size_t count, std::size_t elementSize,
+                                       std::size_t alignment) {
+          align(4, count * elementSize);
+          align(alignment, count * elementSize);
+          bytes(data, count * elementSize);
+          push<std::uint32_t>(static_cast<std::uint32_t>(count));
+          return size();
+      }
+      std::uint32_t createOffsetVector(const std::vector<std::uint32_t>& offsets) {
+          align(4, offsets.size() * 4);
+          for (std::size_t i = offsets.size(); i-- > 0; ) { push<std::uint32_t>(referTo(offsets[i])); }
+          push<std::uint32_t>(static_cast<std::uint32_t>(offsets.size()));
+          return size();
+      }
+
+      void startTable() {
+          fields.clear();
+          tableStart = size();
+      }
+      template <typename T> void addScalar(int id, T value) {
+          align(sizeof(T));
+          push<T>(value);
+          fields.push_back(FieldLocation{id, size()});
+      }
+      void addOffset(int id, std::uint32_t offset) {
+          std::uint32_t relative = referTo(offset);
+          push<std::uint32_t>(relative);
+          fields.push_back(FieldLocation{id, size()});
+      }
+      // Writes the table's vtable and returns the table's offset.
+      std::uint32_t endTable() {
+          align(4);
+          push<std::int32_t>(0); // Patched below to point at the vtable.
+          const std::uint32_t tableEnd = size();
+          int maxId = -1;
+          for (const auto& field : fields) { maxId = std::max(maxId, field.id); }
+          std::vector<std::uint16_t> slots(static_cast<std::size_t>(maxId + 1), 0);
+          for (const auto& field : fields) {
+              slots[static_cast<std::size_t>(field.id)] = static_cast<std::uint16_t>(tableEnd - field.end);
+          }
+          for (std::size_t i = slots.size(); i-- > 0; ) { push<std::uint16_t>(slots[i]); }
+          push<std::uint16_t>(static_cast<std::uint16_t>(tableEnd - tableStart));
+          push<std::uint16_t>(static_cast<std::uint16_t>((slots.size() + 2) * 2));
+          // The vtable sits just before the table: vtable = table - soffset.
+          std::int32_t soffset = static_cast<std::int32_t>(size()) - static_cast<std::int32_t>(tableEnd);
+          std::memcpy(&buf[buf.size() - tableEnd], &soffset, sizeof(soffset));
+          return tableEnd;
+      }
+
+      // Adds the root offset and returns the finished buffer.
+      std::vector<std::uint8_t> finish(std::uint32_t root) {
+          align(minAlign, 4);
+          push<std::uint32_t>(referTo(root));
+          return std::vector<std::uint8_t>(buf.begin() + static_cast<std::ptrdiff_t>(head), buf.end());
+      }
+
+      private:
+      struct FieldLocation { int id; std::uint32_t end; };
+      std::vector<std::uint8_t> buf; // Data lives in [head, end).
+      std::size_t head;
+      std::size_t minAlign;
+      std::uint32_t tableStart;
+      std::vector<FieldLocation> fields;
+
+      std::uint8_t* make(std::size_t n) {
+          if (head < n) {
+              std::size_t used = buf.size() - head;
+              std::size_t grown = std::max(buf.size() * 2, used + n + 64);
+              std::vector<std::uint8_t> bigger(grown);
+              std::memcpy(bigger.data() + grown - used, buf.data() + head, used);
+              buf.swap(bigger);
+              head = grown - used;
+          }
+          head -= n;
+          return buf.data() + head;
+      }
+      void zeros(std::size_t n) { std::memset(make(n), 0, n); }
+      void bytes(const void* data, std::size_t n) { if (n > 0) { std::memcpy(make(n), data, n); } }
+      template <typename T> void push(T value) { std::memcpy(make(sizeof(T)), &value, sizeof(T)); }
+      // Pads so that after 'extra' more bytes the size is a multiple of 'alignment'.
+      void align(std::size_t alignment, std::size_t extra = 0) {
+          minAlign = std::max(minAlign, alignment);
+          zeros((alignment - (size() + extra) % alignment) % alignment);
+      }
+      // Relative offset from a uoffset about to be pushed to the object at 'offset'.
+      std::uint32_t referTo(std::uint32_t offset) {
+          align(4);
+          return size() - offset + 4;
+      }
+    };
+
+    // --- Arrow Layout Constants (Schema.fbs / Message.fbs / File.fbs) ---
+
+    const std::int16_t ARROW_METADATA_V5 = 4;
+    const std::uint8_t ARROW_HEADER_SCHEMA = 1;
+    const std::uint8_t ARROW_HEADER_RECORD_BATCH = 3;
+    const std::uint8_t ARROW_TYPE_INT = 2;
+    const std::uint8_t ARROW_TYPE_FLOATING_POINT = 3;
+    const std::uint8_t ARROW_TYPE_UTF8 = 5;
+    const std::int16_t ARROW_PRECISION_DOUBLE = 2;
+    const char ARROW_MAGIC[8] = {'A', 'R', 'R', 'O', 'W', '1', 0, 0}; // Magic plus padding.
+
+    // Structs as laid out in the FlatBuffers (8-byte aligned).
+    struct ArrowFieldNode { std::int64_t length; std::int64_t nullCount; };
+    struct ArrowBuffer { std::int64_t offset; std::int64_t length; };
+    struct ArrowBlock { std::int64_t offset; std::int32_t metaDataLength; std::int32_t padding; std::int64_t bodyLength; };
+
+    std::size_t padTo8(std::size_t n) { return (n + 7) & ~static_cast<std::size_t>(7); }
+
+    // Validity bitmap (bit set = value present) and null count for one batch column.
+    struct Validity {
+        std::vector<std::uint8_t> bits;
+        std::size_t nulls = 0;
+
+        void append(bool valid, std::size_t row) {
+            if (row % 8 == 0) { bits.push_back(0); }
+            if (valid) {
+                bits.back() = static_cast<std::uint8_t>(bits.back() | (1u << (row % 8)));
+            } else {
+                ++nulls;
+            }
+        }
+        void clear() { bits.clear(); nulls = 0; }
+    };
+
+    struct StringColumn {
+        Validity validity;
+        std::vector<std::int32_t> offsets{0};
+        std::string data;
+
+        void append(const std::string& value, bool valid, std::size_t row) {
+            validity.append(valid, row);
+            if (valid) { data += value; }
+            offsets.push_back(static_cast<std::int32_t>(data.size()));
+        }
+        void clear() { validity.clear(); offsets.assign(1, 0); data.clear(); }
+    };
+
+    template <typename T>
+    struct NumberColumn {
+        Validity validity;
+        std::vector<T> values;
+
+        void append(T value, bool valid, std::size_t row) {
+            validity.append(valid, row);
+            values.push_back(valid ? value : T());
+        }
+        void clear() { validity.clear(); values.clear(); }
+    };
+} // end anonymous namespace
+
+// --- Encoders ---
+
+// Shared state of the format encoders: the output file and the property columns.
+class ForecastExporter::Encoder {
+  public:
+  Encoder(const std::string& path, const ExportOptions& options)
+      : out(path, options.bufferBytes), decimals(std::max(0, std::min(options.decimals, 6))) {
+      for (int i = 0; i < NUM_PROPERTIES; ++i) {
+          PropertyIndex index = static_cast<PropertyIndex>(i);
+          if (options.fields.has(index)) { columns.push_back(index); }
+      }
+  }
+  virtual ~Encoder() = default;
+
+  bool isOpen() const { return out.isOpen(); }
+  bool failed() const { return out.failed(); }
+
+  // Writes whatever precedes the rows (header, schema).
+  virtual void begin() = 0;
+  // Encodes one row; 'epoch' < 0 and empty 'time' mean null.
+  virtual void row(const std::string& location, const std::string& date, long long epoch,
+                   const std::string& time, const Weather& weather) = 0;
+  // Writes whatever follows the rows and closes the file. Returns false on any write error.
+  virtual bool end() { return out.close(); }
+
+  protected:
+  OutputFile out;
+  std::vector<PropertyIndex> columns;
+  int decimals;
+
+  void writeNumber(double value) {
+      char* cell = out.reserve(MAX_NUMBER_CHARS);
+      out.commit(formatDecimal(cell, value, decimals));
+  }
+  void writeInteger(long long value) {
+      char* cell = out.reserve(MAX_NUMBER_CHARS);
+      out.commit(formatInteger(cell, value));
+  }
+};
+
+namespace {
+    // RFC 4180 CSV. Text is quoted only when it contains a comma, quote or line break.
+    class CsvEncoder : public ForecastExporter::Encoder {
+      public:
+      using Encoder::Encoder;
+
+      void begin() override {
+          out.write("location,date,epoch,time", 24);
+          for (PropertyIndex index : columns) {
+              out.put(',');
+              out.write(std::string(ForecastExporter::columnName(index)));
+          }
+          out.put('\n');
+      }
+
+      void row(const std::string& location, const std::string& date, long long epoch,
+               const std::string& time, const Weather& weather) override {
+          writeText(location);
+          out.put(',');
+          writeText(date);
+          out.put(',');
+          if (epoch >= 0) { writeInteger(epoch); }
+          out.put(',');
+          writeText(time);
+          for (PropertyIndex index : columns) {
+              out.put(',');
+              const Property* property = weather.getProperty(index);
+              if (property != nullptr && !std::isnan(property->getValue())) { writeNumber(property->getValue()); }
+          }
+          out.put('\n');
+      }
+
+      private:
+      void writeText(const std::string& text) {
+          if (text.find_first_of(",\"\r\n") == std::string::npos) {
+              out.write(text);
+              return;
+          }
+          out.put('"');
+          for (char c : text) {
+              if (c == '"') { out.put('"'); }
+              out.put(c);
+          }
+          out.put('"');
+      }
+    };
+
+    // Newline-delimited JSON: one object per row, with every column present (null if unset).
+    class NdjsonEncoder : public ForecastExporter::Encoder {
+      public:
+      NdjsonEncoder(const std::string& path, const ExportOptions& options) : Encoder(path, options) {
+          // Pre-render ,"name": for each property column.
+          for (PropertyIndex index : columns) {
+              keys.push_back(std::string(",\"") + ForecastExporter::columnName(index) + "\":");
+          }
+      }
+
+      void begin() override {}
+
+      void row(const std::string& location, const std::string& date, long long epoch,
+               const std::string& time, const Weather& weather) override {
+          out.write("{\"location\":", 12);
+          writeText(location);
+          out.write(",\"date\":", 8);
+          writeText(date);
+          out.write(",\"epoch\":", 9);
+          if (epoch >= 0) { writeInteger(epoch); } else { out.write("null", 4); }
+          out.write(",\"time\":", 8);
+          if (!time.empty()) { writeText(time); } else { out.write("null", 4); }
+          for (std::size_t i = 0; i < columns.size(); ++i) {
+              out.write(keys[i]);
+              const Property* property = weather.getProperty(columns[i]);
+              if (property != nullptr && !std::isnan(property->getValue())) {
+                  writeNumber(property->getValue());
+              } else {
+                  out.write("null", 4);
+              }
+          }
+          out.write("}\n", 2);
+      }
+
+      private:
+      std::vector<std::string> keys;
+
+      void writeText(const std::string& text) {
+          out.put('"');
+          std::size_t start = 0;
+          for (std::size_t i = 0; i < text.size(); ++i) {
+              unsigned char c = static_cast<unsigned char>(text[i]);
+              if (c >= 0x20 && c != '"' && c != '\\') { continue; }
+              out.write(text.data() + start, i - start);
+              if (c == '"' || c == '\\') {
+                  out.put('\\');
+                  out.put(static_cast<char>(c));
+              } else {
+                  char escape[8];
+                  std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+                  out.write(escape, 6);
+              }
+              start = i + 1;
+          }
+          out.write(text.data() + start, text.size() - start);
+          out.put('"');
+      }
+    };
+
+    // Arrow IPC file format: magic, schema message, one record batch message per
+    // 'batchRows' rows, end-of-stream marker, then a footer indexing the batches.
+    // Columns: location/date/time as utf8, epoch as int64, properties as float64 (all nullable).
+    class ArrowEncoder : public ForecastExporter::Encoder {
+      public:
+      ArrowEncoder(const std::string& path, const ExportOptions& options)
+          : Encoder(path, options), batchRows(std::max<std::size_t>(options.batchRows, 1)), rows(0),
+            properties(columns.size()) {}
+
+      void begin() override {
+          out.write(ARROW_MAGIC, sizeof(ARROW_MAGIC));
+          FlatBuilder builder;
+          std::uint32_t schema = buildSchema(builder);
+          writeMessage(buildMessage(builder, ARROW_HEADER_SCHEMA, schema, 0));
+      }
+
+      void row(const std::string& location, const std::string& date, long long epoch,
+               const std::string& time, const Weather& weather) override {
+          locations.append(location, true, rows);
+          dates.append(date, true, rows);
+          epochs.append(epoch, epoch >= 0, rows);
+          times.append(time, !time.empty(), rows);
+          for (std::size_t i = 0; i < columns.size(); ++i) {
+              const Property* property = weather.getProperty(columns[i]);
+              bool valid = property != nullptr && !std::isnan(property->getValue());
+              properties[i].append(valid ? property->getValue() : 0.0, valid, rows);
+          }
+          if (++rows == batchRows) { writeBatch(); }
+      }
+
+      bool end() override {
+          if (rows > 0) { writeBatch(); }
+          const std::uint32_t endOfStream[2] = {0xFFFFFFFFu, 0};
+          out.write(endOfStream, sizeof(endOfStream));
+
+          FlatBuilder builder;
+          std::uint32_t schema = buildSchema(builder);
+          std::uint32_t batches = builder.createStructVector(blocks.data(), blocks.size(), sizeof(ArrowBlock), 8);
+          std::uint32_t dictionaries = builder.createStructVector(nullptr, 0, sizeof(ArrowBlock), 8);
+          builder.startTable();
+          builder.addOffset(3, batches);
+          builder.addOffset(2, dictionaries);
+          builder.addOffset(1, schema);
+          builder.addScalar<std::int16_t>(0, ARROW_METADATA_V5);
+          std::vector<std::uint8_t> footer = builder.finish(builder.endTable());
+          out.write(footer.data(), footer.size());
+          std::int32_t footerLength = static_cast<std::int32_t>(footer.size());
+          out.write(&footerLength, sizeof(footerLength));
+          out.write(ARROW_MAGIC, 6);
+          return out.close();
+      }
+
+      private:
+      std::size_t batchRows;
+      std::size_t rows; // Rows in the current batch.
+      StringColumn locations, dates, times;
+      NumberColumn<std::int64_t> epochs;
+      std::vector<NumberColumn<double>> properties;
+      std::vector<ArrowBlock> blocks; // Record batch positions, for the footer.
+
+      // Schema table: location, date, epoch, time, then the property columns.
+      std::uint32_t buildSchema(FlatBuilder& builder) const {
+          std::vector<std::uint32_t> fields;
+          fields.push_back(buildField(builder, "location", ARROW_TYPE_UTF8));
+          fields.push_back(buildField(builder, "date", ARROW_TYPE_UTF8));
+          fields.push_back(buildField(builder, "epoch", ARROW_TYPE_INT));
+          fields.push_back(buildField(builder, "time", ARROW_TYPE_UTF8));
+          for (PropertyIndex index : columns) {
+              fields.push_back(buildField(builder, ForecastExporter::columnName(index), ARROW_TYPE_FLOATING_POINT));
+          }
+          std::uint32_t fieldVector = builder.createOffsetVector(fields);
+          builder.startTable();
+          builder.addOffset(1, fieldVector);
+          builder.addScalar<std::int16_t>(0, 0); // Little-endian.
+          return builder.endTable();
+      }
+
+      static std::uint32_t buildField(FlatBuilder& builder, const char* name, std::uint8_t typeType) {
+          std::uint32_t nameOffset = builder.createString(name);
+          builder.startTable();
+          if (typeType == ARROW_TYPE_INT) {
+              builder.addScalar<std::int32_t>(0, 64);     // bitWidth
+              builder.addScalar<std::uint8_t>(1, 1);      // is_signed
+          } else if (typeType == ARROW_TYPE_FLOATING_POINT) {
+              builder.addScalar<std::int16_t>(0, ARROW_PRECISION_DOUBLE);
+          }
+          std::uint32_t type = builder.endTable();
+          std::uint32_t children = builder.createOffsetVector(std::vector<std::uint32_t>());
+          builder.startTable();
+          builder.addOffset(5, children);
+          builder.addOffset(3, type);
+          builder.addOffset(0, nameOffset);
+          builder.addScalar<std::uint8_t>(2, typeType);
+          builder.addScalar<std::uint8_t>(1, 1); // nullable
+          return builder.endTable();
+      }
+
+      static std::vector<std::uint8_t> buildMessage(FlatBuilder& builder, std::uint8_t headerType,
+                                                    std::uint32_t header, std::int64_t bodyLength) {
+          builder.startTable();
+          builder.addScalar<std::int64_t>(3, bodyLength);
+          builder.addOffset(2, header);
+          builder.addScalar<std::int16_t>(0, ARROW_METADATA_V5);
+          builder.addScalar<std::uint8_t>(1, headerType);
+          return builder.finish(builder.endTable());
+      }
+
+      // Writes an encapsulated message: continuation marker, padded metadata length, metadata.
+      // Returns the metadata length including the 8-byte prefix.
+      std::int32_t writeMessage(const std::vector<std::uint8_t>& metadata) {
+          const std::uint32_t continuation = 0xFFFFFFFFu;
+          std::int32_t length = static_cast<std::int32_t>(padTo8(metadata.size()));
+          out.write(&continuation, sizeof(continuation));
+          out.write(&length, sizeof(length));
+          out.write(metadata.data(), metadata.size());
+          out.zeros(static_cast<std::size_t>(length) - metadata.size());
+          return length + 8;
+      }
+
+      // Body pieces of the current batch, in schema order.
+      struct BodyPart { const void* data; std::size_t length; };
+
+      void addValidity(std::vector<BodyPart>& parts, const Validity& validity) const {
+          // All-valid columns may omit the bitmap.
+          parts.push_back(BodyPart{validity.bits.data(), validity.nulls > 0 ? validity.bits.size() : 0});
+      }
+
+      void writeBatch() {
+          TRACE_SCOPE("export.arrow_batch", "export");
+          std::vector<ArrowFieldNode> nodes;
+          std::vector<BodyPart> parts;
+          auto addString = [&](const StringColumn& column) {
+              nodes.push_back(ArrowFieldNode{static_cast<std::int64_t>(rows), static_cast<std::int64_t>(column.validity.nulls)});
+              addValidity(parts, column.validity);
+              parts.push_back(BodyPart{column.offsets.data(), column.offsets.size() * sizeof(std::int32_t)});
+              parts.push_back(BodyPart{column.data.data(), column.data.size()});
+          };
+          auto addNumbers = [&](const Validity& validity, const void* values, std::size_t bytes) {
+              nodes.push_back(ArrowFieldNode{static_cast<std::int64_t>(rows), static_cast<std::int64_t>(validity.nulls)});
+              addValidity(parts, validity);
+              parts.push_back(BodyPart{values, bytes});
+          };
+          addString(locations);
+          addString(dates);
+          addNumbers(epochs.validity, epochs.values.data(), epochs.values.size() * sizeof(std::int64_t));
+          addString(times);
+          for (const auto& column : properties) {
+              addNumbers(column.validity, column.values.data(), column.values.size() * sizeof(double));
+          }
+
+          // Every buffer starts on an 8-byte boundary of the body.
+          std::vector<ArrowBuffer> buffers;
+          std::int64_t bodyLength = 0;
+          for (const auto& part : parts) {
+              buffers.push_back(ArrowBuffer{bodyLength, static_cast<std::int64_t>(part.length)});
+              bodyLength += static_cast<std::int64_t>(padTo8(part.length));
+          }
+
+          FlatBuilder builder;
+          std::uint32_t bufferVector = builder.createStructVector(buffers.data(), buffers.size(), sizeof(ArrowBuffer), 8);
+          std::uint32_t nodeVector = builder.createStructVector(nodes.data(), nodes.size(), sizeof(ArrowFieldNode), 8);
+          builder.startTable();
+          builder.addScalar<std::int64_t>(0, static_cast<std::int64_t>(rows));
+          builder.addOffset(2, bufferVector);
+          builder.addOffset(1, nodeVector);
+          std::uint32_t batch = builder.endTable();
+
+          ArrowBlock block;
+          block.offset = static_cast<std::int64_t>(out.position());
+          block.padding = 0;
+          block.metaDataLength = writeMessage(buildMessage(builder, ARROW_HEADER_RECORD_BATCH, batch, bodyLength));
+          block.bodyLength = bodyLength;
+          blocks.push_back(block);
+
+          for (const auto& part : parts) {
+              if (part.length > 0) { out.write(part.data, part.length); }
+              out.zeros(padTo8(part.length) - part.length);
+          }
+
+          rows = 0;
+          locations.clear();
+          dates.clear();
+          times.clear();
+          epochs.clear();
+          for (auto& column : properties) { column.clear(); }
+      }
+    };
+} // end anonymous namespace
+
+// --- ForecastExporter ---
+
+ForecastExporter::ForecastExporter(const std::string& path, const ExportOptions& exportOptions)
+    : options(exportOptions), rowCount(0), finished(false) {
+    switch (options.format) {
+        case ExportFormat::NDJSON: encoder.reset(new NdjsonEncoder(path, options)); break;
+        case ExportFormat::ARROW:  encoder.reset(new ArrowEncoder(path, options)); break;
+        case ExportFormat::CSV:
+        default:                   encoder.reset(new CsvEncoder(path, options)); break;
+    }
+    if (encoder->isOpen()) {
+        encoder->begin();
+    } else {
+        std::cerr << "Error: Could not open export file '" << path << "' for writing." << std::endl;
+    }
+}
+
+ForecastExporter::~ForecastExporter() { finish(); }
+
+bool ForecastExporter::isOpen() const { return encoder->isOpen(); }
+
+bool ForecastExporter::write(const std::string& location, const Forecast& forecast) {
+    TRACE_SCOPE("ForecastExporter::write", "export");
+    if (finished || !encoder->isOpen()) { return false; }
+    for (const auto& day : forecast.getDailyForecasts()) {
+        if (options.granularity == ExportGranularity::DAILY) {
+            encoder->row(location, day.getDate(), -1, std::string(), day.getDayWeather());
+            ++rowCount;
+            continue;
+        }
+        for (const auto& hour : day.getHourlyForecasts()) {
+            encoder->row(location, day.getDate(), hour.getEpoch(), hour.getTime(), hour.getWeather());
+        }
+        rowCount += day.getHourlyForecasts().size();
+    }
+    return !encoder->failed();
+}
+
+bool ForecastExporter::writeWeather(const std::string& location, const std::string& date, long long epoch,
+                                    const std::string& time, const Weather& weather) {
+    if (finished || !encoder->isOpen()) { return false; }
+    encoder->row(location, date, epoch, time, weather);
+    ++rowCount;
+    return !encoder->failed();
+}
+
+bool ForecastExporter::finish() {
+    if (finished) { return !encoder->failed(); }
+    finished = true;
+    if (!encoder->isOpen()) { return false; }
+    if (!encoder->end()) {
+        std::cerr << "Error: Failed to write the export file." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ForecastExporter::parseFormat(const std::string& name, ExportFormat& format) {
+    std::string lower = name;
+    for (char& c : lower) { c = static_cast<char>(std::tolower(static_cast<unsigned char>(c))); }
+    if (lower == "csv") { format = ExportFormat::CSV; return true; }
+    if (lower == "ndjson" || lower == "jsonl") { format = ExportFormat::NDJSON; return true; }
+    if (lower == "arrow" || lower == "feather") { format = ExportFormat::ARROW; return true; }
+    return false;
+}
+
+const char* ForecastExporter::columnName(PropertyIndex index) {
+    return (index >= 0 && index < NUM_PROPERTIES) ? PROPERTY_COLUMNS[index] : "unknown";
+}
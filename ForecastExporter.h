@@ -0,0 +1,79 @@
+// ForecastExporter.h
+#ifndef FORECASTEXPORTER_H
+#define FORECASTEXPORTER_H
+
+#include "Weather.h"   // PropertyIndex, FieldMask
+#include <cstddef>     // For size_t
+#include <memory>      // For the format encoder
+#include <string>      // For paths and labels
+
+class Forecast;
+
+// Output file formats.
+enum class ExportFormat {
+    CSV,    // Header line, then one comma-separated line per row.
+    NDJSON, // One JSON object per line.
+    ARROW   // Arrow IPC file (columnar; readable by pyarrow, pandas, polars, DuckDB, ...).
+};
+
+// Which rows a Forecast produces.
+enum class ExportGranularity {
+    HOURLY, // One row per forecast hour.
+    DAILY   // One row per day summary (epoch and time are null).
+};
+
+// Export settings.
+struct ExportOptions {
+    ExportFormat format = ExportFormat::CSV;
+    ExportGranularity granularity = ExportGranularity::HOURLY;
+    FieldMask fields = FieldMask::all(); // Property columns written (in PropertyIndex order).
+    int decimals = 3;                    // Fractional digits kept in text formats (0-6).
+    std::size_t bufferBytes = 1 << 20;   // Output buffer; larger writes go straight to the file.
+    std::size_t batchRows = 65536;       // Rows per Arrow record batch (bounds memory).
+};
+
+// Writes forecast rows to a file for analysis tools. Columns are
+// location, date, epoch, time, then one number column per exported property (values are in
+// the units the forecast was fetched in; unset properties are null/empty).
+// Rows are streamed: each write() encodes straight into the output buffer (text formats) or
+// into the current column batch (Arrow), so memory stays bounded by the buffer and batch
+// sizes however many locations are exported. Not thread-safe.
+class ForecastExporter {
+  public:
+  // Row encoder for one format (defined in the .cpp).
+  class Encoder;
+
+  // Creates (truncates) 'path'. Check isOpen() before writing.
+  explicit ForecastExporter(const std::string& path, const ExportOptions& options = ExportOptions());
+  // Finishes the file if finish() was not called.
+  ~ForecastExporter();
+
+  ForecastExporter(const ForecastExporter&) = delete;
+  ForecastExporter& operator=(const ForecastExporter&) = delete;
+
+  bool isOpen() const;
+
+  // Appends the rows of one location's forecast. Returns false once a write has failed.
+  bool write(const std::string& location, const Forecast& forecast);
+  // Appends one row ('epoch' < 0 and empty 'time' are written as null).
+  bool writeWeather(const std::string& location, const std::string& date, long long epoch,
+                    const std::string& time, const Weather& weather);
+  // Flushes remaining rows (and the Arrow footer) and closes the file.
+  // Returns false if anything failed to write. Further writes are ignored.
+  bool finish();
+
+  std::size_t getRowCount() const { return rowCount; }
+
+  // Parses "csv", "ndjson"/"jsonl" or "arrow"/"feather" (case-insensitive).
+  static bool parseFormat(const std::string& name, ExportFormat& format);
+  // Returns the column name of a property (e.g., "wind_speed").
+  static const char* columnName(PropertyIndex index);
+
+  private:
+  ExportOptions options;
+  std::unique_ptr<Encoder> encoder;
+  std::size_t rowCount;
+  bool finished;
+};
+
+#endif // FORECASTEXPORTER_H
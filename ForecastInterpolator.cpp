@@ -0,0 +1,272 @@
+// ForecastInterpolator.cpp
+#include "ForecastInterpolator.h"
+#include "Property.h"  // Values read from the sources and stored in the result
+
+#include <algorithm>   // For std::max, std::min
+#include <cmath>       // For pow, sqrt, atan2, trigonometry
+#include <limits>      // For quiet_NaN
+#include <utility>     // For std::move
+
+// --- Internal Helper Functions (Anonymous Namespace) ---
+namespace {
+    const double NOT_SET = std::numeric_limits<double>::quiet_NaN();
+    const double PI = 3.14159265358979323846;
+    // Sources closer than this count as this far, so a source at the query point dominates
+    // without an infinite weight.
+    const double MIN_DISTANCE_KM = 0.01;
+
+    enum class Blend { LINEAR, CIRCULAR, NEAREST };
+
+    Blend blendFor(int index) {
+        if (index == WIND_DIRECTION) { return Blend::CIRCULAR; }
+        if (index == LAST_UPDATED) { return Blend::NEAREST; } // A timestamp, not a field.
+        return Blend::LINEAR;
+    }
+
+    // --- Kernels ---
+    // Inputs are laid out by source: column s holds 'rows' values starting at [s * rows], with
+    // 'present' 1.0 where the source has the value and 0.0 (value 0.0) where it does not.
+
+    // Weighted mean and weighted standard deviation per row. 'total' receives the weight
+    // behind each row (0 = no source had it).
+    void blendLinear(const double* values, const double* present, const double* weights, std::size_t sourceCount,
+                     std::size_t rows, double* estimate, double* spread, double* total) {
+        for (std::size_t r = 0; r < rows; ++r) { estimate[r] = 0.0; spread[r] = 0.0; total[r] = 0.0; }
+        for (std::size_t s = 0; s < sourceCount; ++s) {
+            const double w = weights[s];
+            const double* v = values + s * rows;
+            const double* m = present + s * rows;
+            for (std::size_t r = 0; r < rows; ++r) {
+                estimate[r] += w * m[r] * v[r];
+                total[r] += w * m[r];
+            }
+        }
+        for (std::size_t r = 0; r < rows; ++r) { estimate[r] /= (total[r] > 0.0) ? total[r] : 1.0; }
+        for (std::size_t s = 0; s < sourceCount; ++s) {
+            const double w = weights[s];
+            const double* v = values + s * rows;
+            const double* m = present + s * rows;
+            for (std::size_t r = 0; r < rows; ++r) {
+                double d = v[r] - estimate[r];
+                spread[r] += w * m[r] * d * d;
+            }
+        }
+        for (std::size_t r = 0; r < rows; ++r) { spread[r] = std::sqrt(spread[r] / ((total[r] > 0.0) ? total[r] : 1.0)); }
+    }
+
+    // Weighted circular mean (degrees, 0-360) and circular standard deviation (degrees) per
+    // row, from each value's cosine and sine.
+    void blendCircular(const double* cosines, const double* sines, const double* present, const double* weights,
+                       std::size_t sourceCount, std::size_t rows, double* estimate, double* spread, double* total) {
+        // 'estimate' and 'spread' hold the summed cosines and sines until the last loop.
+        for (std::size_t r = 0; r < rows; ++r) { estimate[r] = 0.0; spread[r] = 0.0; total[r] = 0.0; }
+        for (std::size_t s = 0; s < sourceCount; ++s) {
+            const double w = weights[s];
+            const double* c = cosines + s * rows;
+            const double* n = sines + s * rows;
+            const double* m = present + s * rows;
+            for (std::size_t r = 0; r < rows; ++r) {
+                estimate[r] += w * m[r] * c[r];
+                spread[r] += w * m[r] * n[r];
+                total[r] += w * m[r];
+            }
+        }
+        for (std::size_t r = 0; r < rows; ++r) {
+            double x = estimate[r], y = spread[r];
+            double length = std::min(1.0, std::sqrt(x * x + y * y) / ((total[r] > 0.0) ? total[r] : 1.0));
+            double degrees = std::atan2(y, x) * 180.0 / PI;
+            degrees = (degrees < 0.0) ? degrees + 360.0 : degrees;
+            estimate[r] = (degrees >= 360.0) ? 0.0 : degrees; // A tiny negative angle rounds up to 360.
+            // Opposite directions cancel (length 0); cap the spread at a half turn.
+            spread[r] = (length > 0.0) ? std::min(180.0, std::sqrt(std::max(0.0, -2.0 * std::log(length))) * 180.0 / PI) : 180.0;
+        }
+    }
+
+    // Scratch columns reused across properties.
+    struct Columns {
+        std::vector<double> values, sines, present, estimate, spread, total;
+        void resize(std::size_t size, std::size_t rows) {
+            values.resize(size); sines.resize(size); present.resize(size);
+            estimate.resize(rows); spread.resize(rows); total.resize(rows);
+        }
+    };
+
+    // Blends every property of 'rows' rows into 'targets'. 'cells[s * rows + r]' is source s's
+    // reading for row r (nullptr if it has none); sources are nearest first. Writes each row's
+    // spread to 'spreadOut[r * NUM_PROPERTIES + index]'.
+    void blendRows(const std::vector<const Weather*>& cells, const std::vector<double>& weights, std::size_t rows,
+                   std::vector<Weather>& targets, double* spreadOut, Columns& columns) {
+        const std::size_t sourceCount = weights.size();
+        columns.resize(sourceCount * rows, rows);
+        for (std::size_t i = 0; i < rows * NUM_PROPERTIES; ++i) { spreadOut[i] = NOT_SET; }
+
+        for (int index = 0; index < NUM_PROPERTIES; ++index) {
+            const PropertyIndex property = static_cast<PropertyIndex>(index);
+            // Name and unit come from the nearest source that has the property.
+            const Property* label = nullptr;
+            for (std::size_t i = 0; i < cells.size() && label == nullptr; ++i) {
+                if (cells[i] != nullptr) { label = cells[i]->getProperty(property); }
+            }
+            if (label == nullptr) { continue; }
+
+            const Blend blend = blendFor(index);
+            const InternedString unit = label->getUnitHandle();
+            for (std::size_t i = 0; i < cells.size(); ++i) {
+                const Property* reading = (cells[i] != nullptr) ? cells[i]->getProperty(property) : nullptr;
+                bool usable = reading != nullptr && reading->getUnitHandle() == unit;
+                double value = usable ? reading->getValue() : 0.0;
+                columns.present[i] = usable ? 1.0 : 0.0;
+                if (blend == Blend::CIRCULAR) {
+                    columns.values[i] = std::cos(value * PI / 180.0);
+                    columns.sines[i] = std::sin(value * PI / 180.0);
+                } else {
+                    columns.values[i] = value;
+                }
+            }
+
+            if (blend == Blend::LINEAR) {
+                blendLinear(columns.values.data(), columns.present.data(), weights.data(), sourceCount, rows,
+                            columns.estimate.data(), columns.spread.data(), columns.total.data());
+            } else if (blend == Blend::CIRCULAR) {
+                blendCircular(columns.values.data(), columns.sines.data(), columns.present.data(), weights.data(),
+                              sourceCount, rows, columns.estimate.data(), columns.spread.data(), columns.total.data());
+            } else {
+                for (std::size_t r = 0; r < rows; ++r) { // Nearest source that has it.
+                    columns.total[r] = 0.0;
+                    for (std::size_t s = sourceCount; s-- > 0;) {
+                        if (columns.present[s * rows + r] > 0.0) {
+                            columns.estimate[r] = columns.values[s * rows + r];
+                            columns.spread[r] = 0.0;
+                            columns.total[r] = 1.0;
+                        }
+                    }
+                }
+            }
+
+            for (std::size_t r = 0; r < rows; ++r) {
+                if (columns.total[r] <= 0.0) { continue; }
+                Property* blended = new Property(*label); // Shares the interned name and unit.
+                blended->setValue(columns.estimate[r]);
+                targets[r].setProperty(property, blended);
+                spreadOut[r * NUM_PROPERTIES + index] = columns.spread[r];
+            }
+        }
+    }
+} // end anonymous namespace
+
+// --- Constructor ---
+
+ForecastInterpolator::ForecastInterpolator(InterpolationOptions opts) : options(opts) {
+    if (options.neighbors == 0) { options.neighbors = 1; }
+}
+
+// --- Sources ---
+
+bool ForecastInterpolator::add(const std::string& key, std::shared_ptr<const Forecast> forecast) {
+    if (!forecast || !forecast->getLocation().hasCoordinates) { return false; }
+    const LocationInfo& location = forecast->getLocation();
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t slot;
+    auto found = slotOf.find(key);
+    if (found != slotOf.end()) {
+        slot = found->second;
+    } else if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        slotOf.emplace(key, slot);
+    } else {
+        slot = sources.size();
+        sources.emplace_back();
+        slotOf.emplace(key, slot);
+    }
+    sources[slot] = std::move(forecast);
+    index.insert(slot, location.latitude, location.longitude);
+    return true;
+}
+
+bool ForecastInterpolator::remove(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = slotOf.find(key);
+    if (found == slotOf.end()) { return false; }
+    index.remove(found->second);
+    sources[found->second].reset();
+    freeSlots.push_back(found->second);
+    slotOf.erase(found);
+    return true;
+}
+
+std::size_t ForecastInterpolator::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return slotOf.size();
+}
+
+// --- Interpolation ---
+
+std::unique_ptr<InterpolatedForecast> ForecastInterpolator::interpolate(double latitude, double longitude) const {
+    // Take the sources under the lock; blend without it.
+    std::vector<std::shared_ptr<const Forecast>> near;
+    std::vector<double> weights;
+    double nearestKm = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& neighbor : index.nearest(latitude, longitude, options.neighbors, options.maxDistanceKm)) {
+            if (near.empty()) { nearestKm = neighbor.distanceKm; }
+            near.push_back(sources[neighbor.id]);
+            weights.push_back(1.0 / std::pow(std::max(neighbor.distanceKm, MIN_DISTANCE_KM), options.power));
+        }
+    }
+    if (near.empty()) { return nullptr; }
+
+    // Rows are the nearest source's days and hours; other sources are matched to them.
+    const Forecast& reference = *near.front();
+    const std::vector<DailyForecast>& days = reference.getDailyForecasts();
+    std::vector<const HourlyForecast*> hours;
+    for (const auto& day : days) {
+        for (const auto& hour : day.getHourlyForecasts()) { hours.push_back(&hour); }
+    }
+    const std::size_t sourceCount = near.size();
+    std::vector<const Weather*> dayCells(sourceCount * days.size(), nullptr);
+    std::vector<const Weather*> hourCells(sourceCount * hours.size(), nullptr);
+    for (std::size_t s = 0; s < sourceCount; ++s) {
+        std::unordered_map<long long, const Weather*> byEpoch;
+        for (const auto& day : near[s]->getDailyForecasts()) {
+            for (std::size_t d = 0; d < days.size(); ++d) {
+                if (days[d].getDate() == day.getDate()) { dayCells[s * days.size() + d] = &day.getDayWeather(); }
+            }
+            for (const auto& hour : day.getHourlyForecasts()) { byEpoch.emplace(hour.getEpoch(), &hour.getWeather()); }
+        }
+        for (std::size_t h = 0; h < hours.size(); ++h) {
+            auto match = byEpoch.find(hours[h]->getEpoch());
+            if (match != byEpoch.end()) { hourCells[s * hours.size() + h] = match->second; }
+        }
+    }
+
+    std::unique_ptr<InterpolatedForecast> result(new InterpolatedForecast());
+    result->sourceCount = sourceCount;
+    result->nearestKm = nearestKm;
+    result->hourlySpread.resize(hours.size() * NUM_PROPERTIES);
+    result->dailySpread.resize(days.size() * NUM_PROPERTIES);
+    std::vector<Weather> hourWeather(hours.size()), dayWeather(days.size());
+    Columns columns;
+    blendRows(hourCells, weights, hours.size(), hourWeather, result->hourlySpread.data(), columns);
+    blendRows(dayCells, weights, days.size(), dayWeather, result->dailySpread.data(), columns);
+
+    // Same days, hours and time zone as the nearest source, at the requested point.
+    LocationInfo location = reference.getLocation();
+    location.latitude = latitude;
+    location.longitude = longitude;
+    result->forecast.setLocation(location);
+    std::size_t h = 0;
+    for (std::size_t d = 0; d < days.size(); ++d) {
+        const Weather& zoneSource = days[d].getDayWeather();
+        dayWeather[d].setTimeZone(zoneSource.getUtcOffsetSeconds(), zoneSource.getTimeZone());
+        DailyForecast day(days[d].getDate(), std::move(dayWeather[d]));
+        for (const auto& hour : days[d].getHourlyForecasts()) {
+            hourWeather[h].setTimeZone(hour.getWeather().getUtcOffsetSeconds(), hour.getWeather().getTimeZone());
+            day.addHourlyForecast(HourlyForecast(std::move(hourWeather[h]), hour.getTime(), hour.getEpoch()));
+            ++h;
+        }
+        result->forecast.addDailyForecast(std::move(day));
+    }
+    return result;
+}
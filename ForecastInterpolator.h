@@ -0,0 +1,68 @@
+// ForecastInterpolator.h
+#ifndef FORECASTINTERPOLATOR_H
+#define FORECASTINTERPOLATOR_H
+
+#include "Forecast.h"     // Source and result forecasts
+#include "SpatialIndex.h" // Nearest sources
+#include <cstddef>        // For size_t
+#include <memory>         // For shared sources and the result
+#include <mutex>          // For guarding the sources
+#include <string>         // For source keys
+#include <unordered_map>  // For key -> slot
+#include <vector>         // For the sources and spread columns
+
+// How an interpolated forecast is formed.
+struct InterpolationOptions {
+    std::size_t neighbors = 4;   // Sources blended (k nearest).
+    double maxDistanceKm = 50.0; // Sources farther away are not used.
+    double power = 2.0;          // Inverse-distance weighting exponent (weight = 1 / distance^power).
+};
+
+// A forecast estimated for a point, and how much its sources disagree about it.
+struct InterpolatedForecast {
+    Forecast forecast;       // Days, hours and times of the nearest source; values blended.
+    std::size_t sourceCount; // Forecasts that contributed.
+    double nearestKm;        // Distance to the closest of them.
+    // Weighted standard deviation of the sources around each estimate, in the property's
+    // unit (circular, in degrees, for WIND_DIRECTION). 0 with a single source; NaN where the
+    // property is not set. Hourly values follow the forecast's hours across all days.
+    std::vector<double> hourlySpread; // [hour * NUM_PROPERTIES + property]
+    std::vector<double> dailySpread;  // [day * NUM_PROPERTIES + property]
+
+    double hourSpread(std::size_t hour, PropertyIndex index) const { return hourlySpread[hour * NUM_PROPERTIES + index]; }
+    double daySpread(std::size_t day, PropertyIndex index) const { return dailySpread[day * NUM_PROPERTIES + index]; }
+};
+
+// Estimates forecasts for arbitrary points from forecasts already held for nearby locations,
+// so dense point queries need few API calls. Each value is the inverse-distance weighted
+// mean of the k nearest sources' values for the same hour (matched by epoch) or day (by
+// date); WIND_DIRECTION is averaged as a vector, and LAST_UPDATED is taken from the nearest
+// source that has it. Sources whose unit for a property differs from the result's are left
+// out of that property. Every property is blended as whole columns with branch-free loops,
+// so the compiler can vectorize them.
+// Safe to use from several threads; interpolation runs without holding the lock.
+class ForecastInterpolator {
+  public:
+  explicit ForecastInterpolator(InterpolationOptions options = InterpolationOptions());
+
+  // Adds (or replaces) the source for 'key'. Returns false, keeping nothing, if the forecast
+  // has no coordinates (LocationInfo::hasCoordinates).
+  bool add(const std::string& key, std::shared_ptr<const Forecast> forecast);
+  // Removes the source for 'key'. Returns false if there is none.
+  bool remove(const std::string& key);
+  std::size_t size() const;
+
+  // Builds the forecast for (latitude, longitude). Returns nullptr if no source is within
+  // the maximum distance.
+  std::unique_ptr<InterpolatedForecast> interpolate(double latitude, double longitude) const;
+
+  private:
+  InterpolationOptions options;
+  std::vector<std::shared_ptr<const Forecast>> sources; // By slot; nullptr = free.
+  std::vector<std::size_t> freeSlots;
+  std::unordered_map<std::string, std::size_t> slotOf;
+  SpatialIndex index;                                   // Slots by coordinates.
+  mutable std::mutex mutex;                             // Guards everything above.
+};
+
+#endif // FORECASTINTERPOLATOR_H
@@ -0,0 +1,185 @@
+// ForecastMerge.cpp
+#include "ForecastMerge.h"
+#include "Property.h"  // Property values compared and updated in place
+
+#include <cmath>       // For std::fabs, std::fmod
+#include <limits>      // For quiet_NaN
+#include <algorithm>   // For std::sort, std::unique
+#include <utility>     // For std::move
+
+// --- Internal Helper Functions (Anonymous Namespace) ---
+namespace {
+    const long long SECONDS_PER_HOUR = 3600;
+    const double NOT_SET = std::numeric_limits<double>::quiet_NaN();
+
+    // Size of a change; wind direction wraps around (350 -> 10 degrees is 20, not 340).
+    double difference(PropertyIndex index, double previous, double current) {
+        double delta = std::fabs(current - previous);
+        if (index == WIND_DIRECTION) {
+            delta = std::fmod(delta, 360.0);
+            if (delta > 180.0) { delta = 360.0 - delta; }
+        }
+        return delta;
+    }
+
+    // Returns true if every hour of both lists has the same epoch, in the same order.
+    bool sameHours(const std::vector<HourlyForecast>& a, const std::vector<HourlyForecast>& b) {
+        if (a.size() != b.size()) { return false; }
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i].getEpoch() != b[i].getEpoch()) { return false; }
+        }
+        return true;
+    }
+} // end anonymous namespace
+
+// --- ChangeThresholds ---
+
+ChangeThresholds::ChangeThresholds() {
+    for (int i = 0; i < NUM_PROPERTIES; ++i) { values[i] = 0.0; }
+    values[TEMPERATURE] = 0.5;
+    values[FEELS_LIKE] = 0.5;
+    values[WIND_SPEED] = 1.0;
+    values[WIND_DIRECTION] = 10.0;
+    values[HUMIDITY] = 5.0;
+    values[PRESSURE] = 1.0;
+    values[VISIBILITY] = 1.0;
+    values[UV] = 0.5;
+    values[GUST_SPEED] = 2.0;
+    values[PRECIPITATION] = 0.1;
+    values[CLOUD] = 5.0;
+    values[DEW_POINT] = 0.5;
+    values[HEAT_INDEX] = 0.5;
+    values[WIND_CHILL] = 0.5;
+    values[APPARENT_TEMP] = 0.5;
+    values[PRECIP_PROBABILITY] = 5.0;
+}
+
+ChangeThresholds& ChangeThresholds::set(PropertyIndex index, double threshold) {
+    if (index >= 0 && index < NUM_PROPERTIES) {
+        values[index] = (threshold > 0.0) ? threshold : 0.0;
+    }
+    return *this;
+}
+
+// --- ForecastChangeSet ---
+
+std::vector<long long> ForecastChangeSet::changedHours() const {
+    std::vector<long long> hours(addedHours);
+    for (const auto& change : changes) {
+        if (change.epoch != 0) { hours.push_back(change.epoch); }
+    }
+    std::sort(hours.begin(), hours.end());
+    hours.erase(std::unique(hours.begin(), hours.end()), hours.end());
+    return hours;
+}
+
+// --- Merge ---
+
+ForecastChangeSet ForecastMerge::merge(Forecast& current, Forecast&& fresh, long long nowEpoch,
+                                       const ChangeThresholds& thresholds) {
+    ForecastChangeSet changeSet;
+    std::vector<DailyForecast>& oldDays = current.dailyForecasts;
+    std::vector<DailyForecast>& newDays = fresh.dailyForecasts;
+    std::vector<DailyForecast> merged;
+    merged.reserve(oldDays.size() + newDays.size());
+
+    // Both lists are in date order ("YYYY-MM-DD" sorts as text), so walk them side by side.
+    size_t i = 0, j = 0;
+    while (i < oldDays.size() || j < newDays.size()) {
+        if (j == newDays.size() || (i < oldDays.size() && oldDays[i].date < newDays[j].date)) {
+            merged.push_back(std::move(oldDays[i++])); // Not in the refresh: kept until it expires.
+        } else if (i == oldDays.size() || newDays[j].date < oldDays[i].date) {
+            changeSet.addedDays.push_back(newDays[j].date);
+            for (const auto& hour : newDays[j].hourlyForecasts) { changeSet.addedHours.push_back(hour.epoch); }
+            merged.push_back(std::move(newDays[j++]));
+        } else {
+            mergeDay(oldDays[i], std::move(newDays[j]), thresholds, changeSet);
+            merged.push_back(std::move(oldDays[i]));
+            ++i;
+            ++j;
+        }
+    }
+
+    // Drop days whose last hour has ended.
+    oldDays.clear();
+    for (auto& day : merged) {
+        const auto& hours = day.hourlyForecasts;
+        if (!hours.empty() && hours.back().epoch + SECONDS_PER_HOUR <= nowEpoch) {
+            changeSet.droppedDays.push_back(day.date);
+        } else {
+            oldDays.push_back(std::move(day));
+        }
+    }
+    current.location = std::move(fresh.location);
+    fresh.dailyForecasts.clear();
+    return changeSet;
+}
+
+void ForecastMerge::mergeDay(DailyForecast& target, DailyForecast&& fresh,
+                             const ChangeThresholds& thresholds, ForecastChangeSet& changeSet) {
+    mergeWeather(target.dayWeather, fresh.dayWeather, target.date, 0, thresholds, changeSet);
+
+    std::vector<HourlyForecast>& oldHours = target.hourlyForecasts;
+    std::vector<HourlyForecast>& newHours = fresh.hourlyForecasts;
+
+    // Common case: the same hours as before, updated in place.
+    if (sameHours(oldHours, newHours)) {
+        for (size_t i = 0; i < oldHours.size(); ++i) {
+            mergeWeather(oldHours[i].weather, newHours[i].weather, target.date, oldHours[i].epoch, thresholds, changeSet);
+            oldHours[i].time = std::move(newHours[i].time);
+        }
+        changeSet.reusedHours += oldHours.size();
+        return;
+    }
+
+    // Otherwise walk both (epoch-ordered) lists side by side.
+    std::vector<HourlyForecast> merged;
+    merged.reserve(oldHours.size() + newHours.size());
+    size_t i = 0, j = 0;
+    while (i < oldHours.size() || j < newHours.size()) {
+        if (j == newHours.size() || (i < oldHours.size() && oldHours[i].epoch < newHours[j].epoch)) {
+            merged.push_back(std::move(oldHours[i++])); // Not in the refresh: kept.
+        } else if (i == oldHours.size() || newHours[j].epoch < oldHours[i].epoch) {
+            changeSet.addedHours.push_back(newHours[j].epoch);
+            merged.push_back(std::move(newHours[j++]));
+        } else {
+            mergeWeather(oldHours[i].weather, newHours[j].weather, target.date, oldHours[i].epoch, thresholds, changeSet);
+            oldHours[i].time = std::move(newHours[j].time);
+            ++changeSet.reusedHours;
+            merged.push_back(std::move(oldHours[i]));
+            ++i;
+            ++j;
+        }
+    }
+    oldHours.swap(merged);
+}
+
+void ForecastMerge::mergeWeather(Weather& target, const Weather& source, const std::string& date, long long epoch,
+                                 const ChangeThresholds& thresholds, ForecastChangeSet& changeSet) {
+    for (int i = 0; i < NUM_PROPERTIES; ++i) {
+        PropertyIndex index = static_cast<PropertyIndex>(i);
+        const Property* next = source.getProperty(index);
+        const Property* prev = target.getProperty(index);
+
+        if (next == nullptr) { // Property no longer reported.
+            if (prev != nullptr) {
+                changeSet.changes.push_back(PropertyChange{date, epoch, index, prev->getValue(), NOT_SET});
+                target.setProperty(index, nullptr);
+            }
+            continue;
+        }
+        if (prev == nullptr || prev->getUnitHandle() != next->getUnitHandle()) { // New, or now in other units (interned: one compare).
+            changeSet.changes.push_back(PropertyChange{date, epoch, index,
+                                                       prev != nullptr ? prev->getValue() : NOT_SET, next->getValue()});
+            target.setProperty(index, new Property(*next));
+            continue;
+        }
+        if (difference(index, prev->getValue(), next->getValue()) > thresholds.get(index)) {
+            changeSet.changes.push_back(PropertyChange{date, epoch, index, prev->getValue(), next->getValue()});
+        }
+        target.updateValue(index, next->getValue());
+    }
+    // Every property now holds the refreshed value; stop decoding from the previous response.
+    target.setLazySource(nullptr, FieldMask());
+    target.setTimeZone(source.getUtcOffsetSeconds(), source.getTimeZone());
+}
@@ -0,0 +1,72 @@
+// ForecastMerge.h
+#ifndef FORECASTMERGE_H
+#define FORECASTMERGE_H
+
+#include "Forecast.h" // Forecast, DailyForecast, HourlyForecast
+#include "Weather.h"  // PropertyIndex
+#include <cstddef>    // For size_t
+#include <string>     // For day dates
+#include <vector>     // For change lists
+
+// Smallest change of each property that counts as "moved" in a change set, in the
+// forecast's display units. Changes at or below the threshold are still applied.
+struct ChangeThresholds {
+    double values[NUM_PROPERTIES];
+
+    // Defaults: 0.5 degrees, 1 km/h (or mph), 10 degrees of direction, 5 % points, etc.
+    ChangeThresholds();
+    // Sets the threshold for one property (negative values are treated as 0).
+    ChangeThresholds& set(PropertyIndex index, double threshold);
+    // Returns the threshold for 'index'.
+    double get(PropertyIndex index) const { return values[index]; }
+};
+
+// One property that moved beyond its threshold.
+struct PropertyChange {
+    std::string date;    // Day the change belongs to ("YYYY-MM-DD").
+    long long epoch;     // Start of the hour (Unix time), or 0 for the day summary.
+    PropertyIndex index; // Which property changed.
+    double previous;     // Old value (NaN if the property was not set before).
+    double current;      // New value (NaN if the property is no longer set).
+};
+
+// What a merge changed, so renderers and alerts can act on diffs instead of full reports.
+struct ForecastChangeSet {
+    std::vector<PropertyChange> changes;  // Properties that moved beyond their threshold.
+    std::vector<long long> addedHours;    // Hours not present before (epochs, in forecast order).
+    std::vector<std::string> addedDays;   // Days not present before.
+    std::vector<std::string> droppedDays; // Expired days that were removed.
+    std::size_t reusedHours = 0;          // Existing hours updated in place.
+
+    // Returns true if nothing moved beyond its threshold and no day or hour came or went.
+    bool empty() const { return changes.empty() && addedHours.empty() && addedDays.empty() && droppedDays.empty(); }
+    // Returns the epochs of hours that were added or have at least one change (sorted, unique).
+    std::vector<long long> changedHours() const;
+};
+
+// Applies a freshly fetched forecast onto the one already held, instead of replacing it.
+// Hours are matched by epoch and days by date. Matching hours keep their storage and have
+// their values updated in place; new hours and days are moved in; entries the fresh forecast
+// does not mention are kept until their day has ended.
+class ForecastMerge {
+  public:
+  // Delete constructor to prevent instantiation of this utility class.
+  ForecastMerge() = delete;
+
+  // Merges 'fresh' into 'current' and returns what changed. Days whose last hour ended at or
+  // before 'nowEpoch' (Unix time) are dropped. 'fresh' is consumed.
+  // Not thread-safe: 'current' must not be shared with readers while it is merged (merge into
+  // a private copy, then publish it, e.g. through a Snapshot).
+  static ForecastChangeSet merge(Forecast& current, Forecast&& fresh, long long nowEpoch,
+                                 const ChangeThresholds& thresholds = ChangeThresholds());
+
+  private:
+  // Updates 'target' with every property of 'source', recording changes beyond the thresholds.
+  static void mergeWeather(Weather& target, const Weather& source, const std::string& date, long long epoch,
+                           const ChangeThresholds& thresholds, ForecastChangeSet& changeSet);
+  // Merges the hours and summary of 'fresh' into 'target' (both for the same date).
+  static void mergeDay(DailyForecast& target, DailyForecast&& fresh,
+                       const ChangeThresholds& thresholds, ForecastChangeSet& changeSet);
+};
+
+#endif // FORECASTMERGE_H
@@ -2,13 +2,14 @@
 #include "ForecastReport.h"
 #include "Weather.h"    // Needed for accessing Weather data within Forecast
 #include "Property.h"   // Needed for accessing Property details within Weather
+#include "Trace.h"      // Optional span tracing of rendering
+#include "TimeFormat.h" // Cached day names
 #include <utility>      // For std::move
 #include <ostream>      // For std::ostream
 #include <iomanip>      // For stream manipulators (formatting output)
 #include <sstream>      // For formatting values into strings
 #include <string>       // For std::string
 #include <vector>       // Included via Weather.h, good practice
-#include <ctime>        // For date/time parsing and formatting (%A)
 #include <cmath>        // For std::fmod in degreesToCardinal
 
 // --- Helper Functions (Anonymous Namespace) ---
@@ -22,24 +23,6 @@ namespace {
         return directions[index % 8];
     }
 
-    // Parses a "YYYY-MM-DD" string and returns the full day name (e.g., "Tuesday").
-    std::string getDayOfWeek(const std::string& dateStr) {
-        std::tm timeinfo = {};
-        std::istringstream ss(dateStr);
-        ss >> std::get_time(&timeinfo, "%Y-%m-%d");
-        if (ss.fail()) { return "Unknown Day"; }
-        // mktime normalizes tm struct and sets tm_wday
-        // Check for -1 which indicates an error during normalization
-        if (std::mktime(&timeinfo) == -1) { return "Unknown Day"; }
-
-        char buffer[20];
-        if (std::strftime(buffer, sizeof(buffer), "%A", &timeinfo)) {
-            return buffer;
-        } else {
-            return "Unknown Day";
-        }
-    }
-
 } // end anonymous namespace
 
 // --- Static Helper Function Declaration ---
@@ -59,9 +42,10 @@ std::string ForecastReport::getReportType() const {
 }
 
 void ForecastReport::display(std::ostream& os) const {
-    os << "\n--- " << getReportType() << " ---" << std::endl;
+    TRACE_SCOPE("ForecastReport::display", "render");
+    os << "\n--- " << getReportType() << " ---\n";
     if (forecastData.getDailyForecasts().empty()) {
-        os << "(No forecast data available)" << std::endl;
+        os << "(No forecast data available)\n";
     } else {
         if (displayLevel == DetailLevel::HOURLY) {
             displayHourly(os);
@@ -69,7 +53,7 @@ void ForecastReport::display(std::ostream& os) const {
             displayDaily(os);
         }
     }
-    os << "--- End of " << getReportType() << " ---" << std::endl;
+    os << "--- End of " << getReportType() << " ---\n";
 }
 
 // --- Specific Getter ---
@@ -78,24 +62,29 @@ const Forecast& ForecastReport::getForecast() const {
     return forecastData;
 }
 
+Forecast ForecastReport::takeForecast() {
+    return std::move(forecastData);
+}
+
 // --- Private Display Helpers ---
 
 // Displays daily summary forecast information with improved formatting and day separation.
 void ForecastReport::displayDaily(std::ostream& os) const {
+    TRACE_SCOPE("ForecastReport::displayDaily", "render");
     const auto& dailyForecasts = forecastData.getDailyForecasts();
     bool firstDay = true; // Flag to avoid separator before the first day
     for (const auto& day : dailyForecasts) {
         // Add a distinct separator line before each day (except the first).
         if (!firstDay) {
-            os << "----------------------------------------" << std::endl; // Separator line
+            os << "----------------------------------------\n"; // Separator line
         }
         firstDay = false;
 
         // Get the date string and corresponding day name.
-        std::string dateStr = day.getDate();
-        std::string dayName = getDayOfWeek(dateStr); // Use helper
+        const std::string& dateStr = day.getDate();
+        const std::string& dayName = TimeFormat::dayName(dateStr); // Arithmetic, no mktime/strftime
         // Print header including day name and date.
-        os << dayName << " (" << dateStr << ")" << std::endl; // Removed the extra "---"
+        os << dayName << " (" << dateStr << ")\n"; // Removed the extra "---"
         // Delegate detailed display to the helper function.
         displayWeatherForForecast(os, day.getDayWeather());
     }
@@ -104,26 +93,33 @@ void ForecastReport::displayDaily(std::ostream& os) const {
 // Displays hourly forecast information in a formatted table.
 // Wind direction in hourly remains cardinal only for table brevity.
 void ForecastReport::displayHourly(std::ostream& os) const {
+    TRACE_SCOPE("ForecastReport::displayHourly", "render");
     const auto& dailyForecasts = forecastData.getDailyForecasts();
+    // Hours are in the forecast location's local time, not the host's.
+    if (!forecastData.getLocation().tzId.empty()) {
+        os << "(Times shown in " << forecastData.getLocation().tzId << " local time)\n";
+    }
 
     // Define fixed column widths for alignment.
     const int timeW = 6;    // "HH:MM"
     const int tempW = 7;    // "XXX.XC"
     const int feelW = 7;    // "XXX.XC"
+    const int dewW  = 7;    // "XXX.XC"
     const int windW = 12;   // "XX.Xkm/h NW"
     const int precW = 8;    // "XX.Xmm"
+    const int chncW = 7;    // "100%"
     const int cldW  = 7;    // "100%"
 
     // Iterate through each day in the forecast.
     for (const auto& day : dailyForecasts) {
         // Get date and day name for the header.
-        std::string dateStr = day.getDate();
-        std::string dayName = getDayOfWeek(dateStr);
-        os << "\n--- Hourly for " << dayName << " (" << dateStr << ") ---" << std::endl;
+        const std::string& dateStr = day.getDate();
+        const std::string& dayName = TimeFormat::dayName(dateStr);
+        os << "\n--- Hourly for " << dayName << " (" << dateStr << ") ---\n";
 
         const auto& hourlyForecasts = day.getHourlyForecasts();
          if (hourlyForecasts.empty()) {
-             os << "    (No hourly data for this day)" << std::endl;
+             os << "    (No hourly data for this day)\n";
              continue; // Skip to the next day
          }
 
@@ -132,35 +128,43 @@ void ForecastReport::displayHourly(std::ostream& os) const {
            << std::setw(timeW) << "Time" << "| "
            << std::setw(tempW) << "Temp" << "| "
            << std::setw(feelW) << "Feels" << "| "
+           << std::setw(dewW) << "Dew Pt" << "| "
            << std::setw(windW) << "Wind" << "| "
            << std::setw(precW) << "Precip" << "| "
+           << std::setw(chncW) << "Chance" << "| "
            << std::setw(cldW) << "Cloud"
-           << std::endl;
+           << '\n';
         // Print the separator line. Use std:: qualifier.
         os << "  " << std::string(timeW, '-') << "+"
            << std::string(tempW+1, '-') << "+" // +1 for the space
            << std::string(feelW+1, '-') << "+"
+           << std::string(dewW+1, '-') << "+"
            << std::string(windW+1, '-') << "+"
            << std::string(precW+1, '-') << "+"
+           << std::string(chncW+1, '-') << "+"
            << std::string(cldW+1, '-')
-           << std::endl;
+           << '\n';
 
         // Print each hour's data as a table row.
         for (const auto& hour : hourlyForecasts) {
             const Weather& hw = hour.getWeather();
 
-            Property* tempProp = hw.getProperty(TEMPERATURE);
-            Property* feelProp = hw.getProperty(FEELS_LIKE);
-            Property* windSpdProp = hw.getProperty(WIND_SPEED);
-            Property* windDirProp = hw.getProperty(WIND_DIRECTION);
-            Property* precProp = hw.getProperty(PRECIPITATION);
-            Property* cldProp = hw.getProperty(CLOUD);
+            const Property* tempProp = hw.getProperty(TEMPERATURE);
+            const Property* feelProp = hw.getProperty(FEELS_LIKE);
+            const Property* dewProp = hw.getProperty(DEW_POINT);
+            const Property* windSpdProp = hw.getProperty(WIND_SPEED);
+            const Property* windDirProp = hw.getProperty(WIND_DIRECTION);
+            const Property* precProp = hw.getProperty(PRECIPITATION);
+            const Property* chncProp = hw.getProperty(PRECIP_PROBABILITY);
+            const Property* cldProp = hw.getProperty(CLOUD);
 
-            std::stringstream ssTemp, ssFeel, ssWind, ssPrec, ssCld;
+            std::stringstream ssTemp, ssFeel, ssDew, ssWind, ssPrec, ssChnc, ssCld;
 
             if(tempProp) ssTemp << std::fixed << std::setprecision(1) << tempProp->getValue() << tempProp->getUnit(); else ssTemp << "N/A";
             if(feelProp) ssFeel << std::fixed << std::setprecision(1) << feelProp->getValue() << feelProp->getUnit(); else ssFeel << "N/A";
+            if(dewProp) ssDew << std::fixed << std::setprecision(1) << dewProp->getValue() << dewProp->getUnit(); else ssDew << "N/A";
             if(precProp) ssPrec << std::fixed << std::setprecision(1) << precProp->getValue() << precProp->getUnit(); else ssPrec << "N/A";
+            if(chncProp) ssChnc << std::fixed << std::setprecision(0) << chncProp->getValue() << chncProp->getUnit(); else ssChnc << "N/A";
             if(cldProp) ssCld << std::fixed << std::setprecision(0) << cldProp->getValue() << cldProp->getUnit(); else ssCld << "N/A";
 
             // Format wind for hourly table (still cardinal only)
@@ -175,11 +179,13 @@ void ForecastReport::displayHourly(std::ostream& os) const {
             os << "  " << std::left
                << std::setw(timeW) << hour.getTime() << "| " << std::right
                << std::setw(tempW) << ssTemp.str() << "| "
-               << std::setw(feelW) << ssFeel.str() << "| " << std::left
+               << std::setw(feelW) << ssFeel.str() << "| "
+               << std::setw(dewW) << ssDew.str() << "| " << std::left
                << std::setw(windW) << ssWind.str() << "| " << std::right
                << std::setw(precW) << ssPrec.str() << "| "
+               << std::setw(chncW) << ssChnc.str() << "| "
                << std::setw(cldW) << ssCld.str()
-               << std::endl;
+               << '\n';
         }
     }
 }
@@ -198,7 +204,9 @@ static void displayWeatherForForecast(std::ostream& os, const Weather& weather)
         WIND_SPEED,  // Typically Max Wind for daily
         WIND_DIRECTION, // Daily direction if available (using helper below assumes it exists)
         PRECIPITATION, // Total Precip
+        PRECIP_PROBABILITY, // Chance of precipitation in any hour (derived)
         HUMIDITY,     // Avg Humidity
+        DEW_POINT,    // Avg Dew Point (derived from hourly data)
         VISIBILITY,   // Avg Visibility
         UV            // Max UV
         // Add Feels Like, Gust, Cloud, Pressure here if the API provides *meaningful* daily summaries for them
@@ -222,7 +230,7 @@ static void displayWeatherForForecast(std::ostream& os, const Weather& weather)
                 os << std::fixed << std::setprecision(1) << prop->getValue();
                 if (!prop->getUnit().empty()) { os << " " << prop->getUnit(); }
             }
-            os << std::endl;
+            os << '\n';
             return true;
         }
         return false;
@@ -237,6 +245,6 @@ static void displayWeatherForForecast(std::ostream& os, const Weather& weather)
 
      // If no relevant properties were displayed at all, print a placeholder.
      if (!dataDisplayed) {
-         os << "  (No specific forecast details available for this day)" << std::endl;
+         os << "  (No specific forecast details available for this day)\n";
      }
 }
\ No newline at end of file
@@ -35,6 +35,10 @@ class ForecastReport : public WeatherReport {
 
   // Provides read-only access to the underlying Forecast data.
   const Forecast& getForecast() const;
+  // Moves the forecast out (e.g., to merge it into one already held); the report is left empty.
+  Forecast takeForecast();
+  // Returns the bytes this report holds, itself included (see Forecast::sizeBytes).
+  std::size_t sizeBytes() const { return sizeof(ForecastReport) - sizeof(Forecast) + forecastData.sizeBytes(); }
 
   private:
   // --- Private Display Helpers ---
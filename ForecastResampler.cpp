@@ -0,0 +1,227 @@
+// ForecastResampler.cpp
+#include "ForecastResampler.h"
+#include "Property.h" // Values read from the forecast
+
+#include <algorithm>  // For std::copy, std::min, std::max
+#include <cmath>      // For trigonometry, remainder, floor
+#include <limits>     // For quiet_NaN, infinity
+
+// --- Internal Helper Functions (Anonymous Namespace) ---
+namespace {
+    const double NOT_SET = std::numeric_limits<double>::quiet_NaN();
+    const double PI = 3.14159265358979323846;
+    const int HOUR_SECONDS = 3600;
+    const std::size_t MAX_STEPS_PER_HOUR = HOUR_SECONDS / ForecastResampler::MIN_STEP_SECONDS;
+
+    // Keeps an angle in [0, 360).
+    double wrapDegrees(double degrees) { return degrees - 360.0 * std::floor(degrees / 360.0); }
+
+    // Fritsch-Carlson slope at a point from the changes before and after it (hours apart):
+    // 0 at a peak or trough, otherwise their harmonic mean, which keeps the curve monotone.
+    double monotoneSlope(double before, double after) {
+        return (before * after > 0.0) ? 2.0 * before * after / (before + after) : 0.0;
+    }
+
+    // --- Upsampling ('steps' rows per hour) ---
+
+    // Holds each hour's value, scaled by 'scale'.
+    void holdColumn(const double* in, std::size_t hours, std::size_t steps, double scale, double* out) {
+        for (std::size_t j = 0; j < steps; ++j) {
+            for (std::size_t i = 0; i < hours; ++i) { out[i * steps + j] = in[i] * scale; }
+        }
+    }
+
+    // Straight line to the next hour; along the shorter arc for directions.
+    void linearColumn(const double* in, std::size_t hours, std::size_t steps, bool circular, double* out) {
+        for (std::size_t i = 0; i < hours; ++i) { out[i * steps] = in[i]; } // On the hour: exact.
+        for (std::size_t j = 1; j < steps; ++j) {
+            const double f = static_cast<double>(j) / static_cast<double>(steps);
+            if (circular) {
+                for (std::size_t i = 0; i + 1 < hours; ++i) {
+                    out[i * steps + j] = wrapDegrees(in[i] + f * std::remainder(in[i + 1] - in[i], 360.0));
+                }
+            } else {
+                for (std::size_t i = 0; i + 1 < hours; ++i) { out[i * steps + j] = in[i] + f * (in[i + 1] - in[i]); }
+            }
+            out[(hours - 1) * steps + j] = in[hours - 1]; // After the last hour: held.
+        }
+    }
+
+    // Monotone cubic Hermite curve through the hours.
+    void splineColumn(const double* in, std::size_t hours, std::size_t steps, double* out) {
+        // Hermite basis for each step within an hour (steps <= MAX_STEPS_PER_HOUR).
+        double h00[MAX_STEPS_PER_HOUR], h10[MAX_STEPS_PER_HOUR], h01[MAX_STEPS_PER_HOUR], h11[MAX_STEPS_PER_HOUR];
+        for (std::size_t j = 0; j < steps; ++j) {
+            double f = static_cast<double>(j) / static_cast<double>(steps);
+            double f2 = f * f, f3 = f2 * f;
+            h00[j] = 2.0 * f3 - 3.0 * f2 + 1.0;
+            h10[j] = f3 - 2.0 * f2 + f;
+            h01[j] = -2.0 * f3 + 3.0 * f2;
+            h11[j] = f3 - f2;
+        }
+        for (std::size_t i = 0; i + 1 < hours; ++i) {
+            const double y0 = in[i], y1 = in[i + 1];
+            const double change = y1 - y0;
+            // One-sided slopes at the ends of the series.
+            const double d0 = (i == 0) ? change : monotoneSlope(y0 - in[i - 1], change);
+            const double d1 = (i + 2 == hours) ? change : monotoneSlope(change, in[i + 2] - y1);
+            double* row = out + i * steps;
+            row[0] = y0; // On the hour: exact.
+            for (std::size_t j = 1; j < steps; ++j) { row[j] = h00[j] * y0 + h10[j] * d0 + h01[j] * y1 + h11[j] * d1; }
+        }
+        for (std::size_t j = 0; j < steps; ++j) { out[(hours - 1) * steps + j] = in[hours - 1]; } // After the last hour: held.
+    }
+
+    // --- Downsampling ('span' hours per row) ---
+
+    // Combines in[0, count) by 'aggregation', skipping missing (NaN) hours.
+    double aggregate(const double* in, std::size_t count, Aggregation aggregation) {
+        double total = 0.0, peak = -std::numeric_limits<double>::infinity(), x = 0.0, y = 0.0;
+        std::size_t present = 0;
+        switch (aggregation) {
+            case Aggregation::MAX:
+                for (std::size_t k = 0; k < count; ++k) {
+                    bool known = (in[k] == in[k]); // false for NaN
+                    peak = (known && in[k] > peak) ? in[k] : peak;
+                    present += known ? 1 : 0;
+                }
+                return (present > 0) ? peak : NOT_SET;
+            case Aggregation::CIRCULAR_MEAN:
+                for (std::size_t k = 0; k < count; ++k) {
+                    bool known = (in[k] == in[k]);
+                    double radians = known ? in[k] * PI / 180.0 : 0.0;
+                    x += known ? std::cos(radians) : 0.0;
+                    y += known ? std::sin(radians) : 0.0;
+                    present += known ? 1 : 0;
+                }
+                return (present > 0) ? wrapDegrees(std::atan2(y, x) * 180.0 / PI) : NOT_SET;
+            case Aggregation::SUM:
+            case Aggregation::MEAN:
+                for (std::size_t k = 0; k < count; ++k) {
+                    bool known = (in[k] == in[k]);
+                    total += known ? in[k] : 0.0;
+                    present += known ? 1 : 0;
+                }
+                if (present == 0) { return NOT_SET; }
+                return (aggregation == Aggregation::SUM) ? total : total / static_cast<double>(present);
+        }
+        return NOT_SET;
+    }
+
+    void aggregateColumn(const double* in, std::size_t hours, std::size_t span, Aggregation aggregation, double* out) {
+        std::size_t rows = (hours + span - 1) / span;
+        for (std::size_t r = 0; r < rows; ++r) {
+            std::size_t first = r * span;
+            out[r] = aggregate(in + first, std::min(span, hours - first), aggregation);
+        }
+    }
+} // end anonymous namespace
+
+// --- ForecastSeries ---
+
+ForecastSeries::ForecastSeries() : start(0), step(HOUR_SECONDS), count(0) {}
+
+void ForecastSeries::reset(long long startEpoch, int stepSeconds, std::size_t rows) {
+    start = startEpoch;
+    step = stepSeconds;
+    count = rows;
+    values.assign(static_cast<std::size_t>(NUM_PROPERTIES) * rows, NOT_SET); // Keeps the capacity.
+}
+
+void ForecastSeries::assign(const Forecast& forecast, FieldMask fields) {
+    // Rows follow the epochs when every hour has one on the same hourly grid.
+    std::size_t hours = 0;
+    long long first = 0, last = 0;
+    bool byEpoch = true;
+    for (const auto& day : forecast.getDailyForecasts()) {
+        for (const auto& hour : day.getHourlyForecasts()) {
+            long long epoch = hour.getEpoch();
+            if (hours == 0) { first = last = epoch; }
+            byEpoch = byEpoch && epoch != 0 && (epoch - first) % HOUR_SECONDS == 0;
+            first = std::min(first, epoch);
+            last = std::max(last, epoch);
+            ++hours;
+        }
+    }
+    if (hours == 0) {
+        reset(0, HOUR_SECONDS, 0);
+        return;
+    }
+    reset(byEpoch ? first : 0, HOUR_SECONDS,
+          byEpoch ? static_cast<std::size_t>((last - first) / HOUR_SECONDS) + 1 : hours);
+
+    std::size_t position = 0;
+    for (const auto& day : forecast.getDailyForecasts()) {
+        for (const auto& hour : day.getHourlyForecasts()) {
+            std::size_t row = byEpoch ? static_cast<std::size_t>((hour.getEpoch() - first) / HOUR_SECONDS) : position;
+            ++position;
+            for (int i = 0; i < NUM_PROPERTIES; ++i) {
+                PropertyIndex index = static_cast<PropertyIndex>(i);
+                if (!fields.has(index)) { continue; }
+                const Property* property = hour.getWeather().getProperty(index);
+                if (property != nullptr) { column(index)[row] = property->getValue(); }
+            }
+        }
+    }
+}
+
+// --- ForecastResampler ---
+
+Aggregation ForecastResampler::aggregationFor(PropertyIndex index) {
+    switch (index) {
+        case PRECIPITATION: return Aggregation::SUM;
+        case GUST_SPEED:
+        case PRECIP_PROBABILITY:
+        case LAST_UPDATED: return Aggregation::MAX;
+        case WIND_DIRECTION: return Aggregation::CIRCULAR_MEAN;
+        default: return Aggregation::MEAN;
+    }
+}
+
+bool ForecastResampler::supportsStep(int stepSeconds) {
+    if (stepSeconds < MIN_STEP_SECONDS) { return false; }
+    return (stepSeconds < HOUR_SECONDS) ? HOUR_SECONDS % stepSeconds == 0 : stepSeconds % HOUR_SECONDS == 0;
+}
+
+std::size_t ForecastResampler::outputRows(std::size_t hours, int stepSeconds) {
+    if (!supportsStep(stepSeconds)) { return 0; }
+    if (stepSeconds < HOUR_SECONDS) { return hours * static_cast<std::size_t>(HOUR_SECONDS / stepSeconds); }
+    std::size_t span = static_cast<std::size_t>(stepSeconds / HOUR_SECONDS);
+    return (hours + span - 1) / span;
+}
+
+bool ForecastResampler::resampleColumn(PropertyIndex index, const double* in, std::size_t hours, int stepSeconds,
+                                       Interpolation method, double* out) {
+    if (!supportsStep(stepSeconds)) { return false; }
+    if (hours == 0) { return true; }
+    if (stepSeconds == HOUR_SECONDS) {
+        std::copy(in, in + hours, out);
+    } else if (stepSeconds > HOUR_SECONDS) {
+        aggregateColumn(in, hours, static_cast<std::size_t>(stepSeconds / HOUR_SECONDS), aggregationFor(index), out);
+    } else {
+        std::size_t steps = static_cast<std::size_t>(HOUR_SECONDS / stepSeconds);
+        if (index == PRECIPITATION) {
+            holdColumn(in, hours, steps, 1.0 / static_cast<double>(steps), out); // An hourly amount: split evenly.
+        } else if (index == LAST_UPDATED) {
+            holdColumn(in, hours, steps, 1.0, out);
+        } else if (index == WIND_DIRECTION) {
+            linearColumn(in, hours, steps, true, out);
+        } else if (method == Interpolation::SPLINE) {
+            splineColumn(in, hours, steps, out);
+        } else {
+            linearColumn(in, hours, steps, false, out);
+        }
+    }
+    return true;
+}
+
+bool ForecastResampler::resample(const ForecastSeries& input, int stepSeconds, Interpolation method,
+                                 ForecastSeries& output) {
+    if (&input == &output || input.getStepSeconds() != HOUR_SECONDS || !supportsStep(stepSeconds)) { return false; }
+    output.reset(input.getStartEpoch(), stepSeconds, outputRows(input.size(), stepSeconds));
+    for (int i = 0; i < NUM_PROPERTIES; ++i) {
+        PropertyIndex index = static_cast<PropertyIndex>(i);
+        resampleColumn(index, input.column(index), input.size(), stepSeconds, method, output.column(index));
+    }
+    return true;
+}
@@ -0,0 +1,92 @@
+// ForecastResampler.h
+#ifndef FORECASTRESAMPLER_H
+#define FORECASTRESAMPLER_H
+
+#include "Forecast.h" // Source of the hourly values
+#include "Weather.h"  // PropertyIndex, FieldMask
+#include <cstddef>    // For size_t
+#include <vector>     // For the columns
+
+// Values at a fixed time step, stored by column: each property's values are contiguous.
+// Values are in the units of the forecast they came from; NaN marks a missing value.
+// Resetting or reassigning reuses the storage, so a series reused across locations stops
+// allocating once it has held the largest one.
+class ForecastSeries {
+public:
+    ForecastSeries();
+
+    // Reads every hour of 'forecast' (all days, in order), one row per hour from the first
+    // hour to the last; hours missing in between are NaN rows. Only 'fields' are read (the
+    // other columns are NaN). Hours without an epoch are taken as consecutive.
+    void assign(const Forecast& forecast, FieldMask fields = FieldMask::all());
+    // Makes 'count' NaN rows, 'stepSeconds' apart from 'startEpoch'.
+    void reset(long long startEpoch, int stepSeconds, std::size_t count);
+
+    long long getStartEpoch() const { return start; }
+    int getStepSeconds() const { return step; }
+    std::size_t size() const { return count; }
+    // Epoch of row 'row'.
+    long long epochAt(std::size_t row) const { return start + static_cast<long long>(row) * step; }
+
+    // The 'size()' values of a property.
+    const double* column(PropertyIndex index) const { return values.data() + static_cast<std::size_t>(index) * count; }
+    double* column(PropertyIndex index) { return values.data() + static_cast<std::size_t>(index) * count; }
+    double value(std::size_t row, PropertyIndex index) const { return column(index)[row]; }
+
+private:
+    long long start;
+    int step;
+    std::size_t count;
+    std::vector<double> values; // [property * count + row]
+};
+
+// How values between two hours are estimated when upsampling.
+enum class Interpolation {
+    LINEAR, // Straight line between the hours.
+    SPLINE  // Monotone cubic (Fritsch-Carlson): smooth, and never over- or undershoots the hours.
+};
+
+// How the hours in a longer step are combined when downsampling.
+enum class Aggregation {
+    MEAN,          // e.g., temperature.
+    SUM,           // Amounts per hour (precipitation).
+    MAX,           // Peaks (gusts, chance of precipitation, last update).
+    CIRCULAR_MEAN  // Directions in degrees (wind direction).
+};
+
+// Turns an hourly series into a finer one (e.g., 15 or 10 minutes) or a coarser one (e.g.,
+// 3-hour rollups). Each property is resampled according to what it measures:
+// * Upsampling: most values follow the chosen Interpolation; WIND_DIRECTION turns along the
+//   shorter arc; PRECIPITATION (an hourly amount) is split evenly over the hour, so totals are
+//   kept; LAST_UPDATED is held. Rows after the last hour hold its values, so the output
+//   covers every input hour in full.
+// * Downsampling: hours are combined by aggregationFor() in buckets starting at the first
+//   hour (local midnight for API forecasts). Missing hours are skipped; a bucket with none is
+//   NaN.
+// Each column is processed in tight loops without per-value branches (the upsampling loops
+// vectorize). Nothing is allocated beyond the output's own storage.
+class ForecastResampler {
+public:
+    // Shortest output step allowed.
+    static const int MIN_STEP_SECONDS = 60;
+
+    // Returns how 'index' is combined when downsampling.
+    static Aggregation aggregationFor(PropertyIndex index);
+    // Returns true if an hourly series can be resampled to 'stepSeconds': a divisor of an
+    // hour no shorter than MIN_STEP_SECONDS, or a whole number of hours.
+    static bool supportsStep(int stepSeconds);
+    // Rows an hourly series of 'hours' rows becomes at 'stepSeconds' (0 if not supported).
+    static std::size_t outputRows(std::size_t hours, int stepSeconds);
+
+    // Resamples the hourly 'input' (as made by ForecastSeries::assign) into 'output'.
+    // Returns false, leaving 'output' unchanged, if 'input' is not hourly or the step is not
+    // supported.
+    static bool resample(const ForecastSeries& input, int stepSeconds, Interpolation method, ForecastSeries& output);
+
+    // Resamples one hourly column of 'hours' values into 'out', which must hold
+    // outputRows(hours, stepSeconds) values. Returns false if the step is not supported.
+    static bool resampleColumn(PropertyIndex index, const double* in, std::size_t hours, int stepSeconds,
+                               Interpolation method, double* out);
+};
+
+#endif // FORECASTRESAMPLER_H
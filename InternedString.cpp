@@ -0,0 +1,69 @@
+// InternedString.cpp
+#include "InternedString.h"
+#include <functional>    // For std::hash
+#include <mutex>         // For the shard locks
+#include <unordered_set> // For the shards (nodes never move, so handles stay valid)
+
+// --- Helper Functions (Anonymous Namespace) ---
+namespace {
+    // Parsing threads intern at the same time, so the table is split by hash.
+    const std::size_t SHARD_COUNT = 16;
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_set<std::string> strings;
+    };
+
+    // Created on first use (constants in other files intern during static initialization)
+    // and never destroyed, so handles held by other static objects stay valid at exit.
+    Shard* shards() {
+        static Shard* table = new Shard[SHARD_COUNT];
+        return table;
+    }
+
+    const std::string& emptyString() {
+        static const std::string* empty = new std::string();
+        return *empty;
+    }
+} // end anonymous namespace
+
+// --- Constructors ---
+
+InternedString::InternedString() : text(&emptyString()) {}
+
+InternedString::InternedString(const std::string& value) : text(intern(value)) {}
+
+InternedString::InternedString(const char* value) : text(intern(value != nullptr ? std::string(value) : std::string())) {}
+
+// --- Table ---
+
+const std::string* InternedString::intern(const std::string& value) {
+    if (value.empty()) { return &emptyString(); }
+    Shard& shard = shards()[std::hash<std::string>()(value) % SHARD_COUNT];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return &*shard.strings.insert(value).first;
+}
+
+std::size_t InternedString::tableSize() {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < SHARD_COUNT; ++i) {
+        std::lock_guard<std::mutex> lock(shards()[i].mutex);
+        count += shards()[i].strings.size();
+    }
+    return count;
+}
+
+std::size_t InternedString::tableBytes() {
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < SHARD_COUNT; ++i) {
+        const Shard& shard = shards()[i];
+        std::lock_guard<std::mutex> lock(shards()[i].mutex);
+        bytes += shard.strings.bucket_count() * sizeof(void*);
+        for (const auto& s : shard.strings) {
+            // A node holds the string, a next pointer and the cached hash; long text is a second block.
+            bytes += sizeof(std::string) + 2 * sizeof(void*);
+            if (s.capacity() > 15) { bytes += s.capacity() + 1; }
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,54 @@
+// InternedString.h
+#ifndef INTERNEDSTRING_H
+#define INTERNEDSTRING_H
+
+#include <cstddef> // For size_t
+#include <ostream> // For operator<<
+#include <string>  // For the interned text
+
+// Handle to a string stored once in a process-wide table (property names and units, time
+// zone and location names, hour and date labels). Every forecast hour repeats the same few
+// dozen strings, so each handle is one pointer instead of a std::string per value.
+// Handles are as cheap to copy as a pointer, and handles to equal text are the same pointer,
+// so == compares addresses. Interning locks one of several table shards; hot paths intern
+// their strings once (e.g., as constants) and copy the handles. Interned text lives until
+// the process exits. Safe to use from several threads.
+class InternedString {
+  public:
+  // The empty string.
+  InternedString();
+  // Interns 'text' (implicit, so strings and literals can be passed where a handle is expected).
+  InternedString(const std::string& text);
+  InternedString(const char* text);
+
+  // --- Access ---
+  const std::string& str() const { return *text; }
+  operator const std::string&() const { return *text; }
+  const char* c_str() const { return text->c_str(); }
+  bool empty() const { return text->empty(); }
+  std::size_t size() const { return text->size(); }
+
+  friend bool operator==(InternedString a, InternedString b) { return a.text == b.text; }
+  friend bool operator!=(InternedString a, InternedString b) { return a.text != b.text; }
+  // Comparing with a plain string reads the text (without interning the other side).
+  friend bool operator==(InternedString a, const std::string& b) { return *a.text == b; }
+  friend bool operator==(const std::string& a, InternedString b) { return a == *b.text; }
+  friend bool operator!=(InternedString a, const std::string& b) { return *a.text != b; }
+  friend bool operator!=(const std::string& a, InternedString b) { return a != *b.text; }
+  // Orders by text (e.g., "YYYY-MM-DD" dates).
+  friend bool operator<(InternedString a, InternedString b) { return a.text != b.text && *a.text < *b.text; }
+  friend std::ostream& operator<<(std::ostream& os, InternedString s) { return os << *s.text; }
+
+  // --- Table Statistics ---
+  // Number of distinct strings interned so far.
+  static std::size_t tableSize();
+  // Approximate heap used by the table (text, nodes and buckets).
+  static std::size_t tableBytes();
+
+  private:
+  const std::string* text; // Never null; owned by the table.
+
+  static const std::string* intern(const std::string& text);
+};
+
+#endif // INTERNEDSTRING_H
@@ -0,0 +1,142 @@
+// JsonFields.h
+#ifndef JSONFIELDS_H
+#define JSONFIELDS_H
+
+#include "nlohmann/json.hpp" // The objects being read
+#include <cstddef>           // For size_t
+#include <cstdint>           // For the 64-bit key hashes
+#include <cstring>           // For std::memcmp
+#include <string>            // For string values and fallbacks
+
+// Field access for parsed JSON objects. Member names are hashed at compile time; an object's
+// wanted members are then found either all at once, in a single pass over its members
+// (FieldTable::resolve), or one at a time with a single search (FieldTable::find). Both
+// replace the contains() + operator[] pair, which searched each object twice per field.
+namespace JsonFields {
+
+    // FNV-1a hash of the first 'length' characters of 'text' (usable at compile time).
+    constexpr std::uint64_t hashKey(const char* text, std::size_t length) {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (std::size_t i = 0; i < length; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(text[i])) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    constexpr std::size_t keyLength(const char* text) {
+        std::size_t length = 0;
+        while (text[length] != '\0') { ++length; }
+        return length;
+    }
+
+    // A member as found in an object. Missing members, and members of the wrong type, read as
+    // the fallback value.
+    struct FieldValue {
+        const nlohmann::json* node = nullptr; // nullptr if the member is missing.
+
+        bool present() const { return node != nullptr; }
+        double number(double fallback = 0.0) const {
+            if (node == nullptr) { return fallback; }
+            if (const double* value = node->get_ptr<const double*>()) { return *value; }
+            return node->is_number() ? node->get<double>() : fallback;
+        }
+        long long integer(long long fallback = 0) const {
+            return (node != nullptr && node->is_number_integer()) ? node->get<long long>() : fallback;
+        }
+        std::string text(const std::string& fallback = "N/A") const {
+            return (node != nullptr && node->is_string()) ? node->get_ref<const std::string&>() : fallback;
+        }
+        // The member itself, or a shared null value if it is missing.
+        const nlohmann::json& value() const {
+            static const nlohmann::json missing;
+            return (node != nullptr) ? *node : missing;
+        }
+    };
+
+    // Finds a single member by name with one search (no temporary std::string for the name).
+    inline FieldValue find(const nlohmann::json& object, const char* name) {
+        FieldValue value;
+        if (object.is_object()) {
+            auto member = object.find(name);
+            if (member != object.end()) { value.node = &*member; }
+        }
+        return value;
+    }
+
+    // The members of one object found by FieldTable::resolve, indexed like the table's names.
+    template <std::size_t N>
+    struct Fields {
+        FieldValue values[N];
+        const FieldValue& operator[](std::size_t field) const { return values[field]; }
+    };
+
+    // A fixed list of member names, hashed into an open-addressed slot table at compile time:
+    //     constexpr const char* NAMES[] = {"temp_c", "humidity"};
+    //     constexpr auto TABLE = JsonFields::makeTable(NAMES);
+    template <std::size_t N>
+    struct FieldTable {
+        static_assert(N > 0 && N < 128, "A field table holds 1-127 names.");
+        // At least twice as many slots as names keeps probe sequences short.
+        static constexpr std::size_t SLOTS = (N <= 4) ? 8 : (N <= 8) ? 16 : (N <= 16) ? 32 : (N <= 32) ? 64 : 256;
+
+        const char* names[N];
+        std::size_t lengths[N];
+        std::uint64_t hashes[N];
+        unsigned char slots[SLOTS]; // Name index + 1 (0 = empty).
+
+        // Finds every listed member of 'object' in one pass over its members (stopping early
+        // once all are found). Non-objects yield no members.
+        Fields<N> resolve(const nlohmann::json& object) const {
+            Fields<N> found;
+            if (!object.is_object()) { return found; }
+            std::size_t remaining = N;
+            for (const auto& member : object.get_ref<const nlohmann::json::object_t&>()) {
+                const std::string& name = member.first;
+                int field = indexOf(name.data(), name.size());
+                if (field >= 0 && found.values[field].node == nullptr) {
+                    found.values[field].node = &member.second;
+                    if (--remaining == 0) { break; }
+                }
+            }
+            return found;
+        }
+
+        // Finds one listed member with a single search (for reading a few members of a large object).
+        FieldValue find(const nlohmann::json& object, std::size_t field) const {
+            return JsonFields::find(object, names[field]);
+        }
+
+        // Index of 'name' in the table, or -1.
+        int indexOf(const char* name, std::size_t length) const {
+            const std::uint64_t hash = hashKey(name, length);
+            for (std::size_t slot = hash & (SLOTS - 1); slots[slot] != 0; slot = (slot + 1) & (SLOTS - 1)) {
+                std::size_t field = slots[slot] - 1u;
+                if (hashes[field] == hash && lengths[field] == length && std::memcmp(names[field], name, length) == 0) {
+                    return static_cast<int>(field);
+                }
+            }
+            return -1;
+        }
+    };
+
+    template <std::size_t N>
+    constexpr std::size_t FieldTable<N>::SLOTS;
+
+    // Builds the table for 'names' (evaluate into a constexpr variable so no hashing is left for run time).
+    template <std::size_t N>
+    constexpr FieldTable<N> makeTable(const char* const (&names)[N]) {
+        FieldTable<N> table{};
+        for (std::size_t i = 0; i < N; ++i) {
+            table.names[i] = names[i];
+            table.lengths[i] = keyLength(names[i]);
+            table.hashes[i] = hashKey(names[i], table.lengths[i]);
+            std::size_t slot = table.hashes[i] & (FieldTable<N>::SLOTS - 1);
+            while (table.slots[slot] != 0) { slot = (slot + 1) & (FieldTable<N>::SLOTS - 1); }
+            table.slots[slot] = static_cast<unsigned char>(i + 1);
+        }
+        return table;
+    }
+
+} // namespace JsonFields
+
+#endif // JSONFIELDS_H
@@ -0,0 +1,430 @@
+// LiveMode.cpp
+#include "LiveMode.h"
+#include "APIConverter.h"     // Fetches for each view
+#include "CurrentWeatherReport.h" // Report of the current view
+#include "ForecastMerge.h"    // Refreshes applied onto the shown forecast
+#include "TaskScheduler.h"    // Pools used by watchlist refreshes
+#include "TerminalRenderer.h" // Partial redraws
+#include "Metrics.h"          // Render timing
+#include "Trace.h"            // Optional span tracing
+#include <cctype>             // For std::tolower
+#include <csignal>            // For sig_atomic_t
+#include <sstream>            // For building frames
+#include <utility>            // For std::move
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>  // For console input, events and waits
+#else
+#include <cerrno>     // For EINTR, EAGAIN
+#include <fcntl.h>    // For O_NONBLOCK, FD_CLOEXEC
+#include <poll.h>     // For poll
+#include <signal.h>   // For sigaction (SIGWINCH)
+#include <termios.h>  // For non-canonical keyboard input
+#include <unistd.h>   // For read, write, pipe, close, isatty
+#endif
+
+// --- Helper Functions (Anonymous Namespace) ---
+namespace {
+    const char* const VIEW_TITLES[] = {"Current Weather", "Hourly Forecast", "Daily Forecast", "Watchlist"};
+
+    // Set when the terminal is resized; the next repaint redraws everything.
+    volatile std::sig_atomic_t resized = 0;
+
+#ifndef _WIN32
+    int resizeWakeFd = -1; // Write end of the wake-up pipe, for the signal handler.
+
+    void onResize(int) {
+        int savedErrno = errno;
+        resized = 1;
+        if (resizeWakeFd >= 0) {
+            char wake = 2;
+            (void)!write(resizeWakeFd, &wake, 1); // Non-blocking; a full pipe is already awake.
+        }
+        errno = savedErrno;
+    }
+#endif
+
+    // Keys are delivered one at a time, without Enter and without echo, while this is alive.
+    // Does nothing if standard input is not a terminal (e.g., piped commands).
+    class KeyboardMode {
+      public:
+      KeyboardMode() : active(false) {
+#ifdef _WIN32
+          input = GetStdHandle(STD_INPUT_HANDLE);
+          if (GetConsoleMode(input, &saved)) {
+              DWORD mode = (saved & ~static_cast<DWORD>(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT)) | ENABLE_WINDOW_INPUT;
+              active = SetConsoleMode(input, mode) != 0;
+          }
+#else
+          if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &saved) == 0) {
+              termios raw = saved;
+              raw.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO); // Ctrl+C still interrupts.
+              raw.c_cc[VMIN] = 1;
+              raw.c_cc[VTIME] = 0;
+              active = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+          }
+#endif
+      }
+      ~KeyboardMode() {
+          if (!active) { return; }
+#ifdef _WIN32
+          SetConsoleMode(input, saved);
+#else
+          tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+#endif
+      }
+      KeyboardMode(const KeyboardMode&) = delete;
+      KeyboardMode& operator=(const KeyboardMode&) = delete;
+
+      private:
+      bool active;
+#ifdef _WIN32
+      HANDLE input;
+      DWORD saved;
+#else
+      termios saved;
+#endif
+    };
+
+    // Makes 'fd' non-blocking and not inherited by child processes.
+#ifndef _WIN32
+    void configurePipeEnd(int fd) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+#endif
+} // end anonymous namespace
+
+// --- Constructor / Destructor ---
+
+LiveMode::LiveMode(APIConverter& converter, TerminalRenderer& renderer)
+    : api(converter), terminal(renderer), visible(View::DASHBOARD), watchlistEmpty(true), forecastDays(1),
+      alerts(nullptr), pending(0), interactive(0), stopping(false) {
+#ifdef _WIN32
+    wakeEvent = CreateEventA(nullptr, FALSE, FALSE, nullptr); // Auto-reset.
+#else
+    wakePipe[0] = wakePipe[1] = -1;
+    if (pipe(wakePipe) == 0) {
+        configurePipeEnd(wakePipe[0]);
+        configurePipeEnd(wakePipe[1]);
+    }
+#endif
+}
+
+LiveMode::~LiveMode() {
+#ifdef _WIN32
+    if (wakeEvent != nullptr) { CloseHandle(static_cast<HANDLE>(wakeEvent)); }
+#else
+    for (int fd : wakePipe) {
+        if (fd >= 0) { close(fd); }
+    }
+#endif
+}
+
+void LiveMode::setAlerts(AlertEngine* engine) {
+    alerts = engine;
+    watchlist.setAlerts(engine, &alertLog);
+}
+
+// --- Fetch Thread ---
+
+void LiveMode::request(View view, RequestPriority priority) {
+    const unsigned bit = 1u << static_cast<int>(view);
+    ViewState& state = views[static_cast<int>(view)];
+    if (state.fetching) { return; }
+    state.fetching = true;
+    pending |= bit;
+    if (priority == RequestPriority::INTERACTIVE) { interactive |= bit; }
+    requestReady.notify_one();
+}
+
+void LiveMode::fetchLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        requestReady.wait(lock, [this] { return stopping || pending != 0; });
+        if (stopping) { return; }
+        // Views the user is waiting for go before timed refreshes.
+        const unsigned candidates = (interactive != 0) ? interactive : pending;
+        int index = 0;
+        while ((candidates & (1u << index)) == 0) { ++index; }
+        const unsigned bit = 1u << index;
+        const RequestPriority priority = (interactive & bit) ? RequestPriority::INTERACTIVE : RequestPriority::BACKGROUND;
+        pending &= ~bit;
+        interactive &= ~bit;
+        const std::shared_ptr<const WeatherReport> previous = views[index].report;
+
+        lock.unlock();
+        std::shared_ptr<const WeatherReport> report = fetch(static_cast<View>(index), priority, previous);
+        lock.lock();
+
+        ViewState& state = views[index];
+        state.fetching = false;
+        state.attempted = true;
+        state.finishedAt = std::chrono::steady_clock::now();
+        state.failed = !report;
+        if (report) {
+            state.report = std::move(report);
+            state.updatedAt = std::time(nullptr);
+        }
+        wake();
+    }
+}
+
+std::shared_ptr<const WeatherReport> LiveMode::fetch(View view, RequestPriority priority,
+                                                     const std::shared_ptr<const WeatherReport>& previous) {
+    TRACE_SCOPE("LiveMode::fetch", "api");
+    const WeatherQuery fetchQuery = query->withPriority(priority);
+    switch (view) {
+        case View::CURRENT:
+            return api.getCurrentWeather(fetchQuery);
+        case View::HOURLY:
+        case View::DAILY: {
+            const ForecastReport::DetailLevel level =
+                (view == View::HOURLY) ? ForecastReport::DetailLevel::HOURLY : ForecastReport::DetailLevel::DAILY;
+            std::unique_ptr<ForecastReport> fresh = api.getForecastReport(fetchQuery.withLazyDecoding(), forecastDays, level);
+            if (!fresh) { return nullptr; }
+            const long long nowEpoch = static_cast<long long>(std::time(nullptr));
+            const bool checkAlerts = alerts != nullptr && !alerts->getRules().empty();
+
+            // Kept reports are for the same location, units and days (see run()).
+            const auto* shown = dynamic_cast<const ForecastReport*>(previous.get());
+            if (shown == nullptr) {
+                if (checkAlerts) { alerts->evaluate(query->getLocation(), fresh->getForecast(), nowEpoch, alertLog); }
+                return std::shared_ptr<const WeatherReport>(std::move(fresh));
+            }
+            // The shown report may still be drawn, so the merge goes into a copy that is then
+            // published; alerts re-check only what the merge changed.
+            Forecast merged = shown->getForecast();
+            ForecastChangeSet changes = ForecastMerge::merge(merged, fresh->takeForecast(), nowEpoch);
+            if (checkAlerts) { alerts->evaluateChanges(query->getLocation(), merged, changes, nowEpoch, alertLog); }
+            return std::make_shared<const ForecastReport>(std::move(merged), level);
+        }
+        case View::DASHBOARD:
+            // Only out-of-date entries are fetched; the others keep their forecasts.
+            watchlist.refresh(api, fetchQuery, *scheduler);
+            return watchlist.buildReport(static_cast<long long>(std::time(nullptr)));
+    }
+    return nullptr;
+}
+
+// --- Event Loop ---
+
+void LiveMode::wake() {
+#ifdef _WIN32
+    if (wakeEvent != nullptr) { SetEvent(static_cast<HANDLE>(wakeEvent)); }
+#else
+    if (wakePipe[1] >= 0) {
+        char wake = 1;
+        (void)!write(wakePipe[1], &wake, 1);
+    }
+#endif
+}
+
+bool LiveMode::waitForEvents(int timeoutMs, std::string& keys, bool& woken) {
+#ifdef _WIN32
+    HANDLE handles[2] = {static_cast<HANDLE>(wakeEvent), GetStdHandle(STD_INPUT_HANDLE)};
+    DWORD result = WaitForMultipleObjects(2, handles, FALSE, timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs));
+    if (result == WAIT_OBJECT_0) {
+        woken = true;
+    } else if (result == WAIT_OBJECT_0 + 1) {
+        INPUT_RECORD records[32];
+        DWORD count = 0;
+        if (!ReadConsoleInputA(handles[1], records, 32, &count)) { return false; } // Not a console.
+        for (DWORD i = 0; i < count; ++i) {
+            if (records[i].EventType == KEY_EVENT && records[i].Event.KeyEvent.bKeyDown
+                && records[i].Event.KeyEvent.uChar.AsciiChar != 0) {
+                keys += records[i].Event.KeyEvent.uChar.AsciiChar;
+            } else if (records[i].EventType == WINDOW_BUFFER_SIZE_EVENT) {
+                resized = 1;
+            }
+        }
+    } else if (result == WAIT_FAILED) {
+        return false;
+    }
+    return true;
+#else
+    pollfd fds[2] = {{STDIN_FILENO, POLLIN, 0}, {wakePipe[0], POLLIN, 0}};
+    if (poll(fds, 2, timeoutMs) <= 0) { return true; } // Timeout, or EINTR (e.g., SIGWINCH).
+    if (fds[1].revents & POLLIN) {
+        woken = true;
+        char drain[64];
+        while (read(wakePipe[0], drain, sizeof(drain)) > 0) {}
+    }
+    if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+        char buffer[64];
+        ssize_t n = read(STDIN_FILENO, buffer, sizeof(buffer));
+        if (n == 0) { return false; } // End of input.
+        if (n < 0) { return errno == EINTR || errno == EAGAIN; }
+        keys.append(buffer, static_cast<std::size_t>(n));
+    }
+    return true;
+#endif
+}
+
+std::string LiveMode::buildFrame(const WeatherQuery& shownQuery, std::chrono::seconds refreshInterval) {
+    ViewState state;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        state = views[static_cast<int>(visible)];
+    }
+    std::ostringstream frame;
+    frame << "=== Live Weather: " << shownQuery.getLocation() << " (" << shownQuery.getUnits() << ") ===\n"
+          << "[c] Current  [h] Hourly  [d] Daily  [w] Watchlist  [r] Refresh  [q] Menu\n"
+          << VIEW_TITLES[static_cast<int>(visible)];
+    if (state.updatedAt != 0) {
+        char clock[16];
+        std::strftime(clock, sizeof(clock), "%H:%M:%S", std::localtime(&state.updatedAt));
+        frame << " | updated " << clock;
+    }
+    frame << " | every " << refreshInterval.count() << " s";
+    if (state.fetching) {
+        frame << " | refreshing...";
+    } else if (state.failed) {
+        frame << " | last refresh failed";
+    }
+    frame << '\n';
+
+    if (visible == View::DASHBOARD && watchlistEmpty) {
+        frame << "\nThe watchlist is empty. Add locations with option 9 of the menu.\n";
+    } else if (state.report) {
+        frame << *state.report;
+    } else if (state.fetching) {
+        frame << "\nLoading...\n";
+    } else {
+        frame << "\nNo data. Check the API key, location and network connection, then press r.\n";
+    }
+
+    std::vector<std::string> alertLines = alertLog.getLines();
+    if (!alertLines.empty()) {
+        frame << "\nAlerts:\n";
+        for (const auto& line : alertLines) { frame << "  " << line << '\n'; }
+    }
+    return frame.str();
+}
+
+void LiveMode::run(const WeatherQuery& shownQuery, int days, const std::vector<std::string>& watchlistLocations,
+                   std::chrono::seconds refreshInterval, std::shared_ptr<TaskScheduler> pools) {
+    // The fetch thread is not running here, so the state needs no lock until it starts.
+    // Kept reports are only reused for the same data.
+    std::string key = shownQuery.getLocation() + '\n' + shownQuery.getUnits() + '\n' + std::to_string(days);
+    if (key != dataKey) {
+        for (auto& state : views) { state = ViewState(); }
+        watchlist.clear();
+        alertLog.clear();
+        dataKey = std::move(key);
+    }
+    query.reset(new WeatherQuery(shownQuery));
+    forecastDays = days;
+    scheduler = std::move(pools);
+    watchlist.setMaxAge(refreshInterval);
+    watchlist.setLocations(watchlistLocations);
+    watchlistEmpty = watchlistLocations.empty();
+    if (visible == View::DASHBOARD && watchlistEmpty) { visible = View::CURRENT; }
+    stopping = false;
+    fetchThread = std::thread(&LiveMode::fetchLoop, this);
+
+#ifndef _WIN32
+    struct sigaction onResizeAction, previousAction;
+    onResizeAction.sa_handler = onResize;
+    sigemptyset(&onResizeAction.sa_mask);
+    onResizeAction.sa_flags = 0;
+    resizeWakeFd = wakePipe[1];
+    sigaction(SIGWINCH, &onResizeAction, &previousAction);
+#endif
+    {
+        KeyboardMode keyboard;
+        terminal.invalidate(); // The menu and prompts are on screen.
+        bool quit = false;
+        std::string keys;
+
+        // Due if never fetched, or fetched at least 'refreshInterval' ago. Caller holds 'mutex'.
+        auto isDue = [&](View view, std::chrono::steady_clock::time_point now) {
+            const ViewState& state = views[static_cast<int>(view)];
+            return !state.fetching && !(view == View::DASHBOARD && watchlistEmpty)
+                && (!state.attempted || now - state.finishedAt >= refreshInterval);
+        };
+
+        while (!quit) {
+            // Refresh the visible view when it is due; otherwise sleep until it will be.
+            int timeoutMs = -1;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                const ViewState& state = views[static_cast<int>(visible)];
+                auto now = std::chrono::steady_clock::now();
+                if (isDue(visible, now)) {
+                    request(visible, state.attempted ? RequestPriority::BACKGROUND : RequestPriority::INTERACTIVE);
+                } else if (!state.fetching && !(visible == View::DASHBOARD && watchlistEmpty)) {
+                    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(state.finishedAt + refreshInterval - now);
+                    timeoutMs = static_cast<int>(wait.count()) + 1; // Round up, so it is due on waking.
+                }
+            }
+
+            if (resized) {
+                resized = 0;
+                terminal.invalidate();
+            }
+            {
+                ScopedTimer renderTimer(MetricStage::RENDER);
+                terminal.present(buildFrame(shownQuery, refreshInterval));
+            }
+
+            bool woken = false;
+            keys.clear();
+            if (!waitForEvents(timeoutMs, keys, woken)) { break; }
+            // Fetches may print warnings over the screen, so new data is drawn in full.
+            if (woken) { terminal.invalidate(); }
+
+            for (std::size_t i = 0; i < keys.size() && !quit; ++i) {
+                View next = visible;
+                switch (std::tolower(static_cast<unsigned char>(keys[i]))) {
+                    case 'c': next = View::CURRENT; break;
+                    case 'h': next = View::HOURLY; break;
+                    case 'd': next = View::DAILY; break;
+                    case 'w': next = View::DASHBOARD; break;
+                    case 'r': {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!(visible == View::DASHBOARD && watchlistEmpty)) { request(visible, RequestPriority::INTERACTIVE); }
+                        break;
+                    }
+                    case 'q':
+                        quit = true;
+                        break;
+                    case '\033':
+                        // Esc alone quits; longer escape sequences (arrow keys, ...) are ignored.
+                        quit = (i + 1 == keys.size());
+                        i = keys.size();
+                        break;
+                    default:
+                        break;
+                }
+                if (next != visible) {
+                    // Shown at once from memory; refreshed first if it is out of date.
+                    visible = next;
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (isDue(visible, std::chrono::steady_clock::now())) { request(visible, RequestPriority::INTERACTIVE); }
+                }
+            }
+        }
+    }
+#ifndef _WIN32
+    sigaction(SIGWINCH, &previousAction, nullptr);
+    resizeWakeFd = -1;
+#endif
+
+    // Drop queued fetches and wait for the one in flight.
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        for (int index = 0; index < VIEW_COUNT; ++index) {
+            if (pending & (1u << index)) { views[index].fetching = false; }
+        }
+        pending = interactive = 0;
+    }
+    requestReady.notify_all();
+    fetchThread.join();
+    scheduler.reset();
+    terminal.invalidate();
+}
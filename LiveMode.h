@@ -0,0 +1,116 @@
+// LiveMode.h
+#ifndef LIVEMODE_H
+#define LIVEMODE_H
+
+#include "AlertEngine.h"        // Alerts for refreshed forecasts
+#include "Watchlist.h"          // Locations shown on the live dashboard
+#include "WeatherQuery.h"       // Request parameters for every refresh
+#include "WeatherReport.h"      // Reports shown by each view
+#include <chrono>               // For refresh intervals and fetch times
+#include <condition_variable>   // For waking the fetch thread
+#include <ctime>                // For the wall-clock time of each update
+#include <memory>               // For std::shared_ptr, std::unique_ptr
+#include <mutex>                // For the view states shared with the fetch thread
+#include <string>               // For keys and the data key
+#include <thread>               // For the fetch thread
+#include <vector>               // For watchlist locations
+
+class APIConverter;
+class TaskScheduler;
+class TerminalRenderer;
+
+// Auto-refreshing full-screen view, driven by an event loop instead of blocking prompts.
+// One thread waits (poll on Linux/macOS) on three things: single key presses (the terminal is
+// put in non-canonical mode, so keys arrive without Enter), a self-pipe written when a
+// background fetch finishes, and the next refresh deadline as the wait's timeout. Nothing runs
+// between events, so an idle screen uses no CPU. Fetches run on a separate thread; each view
+// keeps its last report, so switching views repaints at once from memory and refreshes
+// behind it. Repaints go through TerminalRenderer, which rewrites only the changed lines.
+// Hourly and daily refreshes are merged into the forecast already shown (see ForecastMerge).
+// With alerts set, refreshed forecasts (hourly, daily and watchlist) are checked against the
+// rules, and the latest events are shown below every view.
+//
+// Keys: c current, h hourly, d daily, w watchlist, r refresh now, q (or Esc) back to the menu.
+class LiveMode {
+  public:
+  enum class View { CURRENT, HOURLY, DAILY, DASHBOARD };
+
+  LiveMode(APIConverter& api, TerminalRenderer& terminal);
+  ~LiveMode();
+
+  LiveMode(const LiveMode&) = delete;
+  LiveMode& operator=(const LiveMode&) = delete;
+
+  // Shows the live screen until the user quits (or input ends), refreshing the visible view
+  // every 'refreshInterval'. Reports kept from an earlier run for the same location, units
+  // and days are shown straight away. Returns once no fetch is in flight (the converter's
+  // settings may be changed afterwards).
+  void run(const WeatherQuery& query, int forecastDays, const std::vector<std::string>& watchlistLocations,
+           std::chrono::seconds refreshInterval, std::shared_ptr<TaskScheduler> scheduler);
+  // Sets the memory budget and eviction policy of the live dashboard's forecast cache.
+  // Call while not running.
+  void setCacheLimits(std::size_t budgetBytes, EvictionPolicy policy) { watchlist.setCacheLimits(budgetBytes, policy); }
+  // Checks refreshed forecasts against 'engine''s rules (nullptr: no alerts). 'engine' must
+  // stay valid while running. Call while not running.
+  void setAlerts(AlertEngine* engine);
+
+  private:
+  static const int VIEW_COUNT = 4;
+
+  // What is known about one view. Guarded by 'mutex'.
+  struct ViewState {
+      std::shared_ptr<const WeatherReport> report;     // Last successful fetch (nullptr: none yet).
+      std::chrono::steady_clock::time_point finishedAt; // When the last fetch ended (success or not).
+      std::time_t updatedAt = 0;                        // Wall-clock time of the last success.
+      bool attempted = false;                           // A fetch has ended at least once.
+      bool fetching = false;                            // Queued or in flight.
+      bool failed = false;                              // The last fetch failed.
+  };
+
+  APIConverter& api;
+  TerminalRenderer& terminal;
+  View visible;
+  std::string dataKey;    // Location, units and days the kept reports were fetched for.
+  bool watchlistEmpty;    // The dashboard has nothing to fetch.
+
+  // --- Fetch Thread State (set by run() before the thread starts) ---
+  std::unique_ptr<WeatherQuery> query;
+  int forecastDays;
+  std::shared_ptr<TaskScheduler> scheduler;
+  Watchlist watchlist;    // Only used by the fetch thread while it runs.
+  AlertEngine* alerts;    // See setAlerts (nullptr: no alerts).
+  RecentAlertSink alertLog; // Latest alert events, shown below the view (thread-safe).
+
+  std::mutex mutex;                       // Guards everything below.
+  std::condition_variable requestReady;   // Signalled when a fetch is requested or on stop.
+  ViewState views[VIEW_COUNT];
+  unsigned pending;                       // Bit per view waiting to be fetched.
+  unsigned interactive;                   // Pending views the user asked for (fetched first).
+  bool stopping;
+  std::thread fetchThread;
+
+  // --- Wake-up Channel (fetch thread and resize signal -> event loop) ---
+#ifdef _WIN32
+  void* wakeEvent;
+#else
+  int wakePipe[2];
+#endif
+
+  // Queues a fetch of 'view' unless one is already queued or running. Caller holds 'mutex'.
+  void request(View view, RequestPriority priority);
+  // Fetch thread: takes requested views (user requests first) and fetches them one at a time.
+  void fetchLoop();
+  // Fetches one view's report (nullptr on failure). 'previous' is the view's current report;
+  // a forecast view merges the fetched forecast into a copy of it.
+  std::shared_ptr<const WeatherReport> fetch(View view, RequestPriority priority,
+                                             const std::shared_ptr<const WeatherReport>& previous);
+  // Wakes the event loop.
+  void wake();
+  // Waits up to 'timeoutMs' (-1 = no limit) for keys or a wake-up. Appends keys typed to 'keys'
+  // and sets 'woken' if the wake-up channel fired. Returns false when input has ended.
+  bool waitForEvents(int timeoutMs, std::string& keys, bool& woken);
+  // Builds the screen for the visible view.
+  std::string buildFrame(const WeatherQuery& shownQuery, std::chrono::seconds refreshInterval);
+};
+
+#endif // LIVEMODE_H
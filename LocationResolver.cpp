@@ -0,0 +1,169 @@
+// LocationResolver.cpp
+#include "LocationResolver.h"
+#include "Metrics.h" // Counts queries answered by a known site
+#include <algorithm> // For std::max, std::min
+#include <cctype>    // For std::tolower, std::isspace
+#include <cmath>     // For rounding and log10
+#include <cstdio>    // For std::snprintf
+#include <cstdlib>   // For std::strtod
+
+// --- Internal Helper Functions (Anonymous Namespace) ---
+namespace {
+    // Distance within which a response's coordinates are taken to be an already known site
+    // when reuse is off (the same point, allowing for rounding).
+    const double SAME_SITE_KM = 0.05;
+    // Sites kept at most; later responses are still served, just not learned.
+    const std::size_t MAX_SITES = 100000;
+    // Cell size of the spatial index (about the largest useful reuse radius).
+    const double INDEX_CELL_DEGREES = 0.1;
+
+    // Lowercases, drops spaces around commas and collapses other runs of whitespace,
+    // so "  Toronto ,  ON" and "toronto,on" compare equal.
+    std::string normalize(const std::string& text) {
+        std::string result;
+        result.reserve(text.size());
+        bool pendingSpace = false;
+        for (char c : text) {
+            unsigned char u = static_cast<unsigned char>(c);
+            if (std::isspace(u)) {
+                pendingSpace = true;
+                continue;
+            }
+            if (c == ',') {
+                result += ',';
+                pendingSpace = false;
+                continue;
+            }
+            if (pendingSpace && !result.empty() && result.back() != ',') { result += ' '; }
+            pendingSpace = false;
+            result += static_cast<char>(std::tolower(u));
+        }
+        return result;
+    }
+
+    // Removes leading and trailing whitespace.
+    std::string trimmed(const std::string& text) {
+        std::size_t first = text.find_first_not_of(" \t\n\r\f\v");
+        if (first == std::string::npos) { return std::string(); }
+        std::size_t last = text.find_last_not_of(" \t\n\r\f\v");
+        return text.substr(first, last - first + 1);
+    }
+
+    const char* skipSpaces(const char* p) {
+        while (*p != '\0' && std::isspace(static_cast<unsigned char>(*p))) { ++p; }
+        return p;
+    }
+} // end anonymous namespace
+
+// --- Constructor and Configuration ---
+
+LocationResolver::LocationResolver(double gridDegrees, double radiusKm)
+    : grid(gridDegrees > 0.0 ? gridDegrees : 0.0), radius(radiusKm > 0.0 ? radiusKm : 0.0), index(INDEX_CELL_DEGREES) {}
+
+void LocationResolver::setGrid(double gridDegrees) {
+    std::lock_guard<std::mutex> lock(mutex);
+    grid = (gridDegrees > 0.0) ? gridDegrees : 0.0;
+}
+
+void LocationResolver::setRadius(double radiusKm) {
+    std::lock_guard<std::mutex> lock(mutex);
+    radius = (radiusKm > 0.0) ? radiusKm : 0.0;
+}
+
+std::size_t LocationResolver::siteCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return sites.size();
+}
+
+void LocationResolver::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    sites.clear();
+    index.clear();
+    aliases.clear();
+}
+
+// --- Coordinates ---
+
+bool LocationResolver::parseCoordinates(const std::string& text, double& latitude, double& longitude) {
+    const char* p = skipSpaces(text.c_str());
+    char* end = nullptr;
+    double lat = std::strtod(p, &end);
+    if (end == p) { return false; }
+    p = skipSpaces(end);
+    if (*p != ',') { return false; }
+    p = skipSpaces(p + 1);
+    double lon = std::strtod(p, &end);
+    if (end == p || *skipSpaces(end) != '\0') { return false; }
+    if (!std::isfinite(lat) || !std::isfinite(lon) || std::fabs(lat) > 90.0 || std::fabs(lon) > 180.0) { return false; }
+    latitude = lat;
+    longitude = lon;
+    return true;
+}
+
+std::string LocationResolver::formatCoordinates(double latitude, double longitude) const {
+    int decimals = static_cast<int>(std::ceil(-std::log10(grid) - 1e-9));
+    decimals = std::max(0, std::min(6, decimals));
+    double smallest = 0.5 * std::pow(10.0, -decimals);
+    if (std::fabs(latitude) < smallest) { latitude = 0.0; }   // No "-0.00".
+    if (std::fabs(longitude) < smallest) { longitude = 0.0; }
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%.*f,%.*f", decimals, latitude, decimals, longitude);
+    return buffer;
+}
+
+// --- Resolution ---
+
+std::string LocationResolver::resolve(const std::string& query) {
+    std::string typed = trimmed(query);
+    double latitude = 0.0, longitude = 0.0;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (parseCoordinates(typed, latitude, longitude)) {
+        if (radius > 0.0) {
+            std::vector<SpatialIndex::Neighbor> near = index.nearest(latitude, longitude, 1, radius);
+            if (!near.empty()) {
+                Metrics::increment(MetricCounter::LOCATION_REUSES);
+                return sites[near.front().id].query;
+            }
+        }
+        if (grid <= 0.0) { return typed; }
+        latitude = std::max(-90.0, std::min(90.0, std::round(latitude / grid) * grid));
+        longitude = std::round(longitude / grid) * grid;
+        if (longitude >= 180.0) { longitude -= 360.0; } // 180 and -180 are the same meridian.
+        return formatCoordinates(latitude, longitude);
+    }
+
+    auto alias = aliases.find(normalize(typed));
+    if (alias == aliases.end()) { return typed; }
+    const std::string& known = sites[alias->second].query;
+    if (known != typed) { Metrics::increment(MetricCounter::LOCATION_REUSES); }
+    return known;
+}
+
+void LocationResolver::learn(const std::string& upstreamQuery, const LocationInfo& location) {
+    if (!location.hasCoordinates) { return; }
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // The same place as a known site (within the reuse radius), or a new one.
+    std::size_t id;
+    std::vector<SpatialIndex::Neighbor> near =
+        index.nearest(location.latitude, location.longitude, 1, std::max(radius, SAME_SITE_KM));
+    if (!near.empty()) {
+        id = near.front().id;
+    } else {
+        if (sites.size() >= MAX_SITES) { return; }
+        id = sites.size();
+        sites.push_back(Site{trimmed(upstreamQuery), location.latitude, location.longitude});
+        index.insert(id, location.latitude, location.longitude);
+    }
+
+    // Names that lead here. Existing aliases are kept, so a site's first query stays canonical.
+    aliases.emplace(normalize(upstreamQuery), id);
+    const std::string& name = location.name;
+    if (name.empty()) { return; }
+    const std::string& region = location.region;
+    const std::string& country = location.country;
+    if (!region.empty()) { aliases.emplace(normalize(name + "," + region), id); }
+    if (!country.empty()) { aliases.emplace(normalize(name + "," + country), id); }
+    if (!region.empty() && !country.empty()) { aliases.emplace(normalize(name + "," + region + "," + country), id); }
+}
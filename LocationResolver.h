@@ -0,0 +1,65 @@
+// LocationResolver.h
+#ifndef LOCATIONRESOLVER_H
+#define LOCATIONRESOLVER_H
+
+#include "SpatialIndex.h" // Nearest known site lookup
+#include "TimeFormat.h"   // LocationInfo (the "location" block of a response)
+#include <cstddef>        // For size_t
+#include <mutex>          // For guarding the sites
+#include <string>         // For queries
+#include <unordered_map>  // For name aliases
+#include <vector>         // For the sites
+
+// Maps the location a user typed to the location sent upstream, so that queries for the same
+// place become the same request (and so share the response cache):
+// * "lat,lon" queries are snapped to a grid ('gridDegrees'), then answered by the nearest
+//   known site within 'radiusKm', if any.
+// * Names are compared case- and space-insensitively, and are also matched against the
+//   names responses gave for known sites ("Toronto, Ontario", "Toronto, Canada").
+// A site is learned from each successful response: its coordinates and names, and the
+// location string that fetched it, which later queries for the site reuse. A bare place name
+// is only an alias when it was itself the query (names like "London" are ambiguous).
+// Safe to use from several threads.
+class LocationResolver {
+  public:
+  // 'gridDegrees': snapping cell (0 = keep coordinates as typed).
+  // 'radiusKm': how far a coordinate query may be from a known site to reuse it (0 = never).
+  explicit LocationResolver(double gridDegrees = 0.01, double radiusKm = 2.0);
+
+  // Changes the grid or radius (e.g., on a settings reload). Known sites are kept.
+  void setGrid(double gridDegrees);
+  void setRadius(double radiusKm);
+
+  // Returns the location string to request for 'query'.
+  std::string resolve(const std::string& query);
+  // Records that requesting 'upstreamQuery' returned 'location'.
+  void learn(const std::string& upstreamQuery, const LocationInfo& location);
+
+  // Number of known sites.
+  std::size_t siteCount() const;
+  // Forgets every site.
+  void clear();
+
+  // Reads "lat,lon" (spaces allowed). Returns false for anything else.
+  static bool parseCoordinates(const std::string& text, double& latitude, double& longitude);
+
+  private:
+  // A place a response has been received for.
+  struct Site {
+      std::string query; // Location string that fetched it (sent again for this site).
+      double latitude;
+      double longitude;
+  };
+
+  double grid;
+  double radius;
+  std::vector<Site> sites;                              // Index = id in 'index'.
+  SpatialIndex index;
+  std::unordered_map<std::string, std::size_t> aliases; // Normalized name -> site.
+  mutable std::mutex mutex;                             // Guards everything above.
+
+  // Formats snapped coordinates with as many decimals as the grid needs.
+  std::string formatCoordinates(double latitude, double longitude) const;
+};
+
+#endif // LOCATIONRESOLVER_H
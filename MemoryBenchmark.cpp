@@ -0,0 +1,176 @@
+// MemoryBenchmark.cpp - Measures the heap held by a large in-memory forecast working set
+#include "APIConverter.h"      // parseForecastReport
+#include "ForecastReport.h"    // The reports kept in memory
+#include "InternedString.h"    // String table statistics
+#include "MockWeatherServer.h" // Synthetic forecast payloads
+#include "Property.h"          // Name/unit accessors
+#include "WeatherQuery.h"      // Units for parsing
+
+#include <atomic>    // For the allocation counters
+#include <chrono>    // For timing
+#include <cstdlib>   // For malloc, free, atoi
+#include <iomanip>   // For table formatting
+#include <iostream>  // For console output (cout, cerr)
+#include <memory>    // For std::unique_ptr
+#include <new>       // For std::bad_alloc
+#include <string>    // For payloads and argument parsing
+#include <vector>    // For the working set
+
+// --- Heap Accounting ---
+// Every allocation in this program goes through these, so the heap held by the working set
+// can be read as the difference of two counter snapshots. Each block carries a small header
+// with its size; the counters hold the sizes requested (without the header or malloc overhead).
+namespace {
+    std::atomic<long long> liveBytes(0);
+    std::atomic<long long> liveBlocks(0);
+    std::atomic<long long> totalBlocks(0);
+
+    const std::size_t HEADER_BYTES = 16; // Keeps the returned pointer 16-byte aligned.
+
+    void* countedAlloc(std::size_t size) {
+        void* block = std::malloc(size + HEADER_BYTES);
+        if (block == nullptr) { throw std::bad_alloc(); }
+        *static_cast<std::size_t*>(block) = size;
+        liveBytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+        liveBlocks.fetch_add(1, std::memory_order_relaxed);
+        totalBlocks.fetch_add(1, std::memory_order_relaxed);
+        return static_cast<char*>(block) + HEADER_BYTES;
+    }
+
+    void countedFree(void* pointer) {
+        if (pointer == nullptr) { return; }
+        void* block = static_cast<char*>(pointer) - HEADER_BYTES;
+        liveBytes.fetch_sub(static_cast<long long>(*static_cast<std::size_t*>(block)), std::memory_order_relaxed);
+        liveBlocks.fetch_sub(1, std::memory_order_relaxed);
+        std::free(block);
+    }
+} // end anonymous namespace
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* pointer) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { countedFree(pointer); }
+
+namespace {
+    // Benchmark settings (overridable from the command line).
+    struct BenchmarkConfig {
+        int locations = 500; // Forecasts kept in memory at once.
+        int days = 14;       // Days per forecast (24 hours each).
+        int passes = 5;      // Passes over every property for the accessor timing.
+    };
+
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "  --locations N  Forecasts kept in memory (default 500)\n"
+                  << "  --days N       Days per forecast (default 14)\n"
+                  << "  --passes N     Passes over every property for the accessor timing (default 5)\n";
+    }
+
+    double megabytes(long long bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); }
+} // end anonymous namespace
+
+int main(int argc, char* argv[]) {
+    BenchmarkConfig config;
+
+    // --- Argument Parsing ---
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for option '" << arg << "'." << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "--locations")   { config.locations = std::atoi(value); }
+        else if (arg == "--days")   { config.days = std::atoi(value); }
+        else if (arg == "--passes") { config.passes = std::atoi(value); }
+        else {
+            std::cerr << "Error: Unknown option '" << arg << "'." << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.locations < 1 || config.days < 1 || config.days > 14 || config.passes < 1) {
+        std::cerr << "Error: --locations and --passes must be positive; --days must be 1-14." << std::endl;
+        return 1;
+    }
+
+    // --- Working Set (every property decoded up front) ---
+    const WeatherQuery query("bench", "bench", "Metric");
+    std::vector<std::unique_ptr<ForecastReport>> forecasts;
+    forecasts.reserve(static_cast<std::size_t>(config.locations));
+    const long long bytesBefore = liveBytes.load();
+    const long long blocksBefore = liveBlocks.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < config.locations; ++i) {
+        // Each payload is dropped once parsed, so only the forecasts stay on the heap.
+        const std::string body = MockWeatherServer::makeForecastJson("Site " + std::to_string(i), config.days,
+                                                                      1700000000, 42u + static_cast<unsigned>(i));
+        forecasts.push_back(APIConverter::parseForecastReport(body, query, ForecastReport::DetailLevel::HOURLY));
+        if (!forecasts.back()) {
+            std::cerr << "Error: Forecast failed to parse." << std::endl;
+            return 1;
+        }
+    }
+    double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const long long workingBytes = liveBytes.load() - bytesBefore;
+    const long long workingBlocks = liveBlocks.load() - blocksBefore;
+
+    long long hours = 0, properties = 0;
+    std::size_t accountedBytes = 0; // What the reports say they hold (the caches' charge).
+    for (const auto& report : forecasts) {
+        accountedBytes += report->sizeBytes();
+        for (const auto& day : report->getForecast().getDailyForecasts()) {
+            for (const auto& hour : day.getHourlyForecasts()) {
+                ++hours;
+                for (int index = 0; index < NUM_PROPERTIES; ++index) {
+                    if (hour.getWeather().getProperty(static_cast<PropertyIndex>(index)) != nullptr) { ++properties; }
+                }
+            }
+        }
+    }
+
+    std::cout << config.locations << " locations x " << config.days << " days (" << hours << " hours, "
+              << properties << " hourly properties), built in " << std::fixed << std::setprecision(2)
+              << buildSeconds << " s\n" << std::endl;
+    std::cout << std::left << std::setw(30) << "Heap held by the forecasts" << std::right
+              << std::setw(12) << std::setprecision(1) << megabytes(workingBytes) << " MiB\n"
+              << std::left << std::setw(30) << "ForecastReport::sizeBytes" << std::right
+              << std::setw(12) << megabytes(static_cast<long long>(accountedBytes)) << " MiB\n"
+              << std::left << std::setw(30) << "Heap blocks" << std::right << std::setw(12) << workingBlocks << "\n"
+              << std::left << std::setw(30) << "Bytes per hour" << std::right
+              << std::setw(12) << std::setprecision(0) << static_cast<double>(workingBytes) / hours << "\n"
+              << std::left << std::setw(30) << "sizeof(Property)" << std::right << std::setw(12) << sizeof(Property) << "\n"
+              << std::left << std::setw(30) << "Interned strings" << std::right << std::setw(12) << InternedString::tableSize()
+              << " (" << InternedString::tableBytes() << " bytes)" << std::endl;
+
+    // --- Accessor Pass (what the report tables do for every cell) ---
+    std::size_t checksum = 0;
+    const long long allocationsBefore = totalBlocks.load();
+    start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < config.passes; ++pass) {
+        for (const auto& report : forecasts) {
+            for (const auto& day : report->getForecast().getDailyForecasts()) {
+                for (const auto& hour : day.getHourlyForecasts()) {
+                    checksum += hour.getTime().size();
+                    for (int index = 0; index < NUM_PROPERTIES; ++index) {
+                        const Property* property = hour.getWeather().getProperty(static_cast<PropertyIndex>(index));
+                        if (property != nullptr) { checksum += property->getName().size() + property->getUnit().size(); }
+                    }
+                }
+            }
+        }
+    }
+    double accessNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+                      / (static_cast<double>(config.passes) * properties);
+    std::cout << std::left << std::setw(30) << "Name + unit access" << std::right
+              << std::setw(12) << std::setprecision(2) << accessNs << " ns/property ("
+              << totalBlocks.load() - allocationsBefore << " allocations, checksum " << checksum << ")" << std::endl;
+    return 0;
+}
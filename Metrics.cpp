@@ -0,0 +1,410 @@
+// Metrics.cpp
+#include "Metrics.h"
+#include "httplib.h"    // For httplib::Error labels in exports
+
+#include <atomic>       // For per-thread relaxed counters
+#include <mutex>        // For the thread block registry (registration only, not recording)
+#include <vector>       // For the list of thread blocks
+#include <memory>       // For std::unique_ptr
+#include <iomanip>      // For stream manipulators (setw, setprecision)
+#include <string>       // For label strings
+#include <algorithm>    // For std::min
+#include <utility>      // For std::pair
+
+// --- Internal Storage (Anonymous Namespace) ---
+namespace {
+    const int NUM_STAGES = static_cast<int>(MetricStage::NUM_STAGES);
+    const int NUM_COUNTERS = static_cast<int>(MetricCounter::NUM_COUNTERS);
+    const int SUB_BITS = 3;            // 2^3 = 8 buckets per power of two (~9% relative error).
+    const int SUB_BUCKETS = 1 << SUB_BITS;
+    const int NUM_BUCKETS = 256;       // Log-linear buckets: covers 1 microsecond to ~4.7 hours.
+    const int MAX_ERROR_CODES = 32;    // httplib::Error values are small integers.
+    const int MAX_HTTP_STATUS = 600;   // Statuses 0-599.
+
+    const char* const STAGE_NAMES[NUM_STAGES] = {"fetch", "parse", "build", "render", "startup"};
+
+    // One thread's private set of counters. Only the owning thread writes; exporters read.
+    struct ThreadBlock {
+        std::atomic<std::uint64_t> buckets[NUM_STAGES][NUM_BUCKETS];
+        std::atomic<std::uint64_t> latencySumNanos[NUM_STAGES];
+        std::atomic<std::uint64_t> counters[NUM_COUNTERS];
+        std::atomic<std::uint64_t> transportErrors[MAX_ERROR_CODES];
+        std::atomic<std::uint64_t> httpStatuses[MAX_HTTP_STATUS];
+        std::atomic<bool> inUse;
+
+        ThreadBlock() : inUse(true) {
+            for (auto& stage : buckets) { for (auto& b : stage) { b.store(0, std::memory_order_relaxed); } }
+            for (auto& s : latencySumNanos) { s.store(0, std::memory_order_relaxed); }
+            for (auto& c : counters) { c.store(0, std::memory_order_relaxed); }
+            for (auto& e : transportErrors) { e.store(0, std::memory_order_relaxed); }
+            for (auto& h : httpStatuses) { h.store(0, std::memory_order_relaxed); }
+        }
+    };
+
+    // All thread blocks ever created. Blocks are never freed, so totals survive thread exit;
+    // a block released by an exited thread is handed to the next new thread.
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBlock>> blocks;
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    // Claims a block for the current thread on first use and releases it on thread exit.
+    struct ThreadHandle {
+        ThreadBlock* block;
+        ThreadHandle() : block(nullptr) {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            for (auto& candidate : reg.blocks) {
+                if (!candidate->inUse.load(std::memory_order_relaxed)) {
+                    candidate->inUse.store(true, std::memory_order_relaxed);
+                    block = candidate.get();
+                    return;
+                }
+            }
+            reg.blocks.push_back(std::make_unique<ThreadBlock>());
+            block = reg.blocks.back().get();
+        }
+        ~ThreadHandle() { block->inUse.store(false, std::memory_order_release); }
+    };
+
+    ThreadBlock& localBlock() {
+        thread_local ThreadHandle handle;
+        return *handle.block;
+    }
+
+    // Relaxed increment by the owning thread. A plain load/store pair is enough because
+    // no other thread ever writes this block.
+    void bump(std::atomic<std::uint64_t>& cell, std::uint64_t amount) {
+        cell.store(cell.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    // Maps a microsecond value to its bucket: exact below 8, then 8 buckets per power of two.
+    int bucketFor(std::uint64_t micros) {
+        if (micros < static_cast<std::uint64_t>(SUB_BUCKETS)) { return static_cast<int>(micros); }
+        int msb = 0;
+        for (std::uint64_t v = micros; v > 1; v >>= 1) { ++msb; }
+        int sub = static_cast<int>((micros >> (msb - SUB_BITS)) & (SUB_BUCKETS - 1));
+        return std::min(NUM_BUCKETS - 1, SUB_BUCKETS + (msb - SUB_BITS) * SUB_BUCKETS + sub);
+    }
+
+    // Returns the [lower, upper) microsecond range covered by a bucket.
+    void bucketRange(int index, double& lower, double& upper) {
+        if (index < SUB_BUCKETS) { lower = index; upper = index + 1.0; return; }
+        int msb = (index - SUB_BUCKETS) / SUB_BUCKETS + SUB_BITS;
+        int sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+        double width = static_cast<double>(1ULL << (msb - SUB_BITS));
+        lower = static_cast<double>(1ULL << msb) + sub * width;
+        upper = lower + width;
+    }
+
+    // Sums one stage's histogram across all thread blocks.
+    std::vector<std::uint64_t> mergedHistogram(int stage) {
+        std::vector<std::uint64_t> merged(NUM_BUCKETS, 0);
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto& block : reg.blocks) {
+            for (int b = 0; b < NUM_BUCKETS; ++b) {
+                merged[b] += block->buckets[stage][b].load(std::memory_order_relaxed);
+            }
+        }
+        return merged;
+    }
+
+    // Sums an arbitrary per-thread cell across all thread blocks.
+    template <typename Selector>
+    std::uint64_t mergedValue(Selector select) {
+        std::uint64_t total = 0;
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto& block : reg.blocks) {
+            total += select(*block).load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // Caches registered for export, by name. Expired entries are pruned when read.
+    struct CacheRegistry {
+        std::mutex mutex;
+        std::vector<std::pair<std::string, std::weak_ptr<const CacheGauges>>> caches;
+    };
+
+    CacheRegistry& cacheRegistry() {
+        static CacheRegistry instance;
+        return instance;
+    }
+
+    // Gauge values of every live cache, summed by name (in registration order).
+    struct CacheTotals {
+        std::string name;
+        std::uint64_t entries, bytes, budgetBytes, evictions, evictedBytes;
+    };
+
+    std::vector<CacheTotals> cacheTotals() {
+        std::vector<CacheTotals> totals;
+        CacheRegistry& reg = cacheRegistry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        auto it = reg.caches.begin();
+        while (it != reg.caches.end()) {
+            std::shared_ptr<const CacheGauges> gauges = it->second.lock();
+            if (!gauges) {
+                it = reg.caches.erase(it);
+                continue;
+            }
+            CacheTotals* row = nullptr;
+            for (auto& existing : totals) {
+                if (existing.name == it->first) { row = &existing; }
+            }
+            if (row == nullptr) {
+                totals.push_back(CacheTotals{it->first, 0, 0, 0, 0, 0});
+                row = &totals.back();
+            }
+            row->entries += gauges->entries.load(std::memory_order_relaxed);
+            row->bytes += gauges->bytes.load(std::memory_order_relaxed);
+            row->budgetBytes += gauges->budgetBytes.load(std::memory_order_relaxed);
+            row->evictions += gauges->evictions.load(std::memory_order_relaxed);
+            row->evictedBytes += gauges->evictedBytes.load(std::memory_order_relaxed);
+            ++it;
+        }
+        return totals;
+    }
+
+    double mebibytes(std::uint64_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); }
+
+    // Returns a readable label for an httplib::Error code.
+    std::string errorLabel(int code) {
+        return httplib::to_string(static_cast<httplib::Error>(code));
+    }
+} // end anonymous namespace
+
+// --- Recording ---
+
+void Metrics::recordLatency(MetricStage stage, std::chrono::steady_clock::duration elapsed) {
+    int s = static_cast<int>(stage);
+    if (s < 0 || s >= NUM_STAGES) { return; }
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    if (nanos < 0) { nanos = 0; }
+    ThreadBlock& block = localBlock();
+    bump(block.buckets[s][bucketFor(static_cast<std::uint64_t>(nanos) / 1000)], 1);
+    bump(block.latencySumNanos[s], static_cast<std::uint64_t>(nanos));
+}
+
+void Metrics::increment(MetricCounter counter, std::uint64_t amount) {
+    int c = static_cast<int>(counter);
+    if (c < 0 || c >= NUM_COUNTERS) { return; }
+    bump(localBlock().counters[c], amount);
+}
+
+void Metrics::recordTransportError(int errorCode) {
+    if (errorCode < 0 || errorCode >= MAX_ERROR_CODES) { errorCode = static_cast<int>(httplib::Error::Unknown); }
+    bump(localBlock().transportErrors[errorCode], 1);
+}
+
+void Metrics::recordHttpStatus(int status) {
+    if (status < 0 || status >= MAX_HTTP_STATUS) { status = 0; }
+    bump(localBlock().httpStatuses[status], 1);
+}
+
+void Metrics::registerCache(const std::string& name, std::shared_ptr<const CacheGauges> gauges) {
+    CacheRegistry& reg = cacheRegistry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.caches.emplace_back(name, std::move(gauges));
+}
+
+// --- Reading ---
+
+double Metrics::latencyQuantile(MetricStage stage, double q) {
+    int s = static_cast<int>(stage);
+    if (s < 0 || s >= NUM_STAGES) { return 0.0; }
+    std::vector<std::uint64_t> histogram = mergedHistogram(s);
+    std::uint64_t total = 0;
+    for (std::uint64_t count : histogram) { total += count; }
+    if (total == 0) { return 0.0; }
+
+    // Find the bucket holding the target rank, then interpolate linearly inside it.
+    double target = q * static_cast<double>(total);
+    double cumulative = 0.0;
+    for (int b = 0; b < NUM_BUCKETS; ++b) {
+        if (histogram[b] == 0) { continue; }
+        if (cumulative + static_cast<double>(histogram[b]) >= target) {
+            double lower, upper;
+            bucketRange(b, lower, upper);
+            double fraction = (target - cumulative) / static_cast<double>(histogram[b]);
+            return (lower + fraction * (upper - lower)) / 1e6;
+        }
+        cumulative += static_cast<double>(histogram[b]);
+    }
+    double lower, upper;
+    bucketRange(NUM_BUCKETS - 1, lower, upper);
+    return upper / 1e6;
+}
+
+std::uint64_t Metrics::sampleCount(MetricStage stage) {
+    int s = static_cast<int>(stage);
+    if (s < 0 || s >= NUM_STAGES) { return 0; }
+    std::uint64_t total = 0;
+    for (std::uint64_t count : mergedHistogram(s)) { total += count; }
+    return total;
+}
+
+std::uint64_t Metrics::counterValue(MetricCounter counter) {
+    int c = static_cast<int>(counter);
+    if (c < 0 || c >= NUM_COUNTERS) { return 0; }
+    return mergedValue([c](ThreadBlock& b) -> std::atomic<std::uint64_t>& { return b.counters[c]; });
+}
+
+// --- Export ---
+
+void Metrics::writePrometheus(std::ostream& os) {
+    const double quantiles[] = {0.5, 0.9, 0.99};
+    // Use plain (non-fixed) float formatting regardless of the stream's current state.
+    std::ios::fmtflags savedFlags = os.flags();
+    std::streamsize savedPrecision = os.precision();
+    os.unsetf(std::ios::floatfield);
+    os.precision(9);
+
+    os << "# HELP weatherapp_stage_latency_seconds Latency of fetch, parse, build and render stages, and time to first render at startup.\n";
+    os << "# TYPE weatherapp_stage_latency_seconds summary\n";
+    for (int s = 0; s < NUM_STAGES; ++s) {
+        MetricStage stage = static_cast<MetricStage>(s);
+        for (double q : quantiles) {
+            os << "weatherapp_stage_latency_seconds{stage=\"" << STAGE_NAMES[s] << "\",quantile=\"" << q << "\"} "
+               << latencyQuantile(stage, q) << "\n";
+        }
+        std::uint64_t sumNanos = mergedValue([s](ThreadBlock& b) -> std::atomic<std::uint64_t>& { return b.latencySumNanos[s]; });
+        os << "weatherapp_stage_latency_seconds_sum{stage=\"" << STAGE_NAMES[s] << "\"} " << (static_cast<double>(sumNanos) / 1e9) << "\n";
+        os << "weatherapp_stage_latency_seconds_count{stage=\"" << STAGE_NAMES[s] << "\"} " << sampleCount(stage) << "\n";
+    }
+
+    os << "# HELP weatherapp_requests_total HTTP requests attempted.\n";
+    os << "# TYPE weatherapp_requests_total counter\n";
+    os << "weatherapp_requests_total " << counterValue(MetricCounter::REQUESTS) << "\n";
+    os << "# HELP weatherapp_received_bytes_total Response body bytes received.\n";
+    os << "# TYPE weatherapp_received_bytes_total counter\n";
+    os << "weatherapp_received_bytes_total " << counterValue(MetricCounter::BYTES_RECEIVED) << "\n";
+    os << "# HELP weatherapp_cache_hits_total Lookups answered from cache.\n";
+    os << "# TYPE weatherapp_cache_hits_total counter\n";
+    os << "weatherapp_cache_hits_total " << counterValue(MetricCounter::CACHE_HITS) << "\n";
+    os << "# HELP weatherapp_cache_misses_total Lookups that went upstream.\n";
+    os << "# TYPE weatherapp_cache_misses_total counter\n";
+    os << "weatherapp_cache_misses_total " << counterValue(MetricCounter::CACHE_MISSES) << "\n";
+    os << "# HELP weatherapp_retries_total Requests re-sent after a transient failure.\n";
+    os << "# TYPE weatherapp_retries_total counter\n";
+    os << "weatherapp_retries_total " << counterValue(MetricCounter::RETRIES) << "\n";
+    os << "# HELP weatherapp_circuit_rejections_total Requests failed fast by an open circuit breaker.\n";
+    os << "# TYPE weatherapp_circuit_rejections_total counter\n";
+    os << "weatherapp_circuit_rejections_total " << counterValue(MetricCounter::CIRCUIT_REJECTIONS) << "\n";
+    os << "# HELP weatherapp_stale_responses_total Last good responses served while upstream was unavailable.\n";
+    os << "# TYPE weatherapp_stale_responses_total counter\n";
+    os << "weatherapp_stale_responses_total " << counterValue(MetricCounter::STALE_RESPONSES) << "\n";
+    os << "# HELP weatherapp_rate_limited_total Requests shed by the client-side rate limiter or quota.\n";
+    os << "# TYPE weatherapp_rate_limited_total counter\n";
+    os << "weatherapp_rate_limited_total " << counterValue(MetricCounter::RATE_LIMITED) << "\n";
+    os << "# HELP weatherapp_alerts_emitted_total Alert events (triggered or cleared) sent to a sink.\n";
+    os << "# TYPE weatherapp_alerts_emitted_total counter\n";
+    os << "weatherapp_alerts_emitted_total " << counterValue(MetricCounter::ALERTS_EMITTED) << "\n";
+    os << "# HELP weatherapp_location_reuses_total Queries sent as an already known nearby or same-named site.\n";
+    os << "# TYPE weatherapp_location_reuses_total counter\n";
+    os << "weatherapp_location_reuses_total " << counterValue(MetricCounter::LOCATION_REUSES) << "\n";
+
+    // Cache occupancy (a budget of 0 means unlimited).
+    std::vector<CacheTotals> caches = cacheTotals();
+    struct CacheSeries { const char* name; const char* type; const char* help; std::uint64_t CacheTotals::*field; };
+    const CacheSeries cacheSeries[] = {
+        {"weatherapp_cache_entries", "gauge", "Values held by each in-process cache.", &CacheTotals::entries},
+        {"weatherapp_cache_bytes", "gauge", "Bytes charged against each cache's memory budget.", &CacheTotals::bytes},
+        {"weatherapp_cache_budget_bytes", "gauge", "Memory budget of each cache (0 = unlimited).", &CacheTotals::budgetBytes},
+        {"weatherapp_cache_evictions_total", "counter", "Values evicted to stay within the memory budget.", &CacheTotals::evictions},
+        {"weatherapp_cache_evicted_bytes_total", "counter", "Bytes freed by evictions.", &CacheTotals::evictedBytes},
+    };
+    for (const auto& series : cacheSeries) {
+        os << "# HELP " << series.name << " " << series.help << "\n";
+        os << "# TYPE " << series.name << " " << series.type << "\n";
+        for (const auto& cache : caches) {
+            os << series.name << "{cache=\"" << cache.name << "\"} " << cache.*series.field << "\n";
+        }
+    }
+
+    os << "# HELP weatherapp_transport_errors_total Failed requests by httplib::Error code.\n";
+    os << "# TYPE weatherapp_transport_errors_total counter\n";
+    for (int e = 0; e < MAX_ERROR_CODES; ++e) {
+        std::uint64_t count = mergedValue([e](ThreadBlock& b) -> std::atomic<std::uint64_t>& { return b.transportErrors[e]; });
+        if (count > 0) {
+            os << "weatherapp_transport_errors_total{error=\"" << errorLabel(e) << "\"} " << count << "\n";
+        }
+    }
+
+    os << "# HELP weatherapp_http_error_responses_total Non-200 responses by status code.\n";
+    os << "# TYPE weatherapp_http_error_responses_total counter\n";
+    for (int status = 0; status < MAX_HTTP_STATUS; ++status) {
+        std::uint64_t count = mergedValue([status](ThreadBlock& b) -> std::atomic<std::uint64_t>& { return b.httpStatuses[status]; });
+        if (count > 0) {
+            os << "weatherapp_http_error_responses_total{code=\"" << status << "\"} " << count << "\n";
+        }
+    }
+    os.flags(savedFlags);
+    os.precision(savedPrecision);
+}
+
+void Metrics::writeSummary(std::ostream& os) {
+    os << "\n--- Performance Metrics ---\n";
+    os << "  " << std::left << std::setw(8) << "Stage" << "| "
+       << std::right << std::setw(8) << "Count" << " | "
+       << std::setw(10) << "p50 (ms)" << " | "
+       << std::setw(10) << "p99 (ms)" << "\n";
+    os << "  " << std::string(8, '-') << "+" << std::string(10, '-') << "+"
+       << std::string(12, '-') << "+" << std::string(11, '-') << "\n";
+    for (int s = 0; s < NUM_STAGES; ++s) {
+        MetricStage stage = static_cast<MetricStage>(s);
+        os << "  " << std::left << std::setw(8) << STAGE_NAMES[s] << "| "
+           << std::right << std::setw(8) << sampleCount(stage) << " | "
+           << std::fixed << std::setprecision(3)
+           << std::setw(10) << latencyQuantile(stage, 0.5) * 1000.0 << " | "
+           << std::setw(10) << latencyQuantile(stage, 0.99) * 1000.0 << "\n";
+    }
+
+    std::uint64_t hits = counterValue(MetricCounter::CACHE_HITS);
+    std::uint64_t misses = counterValue(MetricCounter::CACHE_MISSES);
+    os << "\n  Requests:        " << counterValue(MetricCounter::REQUESTS) << "\n";
+    os << "  Bytes received:  " << counterValue(MetricCounter::BYTES_RECEIVED) << "\n";
+    os << "  Retries:         " << counterValue(MetricCounter::RETRIES) << "\n";
+    os << "  Circuit fails:   " << counterValue(MetricCounter::CIRCUIT_REJECTIONS) << "\n";
+    os << "  Stale served:    " << counterValue(MetricCounter::STALE_RESPONSES) << "\n";
+    os << "  Rate limited:    " << counterValue(MetricCounter::RATE_LIMITED) << "\n";
+    os << "  Alerts emitted:  " << counterValue(MetricCounter::ALERTS_EMITTED) << "\n";
+    os << "  Location reuses: " << counterValue(MetricCounter::LOCATION_REUSES) << "\n";
+    os << "  Cache hit rate:  ";
+    if (hits + misses > 0) {
+        os << std::fixed << std::setprecision(1) << (100.0 * hits / (hits + misses)) << "% (" << hits << "/" << (hits + misses) << ")\n";
+    } else {
+        os << "n/a\n";
+    }
+    for (const auto& cache : cacheTotals()) {
+        os << "  Cache " << std::left << std::setw(11) << (cache.name + ":") << std::right
+           << cache.entries << " entries, " << std::fixed << std::setprecision(1) << mebibytes(cache.bytes) << " MiB of ";
+        if (cache.budgetBytes > 0) { os << mebibytes(cache.budgetBytes) << " MiB"; } else { os << "unlimited"; }
+        os << ", " << cache.evictions << " evicted (" << mebibytes(cache.evictedBytes) << " MiB)\n";
+    }
+
+    bool anyErrors = false;
+    for (int e = 0; e < MAX_ERROR_CODES; ++e) {
+        std::uint64_t count = mergedValue([e](ThreadBlock& b) -> std::atomic<std::uint64_t>& { return b.transportErrors[e]; });
+        if (count > 0) {
+            os << "  Transport error: " << errorLabel(e) << " x" << count << "\n";
+            anyErrors = true;
+        }
+    }
+    for (int status = 0; status < MAX_HTTP_STATUS; ++status) {
+        std::uint64_t count = mergedValue([status](ThreadBlock& b) -> std::atomic<std::uint64_t>& { return b.httpStatuses[status]; });
+        if (count > 0) {
+            os << "  HTTP status " << status << ":  x" << count << "\n";
+            anyErrors = true;
+        }
+    }
+    if (!anyErrors) { os << "  Errors:          none\n"; }
+    os << "---------------------------" << std::endl;
+}
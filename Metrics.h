@@ -0,0 +1,104 @@
+// Metrics.h
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <cstdint> // For fixed-width counter types
+#include <ostream> // For export methods
+#include <chrono>  // For the monotonic clock used by ScopedTimer
+#include <atomic>  // For the cache gauges
+#include <memory>  // For registered cache gauges
+#include <string>  // For cache names
+
+// Pipeline stages whose latency is measured.
+enum class MetricStage {
+    FETCH = 0,  // HTTP round trip (client->Get)
+    PARSE,      // json::parse of the response body
+    BUILD,      // Populating Weather/Forecast objects from parsed JSON
+    RENDER,     // Report display (IDisplayable::display)
+    STARTUP,    // Process start to the first screen shown (time to first render; one sample per run)
+    NUM_STAGES  // Sentinel value indicating the total number of stages
+};
+
+// Monotonic event counters.
+enum class MetricCounter {
+    REQUESTS = 0,       // HTTP requests attempted
+    BYTES_RECEIVED,     // Response body bytes received
+    CACHE_HITS,         // Lookups answered from an in-process cache
+    CACHE_MISSES,       // Lookups that had to go upstream
+    RETRIES,            // Requests re-sent after a transient failure
+    CIRCUIT_REJECTIONS, // Requests failed fast by an open circuit breaker
+    STALE_RESPONSES,    // Last good responses served because upstream was unavailable
+    RATE_LIMITED,       // Requests shed by the client-side rate limiter or quota
+    ALERTS_EMITTED,     // Alert events (triggered or cleared) sent to a sink
+    LOCATION_REUSES,    // Queries sent as an already known nearby or same-named site
+    NUM_COUNTERS        // Sentinel value indicating the total number of counters
+};
+
+// Occupancy and eviction totals of one memory-budgeted cache (see BudgetCache). The cache
+// updates them under its own lock; exporters read them whenever metrics are written.
+struct CacheGauges {
+    std::atomic<std::uint64_t> entries{0};      // Values held
+    std::atomic<std::uint64_t> bytes{0};        // Bytes charged against the budget
+    std::atomic<std::uint64_t> budgetBytes{0};  // Budget (0 = unlimited)
+    std::atomic<std::uint64_t> evictions{0};    // Values dropped to stay within the budget
+    std::atomic<std::uint64_t> evictedBytes{0}; // Bytes those values were charged
+};
+
+// Process-wide, low-overhead instrumentation.
+// Every thread records into its own block of relaxed atomics (no locks or shared cache
+// lines on the hot path); readers sum the blocks of all threads when exporting.
+// Latencies go into log-linear histograms (8 buckets per power of two, microsecond base),
+// which is enough resolution for p50/p99 reporting.
+class Metrics {
+  public:
+  // Delete constructor to prevent instantiation of this utility class.
+  Metrics() = delete;
+
+  // --- Recording (hot path, lock-free) ---
+
+  // Records one latency sample for a stage.
+  static void recordLatency(MetricStage stage, std::chrono::steady_clock::duration elapsed);
+  // Adds 'amount' to a counter.
+  static void increment(MetricCounter counter, std::uint64_t amount = 1);
+  // Counts a failed request by its httplib::Error code (passed as int to avoid the include).
+  static void recordTransportError(int errorCode);
+  // Counts a non-200 HTTP response by status code.
+  static void recordHttpStatus(int status);
+  // Adds a cache to the exports under 'name' (caches sharing a name are summed). Only a weak
+  // reference is kept, so a destroyed cache drops out of later exports.
+  static void registerCache(const std::string& name, std::shared_ptr<const CacheGauges> gauges);
+
+  // --- Reading ---
+
+  // Returns the approximate latency (in seconds) at quantile 'q' (0.0 - 1.0) for a stage.
+  static double latencyQuantile(MetricStage stage, double q);
+  // Returns the number of latency samples recorded for a stage.
+  static std::uint64_t sampleCount(MetricStage stage);
+  // Returns the current value of a counter (summed over all threads).
+  static std::uint64_t counterValue(MetricCounter counter);
+
+  // --- Export ---
+
+  // Writes all metrics in Prometheus text exposition format (version 0.0.4).
+  static void writePrometheus(std::ostream& os);
+  // Writes a human-readable summary table (used by the CLI).
+  static void writeSummary(std::ostream& os);
+};
+
+// RAII helper: measures the time from construction to destruction on the monotonic
+// clock and records it for the given stage.
+class ScopedTimer {
+  private:
+  MetricStage stage;                                // Stage being timed.
+  std::chrono::steady_clock::time_point startTime;  // When timing began.
+
+  public:
+  explicit ScopedTimer(MetricStage s) : stage(s), startTime(std::chrono::steady_clock::now()) {}
+  ~ScopedTimer() { Metrics::recordLatency(stage, std::chrono::steady_clock::now() - startTime); }
+
+  // Disable copy operations (each timer records exactly once).
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,38 @@
+// MetricsServer.cpp
+#include "MetricsServer.h"
+#include "Metrics.h"    // Source of the exported values
+#include "httplib.h"    // External HTTP library (Server)
+
+#include <iostream>     // For error output (cerr)
+#include <sstream>      // For building the response body
+
+// --- Constructor / Destructor ---
+
+MetricsServer::MetricsServer() : server(std::make_unique<httplib::Server>()) {
+    server->Get("/metrics", [](const httplib::Request&, httplib::Response& res) {
+        std::ostringstream body;
+        Metrics::writePrometheus(body);
+        res.set_content(body.str(), "text/plain; version=0.0.4");
+    });
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+// --- Lifecycle ---
+
+bool MetricsServer::start(const std::string& host, int port) {
+    if (serverThread.joinable()) { return true; } // Already running.
+    if (!server->bind_to_port(host, port)) {
+        std::cerr << "Error: Metrics server could not bind to " << host << ":" << port << "." << std::endl;
+        return false;
+    }
+    serverThread = std::thread([this] { server->listen_after_bind(); });
+    return true;
+}
+
+void MetricsServer::stop() {
+    server->stop();
+    if (serverThread.joinable()) { serverThread.join(); }
+}
@@ -0,0 +1,34 @@
+// MetricsServer.h
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <string>  // For the bind address
+#include <memory>  // For std::unique_ptr (server instance)
+#include <thread>  // For serving on a background thread
+
+namespace httplib { class Server; } // Forward declare external library class
+
+// Serves the process metrics at "GET /metrics" in Prometheus text format
+// on a background thread, so long-running instances can be scraped.
+class MetricsServer {
+private:
+    std::unique_ptr<httplib::Server> server; // Underlying HTTP server.
+    std::thread serverThread;                // Background listener thread.
+
+public:
+    // Constructor: Creates the server (not yet listening).
+    MetricsServer();
+    // Destructor: Stops the server and joins the background thread.
+    ~MetricsServer();
+
+    // Disable copy operations (owns a server and a thread).
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // Binds 'host':'port' and starts serving. Returns false if the port cannot be bound.
+    bool start(const std::string& host, int port);
+    // Stops serving and joins the background thread.
+    void stop();
+};
+
+#endif // METRICSSERVER_H
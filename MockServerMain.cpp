@@ -0,0 +1,73 @@
+// MockServerMain.cpp - Entry point for the standalone mock WeatherAPI server
+#include "MockWeatherServer.h" // The mock server implementation
+
+#include <iostream> // For console output (cout, cerr)
+#include <string>   // For argument parsing
+#include <cstdlib>  // For strtol, strtod
+
+namespace {
+    // Prints the supported command line options.
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "  --host ADDR           Interface to bind (default 127.0.0.1)\n"
+                  << "  --port N              Port to listen on, 0 = any (default 8080)\n"
+                  << "  --threads N           Handler threads (default 16)\n"
+                  << "  --latency MS          Fixed delay per response\n"
+                  << "  --jitter MS           Random extra delay in [0, MS]\n"
+                  << "  --tail-rate P         Fraction of slow responses (0-1)\n"
+                  << "  --tail-latency MS     Extra delay for slow responses\n"
+                  << "  --error-rate P        Fraction of failed responses (0-1)\n"
+                  << "  --error-status CODE   HTTP status for failures (default 500)\n"
+                  << "  --retry-after S       Retry-After header for injected 429s (default 1)\n"
+                  << "  --padding BYTES       Extra bytes per payload\n"
+                  << "  --fixtures DIR        Serve current.json/forecast.json from DIR\n"
+                  << "  --base-epoch SECONDS  Fixed start time for synthetic data\n"
+                  << "  --seed N              Seed for data, latency and error decisions (default 42)\n";
+    }
+} // end anonymous namespace
+
+int main(int argc, char* argv[]) {
+    MockServerConfig config;
+
+    // --- Argument Parsing ---
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for option '" << arg << "'." << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+
+        if (arg == "--host")              { config.host = value; }
+        else if (arg == "--port")         { config.port = std::atoi(value); }
+        else if (arg == "--threads")      { config.workerThreads = std::atoi(value); }
+        else if (arg == "--latency")      { config.latencyMs = std::atoi(value); }
+        else if (arg == "--jitter")       { config.jitterMs = std::atoi(value); }
+        else if (arg == "--tail-rate")    { config.tailRate = std::atof(value); }
+        else if (arg == "--tail-latency") { config.tailLatencyMs = std::atoi(value); }
+        else if (arg == "--error-rate")   { config.errorRate = std::atof(value); }
+        else if (arg == "--error-status") { config.errorStatus = std::atoi(value); }
+        else if (arg == "--retry-after")  { config.retryAfterSeconds = std::atoi(value); }
+        else if (arg == "--padding")      { config.paddingBytes = std::atoi(value); }
+        else if (arg == "--fixtures")     { config.fixtureDir = value; }
+        else if (arg == "--base-epoch")   { config.baseEpoch = std::atoll(value); }
+        else if (arg == "--seed")         { config.seed = static_cast<unsigned int>(std::strtoul(value, nullptr, 10)); }
+        else {
+            std::cerr << "Error: Unknown option '" << arg << "'." << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // --- Serve Until Killed ---
+    MockWeatherServer server(config);
+    if (!server.run()) {
+        return 1; // bindServer already printed the reason.
+    }
+    return 0;
+}
@@ -0,0 +1,462 @@
+// MockWeatherServer.cpp
+#include "MockWeatherServer.h"
+#include "httplib.h"              // External HTTP library (Server)
+#include "nlohmann/json.hpp"      // External JSON library (payload generation)
+
+#include <iostream>     // For error output (cerr)
+#include <fstream>      // For reading fixture files
+#include <sstream>      // For reading whole files into strings
+#include <chrono>       // For injected latency durations
+#include <cmath>        // For sin, round, fabs (synthetic weather model)
+#include <cstdint>      // For uint64_t hashing
+#include <cstdio>       // For snprintf (date formatting)
+#include <cstdlib>      // For strtod (lat,lon query parsing)
+#include <ctime>        // For time() (default base epoch)
+#include <algorithm>    // For std::min, std::max
+#include <utility>      // For std::move
+
+using json = nlohmann::json;
+
+// --- Internal Helper Functions (Anonymous Namespace) ---
+namespace {
+    const double PI = 3.14159265358979323846;
+
+    // SplitMix64 finalizer: turns any 64-bit input into a well-mixed pseudo-random value.
+    // Used instead of a shared engine so results depend only on the inputs, not on thread timing.
+    uint64_t mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // Maps a hash value to a double in [0, 1).
+    double unitRandom(uint64_t h) {
+        return static_cast<double>(h >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // FNV-1a hash of a string (stable across platforms, unlike std::hash).
+    uint64_t hashString(const std::string& s) {
+        uint64_t h = 1469598103934665603ULL;
+        for (unsigned char c : s) { h ^= c; h *= 1099511628211ULL; }
+        return h;
+    }
+
+    // Rounds a value to one decimal place, as WeatherAPI does.
+    double round1(double v) { return std::round(v * 10.0) / 10.0; }
+    // Rounds a value to two decimal places (coordinates, inches).
+    double round2(double v) { return std::round(v * 100.0) / 100.0; }
+
+    // Converts a day count since 1970-01-01 to a civil (year, month, day) date.
+    // Howard Hinnant's algorithm; independent of the host timezone.
+    void civilFromDays(long long z, int& y, int& m, int& d) {
+        z += 719468;
+        const long long era = (z >= 0 ? z : z - 146096) / 146097;
+        const long long doe = z - era * 146097;
+        const long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const long long mp = (5 * doy + 2) / 153;
+        d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+        m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+        y = static_cast<int>(yoe + era * 400 + (m <= 2 ? 1 : 0));
+    }
+
+    // Floor division for possibly negative epoch values.
+    long long floorDiv(long long a, long long b) {
+        return (a >= 0) ? a / b : -((-a + b - 1) / b);
+    }
+
+    // Formats a local epoch (UTC epoch + offset) as "YYYY-MM-DD" or "YYYY-MM-DD HH:MM".
+    std::string formatLocal(long long localEpoch, bool withTime) {
+        long long days = floorDiv(localEpoch, 86400);
+        long long secs = localEpoch - days * 86400;
+        int y, m, d;
+        civilFromDays(days, y, m, d);
+        char buf[32];
+        if (withTime) {
+            std::snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d", y, m, d,
+                          static_cast<int>(secs / 3600), static_cast<int>((secs % 3600) / 60));
+        } else {
+            std::snprintf(buf, sizeof(buf), "%04d-%02d-%02d", y, m, d);
+        }
+        return buf;
+    }
+
+    // Describes the synthetic site a query resolves to.
+    struct SiteInfo {
+        std::string name;     // Display name.
+        double lat;           // Latitude in degrees.
+        double lon;           // Longitude in degrees.
+        int utcOffset;        // Local offset from UTC in seconds (whole hours from longitude).
+        uint64_t hash;        // Stable hash used to vary data between sites.
+    };
+
+    // Resolves a "q" parameter to a site. "lat,lon" queries keep their coordinates;
+    // names are hashed onto a stable pseudo-random coordinate.
+    SiteInfo resolveSite(const std::string& query) {
+        SiteInfo site;
+        site.hash = hashString(query);
+        char* end = nullptr;
+        double lat = std::strtod(query.c_str(), &end);
+        if (end != query.c_str() && *end == ',') {
+            const char* lonStart = end + 1;
+            double lon = std::strtod(lonStart, &end);
+            if (end != lonStart && *end == '\0') {
+                site.lat = std::max(-90.0, std::min(90.0, lat));
+                site.lon = std::max(-180.0, std::min(180.0, lon));
+                site.name = "Mock Site " + query;
+                site.utcOffset = static_cast<int>(std::round(site.lon / 15.0)) * 3600;
+                return site;
+            }
+        }
+        site.lat = unitRandom(mix(site.hash)) * 120.0 - 60.0;
+        site.lon = unitRandom(mix(site.hash + 1)) * 360.0 - 180.0;
+        site.name = query;
+        site.utcOffset = static_cast<int>(std::round(site.lon / 15.0)) * 3600;
+        return site;
+    }
+
+    // Builds the "location" block shared by both endpoints.
+    json makeLocationBlock(const SiteInfo& site, long long epoch) {
+        int offsetHours = site.utcOffset / 3600;
+        return json{
+            {"name", site.name},
+            {"region", "Mock Region"},
+            {"country", "Mockland"},
+            {"lat", round2(site.lat)},
+            {"lon", round2(site.lon)},
+            {"tz_id", offsetHours == 0 ? std::string("Etc/GMT")
+                      : "Etc/GMT" + std::string(offsetHours > 0 ? "-" : "+") + std::to_string(std::abs(offsetHours))},
+            {"localtime_epoch", epoch},
+            {"localtime", formatLocal(epoch + site.utcOffset, true)}
+        };
+    }
+
+    // Fills the fields common to "current" and each "hour" entry for one point in time.
+    // Values follow a smooth diurnal cycle with per-site, per-hour noise; metric and
+    // imperial variants are always consistent with each other.
+    json makeConditions(const SiteInfo& site, long long epoch, uint64_t seed) {
+        uint64_t h = mix(seed ^ site.hash ^ static_cast<uint64_t>(epoch / 3600));
+        double localHour = static_cast<double>(((epoch + site.utcOffset) % 86400 + 86400) % 86400) / 3600.0;
+        double dayPhase = std::sin(2.0 * PI * (localHour - 9.0) / 24.0);
+
+        double tempC = 25.0 - 0.4 * std::fabs(site.lat) + 6.0 * dayPhase + (unitRandom(mix(h + 1)) - 0.5) * 3.0;
+        double humidity = std::max(15.0, std::min(100.0, 70.0 - 20.0 * dayPhase + (unitRandom(mix(h + 2)) - 0.5) * 20.0));
+        double windKph = 5.0 + unitRandom(mix(h + 3)) * 30.0;
+        double windDeg = std::fmod(unitRandom(mix(site.hash + 7)) * 360.0 + (unitRandom(mix(h + 4)) - 0.5) * 90.0 + 360.0, 360.0);
+        double gustKph = windKph * (1.3 + unitRandom(mix(h + 5)) * 0.5);
+        double chanceOfRain = std::round(unitRandom(mix(h + 6)) * 100.0);
+        double precipMm = chanceOfRain > 60.0 ? round1(unitRandom(mix(h + 8)) * 4.0) : 0.0;
+        double cloud = std::round(std::min(100.0, chanceOfRain * 0.8 + unitRandom(mix(h + 9)) * 30.0));
+        double pressureMb = std::round(1013.0 + (unitRandom(mix(h + 10)) - 0.5) * 30.0);
+        double visKm = precipMm > 0.0 ? 5.0 : 10.0;
+        double uv = std::max(0.0, round1(dayPhase * 8.0));
+        double feelsC = tempC - (windKph > 10.0 ? (windKph - 10.0) * 0.1 : 0.0);
+        double dewC = tempC - (100.0 - humidity) / 5.0;
+
+        auto toF = [](double c) { return round1(c * 9.0 / 5.0 + 32.0); };
+        auto toMph = [](double k) { return round1(k / 1.609344); };
+
+        return json{
+            {"temp_c", round1(tempC)}, {"temp_f", toF(tempC)},
+            {"is_day", (localHour >= 6.0 && localHour < 20.0) ? 1 : 0},
+            {"condition", {{"text", precipMm > 0.0 ? "Light rain" : (cloud > 50.0 ? "Partly cloudy" : "Sunny")},
+                           {"icon", "//cdn.weatherapi.com/weather/64x64/day/116.png"},
+                           {"code", precipMm > 0.0 ? 1183 : (cloud > 50.0 ? 1003 : 1000)}}},
+            {"wind_mph", toMph(windKph)}, {"wind_kph", round1(windKph)},
+            {"wind_degree", static_cast<int>(windDeg)},
+            {"pressure_mb", pressureMb}, {"pressure_in", round2(pressureMb * 0.02953)},
+            {"precip_mm", precipMm}, {"precip_in", round2(precipMm / 25.4)},
+            {"humidity", static_cast<int>(humidity)},
+            {"cloud", static_cast<int>(cloud)},
+            {"feelslike_c", round1(feelsC)}, {"feelslike_f", toF(feelsC)},
+            {"dewpoint_c", round1(dewC)}, {"dewpoint_f", toF(dewC)},
+            {"vis_km", visKm}, {"vis_miles", round1(visKm / 1.609344)},
+            {"gust_mph", toMph(gustKph)}, {"gust_kph", round1(gustKph)},
+            {"uv", uv},
+            {"chance_of_rain", static_cast<int>(chanceOfRain)},
+            {"chance_of_snow", 0}
+        };
+    }
+
+    // Adds a filler field so payload sizes can be tuned. Parsers ignore unknown keys.
+    void addPadding(json& payload, int paddingBytes) {
+        if (paddingBytes > 0) {
+            payload["_padding"] = std::string(static_cast<size_t>(paddingBytes), 'x');
+        }
+    }
+
+    // Writes a WeatherAPI-style error body.
+    void writeApiError(httplib::Response& res, int status, int code, const std::string& message) {
+        res.status = status;
+        res.set_content(json{{"error", {{"code", code}, {"message", message}}}}.dump(), "application/json");
+    }
+
+    // Reads an entire file into a string. Returns false if it cannot be opened.
+    bool readFile(const std::string& path, std::string& out) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) { return false; }
+        std::ostringstream ss;
+        ss << in.rdbuf();
+        out = ss.str();
+        return true;
+    }
+} // end anonymous namespace
+
+// --- Constructor / Destructor ---
+
+MockWeatherServer::MockWeatherServer(MockServerConfig cfg)
+    : config(std::move(cfg)), boundPort(-1), requestCount(0), injectedErrors(0) {}
+
+MockWeatherServer::~MockWeatherServer() {
+    stop();
+}
+
+// --- Lifecycle ---
+
+bool MockWeatherServer::loadFixtures() {
+    if (config.fixtureDir.empty()) { return true; } // Synthetic mode, nothing to load.
+
+    std::string dir = config.fixtureDir;
+    if (dir.back() != '/' && dir.back() != '\\') { dir += '/'; }
+    // Each fixture is optional; endpoints without one fall back to synthetic data.
+    bool hasCurrent = readFile(dir + "current.json", currentFixture);
+    bool hasForecast = readFile(dir + "forecast.json", forecastFixture);
+    if (!hasCurrent && !hasForecast) {
+        std::cerr << "Error: No current.json or forecast.json found in fixture directory '" << config.fixtureDir << "'." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void MockWeatherServer::registerRoutes() {
+    server->Get("/v1/current.json", [this](const httplib::Request& req, httplib::Response& res) {
+        handleCurrent(req, res);
+    });
+    server->Get("/v1/forecast.json", [this](const httplib::Request& req, httplib::Response& res) {
+        handleForecast(req, res);
+    });
+}
+
+bool MockWeatherServer::bindServer() {
+    if (!loadFixtures()) { return false; }
+
+    server = std::make_unique<httplib::Server>();
+    int threads = std::max(1, config.workerThreads);
+    server->new_task_queue = [threads] { return new httplib::ThreadPool(static_cast<size_t>(threads)); };
+    registerRoutes();
+
+    if (config.port == 0) {
+        boundPort = server->bind_to_any_port(config.host);
+    } else if (server->bind_to_port(config.host, config.port)) {
+        boundPort = config.port;
+    } else {
+        boundPort = -1;
+    }
+    if (boundPort < 0) {
+        std::cerr << "Error: Mock server could not bind to " << config.host << ":" << config.port << "." << std::endl;
+        server.reset();
+        return false;
+    }
+    return true;
+}
+
+bool MockWeatherServer::start() {
+    if (!bindServer()) { return false; }
+    serverThread = std::thread([this] { server->listen_after_bind(); });
+    return true;
+}
+
+bool MockWeatherServer::run() {
+    if (!bindServer()) { return false; }
+    std::cout << "Mock WeatherAPI listening on " << getBaseUrl()
+              << (config.fixtureDir.empty() ? " (synthetic data)" : " (fixtures: " + config.fixtureDir + ")") << std::endl;
+    return server->listen_after_bind();
+}
+
+void MockWeatherServer::stop() {
+    if (server) { server->stop(); }
+    if (serverThread.joinable()) { serverThread.join(); }
+}
+
+// --- Accessors ---
+
+int MockWeatherServer::getPort() const { return boundPort; }
+std::string MockWeatherServer::getBaseUrl() const { return "http://" + config.host + ":" + std::to_string(boundPort); }
+unsigned long long MockWeatherServer::getRequestCount() const { return requestCount.load(); }
+unsigned long long MockWeatherServer::getInjectedErrorCount() const { return injectedErrors.load(); }
+
+// --- Request Handling ---
+
+// Sleeps for the configured latency, then decides whether this request fails.
+// Decisions are derived from the request index so a given seed replays the same sequence.
+bool MockWeatherServer::shapeResponse(unsigned long long requestIndex, httplib::Response& res) {
+    uint64_t h = mix(static_cast<uint64_t>(config.seed) ^ (requestIndex * 0x2545F4914F6CDD1DULL));
+
+    int delayMs = config.latencyMs;
+    if (config.jitterMs > 0) {
+        delayMs += static_cast<int>(unitRandom(mix(h + 1)) * (config.jitterMs + 1));
+    }
+    if (config.tailRate > 0.0 && unitRandom(mix(h + 2)) < config.tailRate) {
+        delayMs += config.tailLatencyMs;
+    }
+    if (delayMs > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+    }
+
+    if (config.errorRate > 0.0 && unitRandom(mix(h + 3)) < config.errorRate) {
+        injectedErrors++;
+        if (config.errorStatus == 429) {
+            res.set_header("Retry-After", std::to_string(config.retryAfterSeconds));
+        }
+        writeApiError(res, config.errorStatus, 9999, "Injected failure from mock server.");
+        return true;
+    }
+    return false;
+}
+
+bool MockWeatherServer::validateRequest(const httplib::Request& req, httplib::Response& res) const {
+    if (!req.has_param("key") || req.get_param_value("key").empty()) {
+        writeApiError(res, 401, 1002, "API key is invalid or not provided.");
+        return false;
+    }
+    if (!req.has_param("q") || req.get_param_value("q").empty()) {
+        writeApiError(res, 400, 1003, "Parameter q is missing.");
+        return false;
+    }
+    return true;
+}
+
+void MockWeatherServer::handleCurrent(const httplib::Request& req, httplib::Response& res) {
+    unsigned long long index = requestCount++;
+    if (shapeResponse(index, res) || !validateRequest(req, res)) { return; }
+
+    if (!currentFixture.empty()) {
+        res.set_content(currentFixture, "application/json");
+        return;
+    }
+    long long epoch = config.baseEpoch != 0 ? config.baseEpoch : static_cast<long long>(std::time(nullptr));
+    res.set_content(makeCurrentJson(req.get_param_value("q"), epoch, config.seed, config.paddingBytes),
+                    "application/json");
+}
+
+void MockWeatherServer::handleForecast(const httplib::Request& req, httplib::Response& res) {
+    unsigned long long index = requestCount++;
+    if (shapeResponse(index, res) || !validateRequest(req, res)) { return; }
+
+    int days = 1;
+    if (req.has_param("days")) {
+        days = std::atoi(req.get_param_value("days").c_str());
+    }
+    days = std::max(1, std::min(14, days)); // WeatherAPI serves at most 14 days.
+
+    if (!forecastFixture.empty()) {
+        // Trim the fixture to the requested number of days so 'days' behaves as upstream.
+        try {
+            json data = json::parse(forecastFixture);
+            auto& forecastDays = data["forecast"]["forecastday"];
+            if (forecastDays.is_array() && forecastDays.size() > static_cast<size_t>(days)) {
+                forecastDays.erase(forecastDays.begin() + days, forecastDays.end());
+            }
+            res.set_content(data.dump(), "application/json");
+        } catch (const json::exception& e) {
+            writeApiError(res, 500, 9999, std::string("Invalid forecast fixture: ") + e.what());
+        }
+        return;
+    }
+    long long epoch = config.baseEpoch != 0 ? config.baseEpoch : static_cast<long long>(std::time(nullptr));
+    res.set_content(makeForecastJson(req.get_param_value("q"), days, epoch, config.seed, config.paddingBytes),
+                    "application/json");
+}
+
+// --- Synthetic Payload Generators ---
+
+std::string MockWeatherServer::makeCurrentJson(const std::string& query, long long epoch,
+                                               unsigned int seed, int paddingBytes) {
+    SiteInfo site = resolveSite(query);
+    // WeatherAPI refreshes current conditions every 15 minutes.
+    long long lastUpdated = epoch - (epoch % 900);
+
+    json current = makeConditions(site, lastUpdated, seed);
+    current["last_updated_epoch"] = lastUpdated;
+    current["last_updated"] = formatLocal(lastUpdated + site.utcOffset, true);
+
+    json payload{{"location", makeLocationBlock(site, epoch)}, {"current", std::move(current)}};
+    addPadding(payload, paddingBytes);
+    return payload.dump();
+}
+
+std::string MockWeatherServer::makeForecastJson(const std::string& query, int days, long long epoch,
+                                                unsigned int seed, int paddingBytes) {
+    SiteInfo site = resolveSite(query);
+    // Days start at local midnight, expressed as UTC epochs.
+    long long localMidnight = floorDiv(epoch + site.utcOffset, 86400) * 86400 - site.utcOffset;
+
+    json forecastDays = json::array();
+    for (int d = 0; d < days; ++d) {
+        long long dayStart = localMidnight + static_cast<long long>(d) * 86400;
+        json hours = json::array();
+        double maxT = -1e9, minT = 1e9, sumT = 0.0, maxWind = 0.0, totalPrecip = 0.0;
+        double sumVis = 0.0, sumHumidity = 0.0, maxUv = 0.0;
+        int maxChanceRain = 0;
+
+        for (int h = 0; h < 24; ++h) {
+            long long hourEpoch = dayStart + h * 3600LL;
+            json hour = makeConditions(site, hourEpoch, seed);
+            hour["time_epoch"] = hourEpoch;
+            hour["time"] = formatLocal(hourEpoch + site.utcOffset, true);
+
+            double t = hour["temp_c"].get<double>();
+            maxT = std::max(maxT, t);
+            minT = std::min(minT, t);
+            sumT += t;
+            maxWind = std::max(maxWind, hour["wind_kph"].get<double>());
+            totalPrecip += hour["precip_mm"].get<double>();
+            sumVis += hour["vis_km"].get<double>();
+            sumHumidity += hour["humidity"].get<double>();
+            maxUv = std::max(maxUv, hour["uv"].get<double>());
+            maxChanceRain = std::max(maxChanceRain, hour["chance_of_rain"].get<int>());
+            hours.push_back(std::move(hour));
+        }
+
+        auto toF = [](double c) { return round1(c * 9.0 / 5.0 + 32.0); };
+        double avgT = sumT / 24.0;
+        json day{
+            {"maxtemp_c", round1(maxT)}, {"maxtemp_f", toF(maxT)},
+            {"mintemp_c", round1(minT)}, {"mintemp_f", toF(minT)},
+            {"avgtemp_c", round1(avgT)}, {"avgtemp_f", toF(avgT)},
+            {"maxwind_kph", round1(maxWind)}, {"maxwind_mph", round1(maxWind / 1.609344)},
+            {"totalprecip_mm", round1(totalPrecip)}, {"totalprecip_in", round2(totalPrecip / 25.4)},
+            {"avgvis_km", round1(sumVis / 24.0)}, {"avgvis_miles", round1(sumVis / 24.0 / 1.609344)},
+            {"avghumidity", std::round(sumHumidity / 24.0)},
+            {"daily_will_it_rain", maxChanceRain > 60 ? 1 : 0},
+            {"daily_chance_of_rain", maxChanceRain},
+            {"daily_will_it_snow", 0},
+            {"daily_chance_of_snow", 0},
+            {"condition", {{"text", totalPrecip > 0.0 ? "Patchy rain possible" : "Sunny"},
+                           {"icon", "//cdn.weatherapi.com/weather/64x64/day/176.png"},
+                           {"code", totalPrecip > 0.0 ? 1063 : 1000}}},
+            {"uv", maxUv}
+        };
+
+        forecastDays.push_back(json{
+            {"date", formatLocal(dayStart + site.utcOffset, false)},
+            {"date_epoch", floorDiv(dayStart + site.utcOffset, 86400) * 86400},
+            {"day", std::move(day)},
+            {"hour", std::move(hours)}
+        });
+    }
+
+    long long lastUpdated = epoch - (epoch % 900);
+    json current = makeConditions(site, lastUpdated, seed);
+    current["last_updated_epoch"] = lastUpdated;
+    current["last_updated"] = formatLocal(lastUpdated + site.utcOffset, true);
+
+    json payload{
+        {"location", makeLocationBlock(site, epoch)},
+        {"current", std::move(current)},
+        {"forecast", {{"forecastday", std::move(forecastDays)}}}
+    };
+    addPadding(payload, paddingBytes);
+    return payload.dump();
+}
@@ -0,0 +1,114 @@
+// MockWeatherServer.h
+#ifndef MOCKWEATHERSERVER_H
+#define MOCKWEATHERSERVER_H
+
+#include <string>  // For host, fixture paths and generated payloads
+#include <memory>  // For std::unique_ptr (server instance)
+#include <thread>  // For running the server in the background
+#include <atomic>  // For request counters shared between handler threads
+
+namespace httplib { class Server; struct Request; struct Response; } // Forward declare external library classes
+
+// Settings controlling how the mock server behaves.
+// Defaults produce a fast, error-free server on localhost.
+struct MockServerConfig {
+    std::string host = "127.0.0.1"; // Interface to bind to.
+    int port = 8080;                // Port to listen on (0 = pick any free port).
+    int workerThreads = 16;         // Number of handler threads (bounds concurrent requests).
+
+    // --- Latency Shaping ---
+    int latencyMs = 0;              // Fixed delay added to every response.
+    int jitterMs = 0;               // Random extra delay in [0, jitterMs] per response.
+    double tailRate = 0.0;          // Fraction of responses that are "slow" (0.0 - 1.0).
+    int tailLatencyMs = 0;          // Extra delay applied to slow responses.
+
+    // --- Failure Injection ---
+    double errorRate = 0.0;         // Fraction of requests answered with 'errorStatus' (0.0 - 1.0).
+    int errorStatus = 500;          // HTTP status used for injected failures (e.g. 429, 500, 503).
+    int retryAfterSeconds = 1;      // Value of the Retry-After header sent with injected 429s.
+
+    // --- Payload Shaping ---
+    int paddingBytes = 0;           // Extra bytes added to every payload to simulate larger responses.
+    std::string fixtureDir;         // If set, serve "current.json"/"forecast.json" from this directory.
+    long long baseEpoch = 0;        // Start time for synthetic data (0 = use the current time).
+    unsigned int seed = 42;         // Seed for all pseudo-random decisions (data, latency, errors).
+};
+
+// Local stand-in for api.weatherapi.com, built on the cpp-httplib Server.
+// Serves "/v1/current.json" and "/v1/forecast.json" with the same JSON shape as WeatherAPI,
+// either from fixture files or from a deterministic synthetic generator.
+// Point an APIConverter at it with e.g. APIConverter("http://127.0.0.1:8080").
+class MockWeatherServer {
+private:
+    MockServerConfig config;                 // Behaviour settings.
+    std::unique_ptr<httplib::Server> server; // Underlying HTTP server.
+    std::thread serverThread;                // Background listener thread (used by start()).
+    int boundPort;                           // Port actually bound (differs from config when port is 0).
+
+    std::string currentFixture;              // Contents of current.json (empty if not using fixtures).
+    std::string forecastFixture;             // Contents of forecast.json (empty if not using fixtures).
+
+    std::atomic<unsigned long long> requestCount;  // Total requests received.
+    std::atomic<unsigned long long> injectedErrors; // Requests answered with an injected error.
+
+    // --- Private Helpers ---
+
+    // Reads fixture files if a fixture directory is configured. Returns false on read error.
+    bool loadFixtures();
+    // Registers the HTTP route handlers on the server.
+    void registerRoutes();
+    // Loads fixtures, creates the server and binds the configured port. Returns false on failure.
+    bool bindServer();
+    // Applies latency and failure injection for one request.
+    // Returns true if an error response was written and the handler should stop.
+    bool shapeResponse(unsigned long long requestIndex, httplib::Response& res);
+    // Handles "/v1/current.json".
+    void handleCurrent(const httplib::Request& req, httplib::Response& res);
+    // Handles "/v1/forecast.json".
+    void handleForecast(const httplib::Request& req, httplib::Response& res);
+    // Validates the "key" and "q" parameters, writing a WeatherAPI-style error if missing.
+    bool validateRequest(const httplib::Request& req, httplib::Response& res) const;
+
+public:
+    // Constructor: Stores the configuration. Call start() or run() to begin serving.
+    explicit MockWeatherServer(MockServerConfig cfg = MockServerConfig());
+    // Destructor: Stops the server and joins the background thread if running.
+    ~MockWeatherServer();
+
+    // Disable copy operations (owns a server and a thread).
+    MockWeatherServer(const MockWeatherServer&) = delete;
+    MockWeatherServer& operator=(const MockWeatherServer&) = delete;
+
+    // --- Lifecycle ---
+
+    // Binds the port and serves requests on a background thread.
+    // Returns false if fixtures could not be loaded or the port could not be bound.
+    bool start();
+    // Binds the port and serves requests on the calling thread until stop() is called.
+    bool run();
+    // Stops serving requests and joins the background thread (if any).
+    void stop();
+
+    // --- Accessors ---
+
+    // Returns the bound port (valid after a successful start()/run()).
+    int getPort() const;
+    // Returns the base URL to pass to APIConverter (e.g. "http://127.0.0.1:8080").
+    std::string getBaseUrl() const;
+    // Returns the total number of requests received so far.
+    unsigned long long getRequestCount() const;
+    // Returns the number of requests answered with an injected error.
+    unsigned long long getInjectedErrorCount() const;
+
+    // --- Synthetic Payload Generators ---
+    // Also usable without a running server (e.g. for parse benchmarks).
+
+    // Builds a "/v1/current.json" response body for the given location query.
+    static std::string makeCurrentJson(const std::string& query, long long epoch,
+                                       unsigned int seed = 42, int paddingBytes = 0);
+    // Builds a "/v1/forecast.json" response body with 'days' days of 24 hourly entries each.
+    static std::string makeForecastJson(const std::string& query, int days, long long epoch,
+                                        unsigned int seed = 42, int paddingBytes = 0);
+};
+
+#endif // MOCKWEATHERSERVER_H
@@ -0,0 +1,168 @@
+// ParseBenchmark.cpp - Measures the per-field cost of reading hourly forecast blocks
+#include "JsonFields.h"        // The field access layer under test
+#include "APIConverter.h"      // End-to-end forecast parsing (parseForecastReport)
+#include "ForecastReport.h"    // Detail level for parsing
+#include "MockWeatherServer.h" // Synthetic forecast payloads
+#include "WeatherQuery.h"      // Units for parsing
+#include "nlohmann/json.hpp"   // Parsed payloads
+
+#include <iostream>  // For console output (cout, cerr)
+#include <iomanip>   // For table formatting
+#include <string>    // For payloads and argument parsing
+#include <vector>    // For the hour blocks
+#include <chrono>    // For timing
+#include <cstdlib>   // For atoi
+
+namespace {
+    using json = nlohmann::json;
+
+    // Benchmark settings (overridable from the command line).
+    struct BenchmarkConfig {
+        int days = 14;          // Days per forecast payload (24 hour blocks each).
+        int iterations = 2000;  // Passes over all hour blocks per field access strategy.
+        int parses = 200;       // Whole-response parses for the end-to-end timing.
+    };
+
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "  --days N        Days per forecast payload (default 14)\n"
+                  << "  --iterations N  Passes over all hour blocks per strategy (default 2000)\n"
+                  << "  --parses N      Whole-response parses for the end-to-end timing (default 200)\n";
+    }
+
+    // The members an eager metric hour reads: the decoded properties, the precip chances and
+    // the epoch (temp_c, humidity and wind_kph are read again as derived-metric inputs).
+    enum BenchField {
+        F_TIME_EPOCH, F_TEMP_C, F_FEELSLIKE_C, F_WIND_KPH, F_WIND_DEGREE, F_HUMIDITY, F_VIS_KM,
+        F_GUST_KPH, F_PRECIP_MM, F_CLOUD, F_PRESSURE_MB, F_CHANCE_OF_RAIN, F_CHANCE_OF_SNOW, FIELD_COUNT
+    };
+    constexpr const char* FIELD_NAMES[FIELD_COUNT] = {
+        "time_epoch", "temp_c", "feelslike_c", "wind_kph", "wind_degree", "humidity", "vis_km",
+        "gust_kph", "precip_mm", "cloud", "pressure_mb", "chance_of_rain", "chance_of_snow"};
+    constexpr auto FIELD_TABLE = JsonFields::makeTable(FIELD_NAMES);
+    const int READS_PER_HOUR = FIELD_COUNT + 3;
+
+    // --- Previous Helpers (contains() + operator[], std::string keys) ---
+    double lookupDouble(const json& obj, const std::string& key, double defaultVal = 0.0) {
+        return obj.contains(key) && obj[key].is_number() ? obj[key].get<double>() : defaultVal;
+    }
+    long long lookupLong(const json& obj, const std::string& key, long long defaultVal = 0) {
+        return obj.contains(key) && obj[key].is_number_integer() ? obj[key].get<long long>() : defaultVal;
+    }
+
+    // Reads every field of an hour; 'read(field)' returns its value as a double.
+    template <typename Reader>
+    double readHour(const Reader& read) {
+        double sum = read(F_TIME_EPOCH);
+        for (int field = F_TEMP_C; field < FIELD_COUNT; ++field) { sum += read(field); }
+        return sum + read(F_TEMP_C) + read(F_HUMIDITY) + read(F_WIND_KPH);
+    }
+
+    double readPrevious(const json& hour) {
+        return readHour([&](int field) {
+            return field == F_TIME_EPOCH ? static_cast<double>(lookupLong(hour, FIELD_NAMES[field]))
+                                         : lookupDouble(hour, FIELD_NAMES[field]);
+        });
+    }
+
+    double readSingleFind(const json& hour) {
+        return readHour([&](int field) {
+            JsonFields::FieldValue value = FIELD_TABLE.find(hour, static_cast<std::size_t>(field));
+            return field == F_TIME_EPOCH ? static_cast<double>(value.integer()) : value.number();
+        });
+    }
+
+    double readResolved(const json& hour) {
+        const auto values = FIELD_TABLE.resolve(hour);
+        return readHour([&](int field) {
+            return field == F_TIME_EPOCH ? static_cast<double>(values[field].integer()) : values[field].number();
+        });
+    }
+
+    // Runs 'read' over every hour block 'iterations' times; returns nanoseconds per hour.
+    template <typename Read>
+    double timeStrategy(const std::vector<const json*>& hours, int iterations, Read read, double& checksum) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            for (const json* hour : hours) { checksum += read(*hour); }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return seconds * 1e9 / (static_cast<double>(iterations) * hours.size());
+    }
+} // end anonymous namespace
+
+int main(int argc, char* argv[]) {
+    BenchmarkConfig config;
+
+    // --- Argument Parsing ---
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for option '" << arg << "'." << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "--days")            { config.days = std::atoi(value); }
+        else if (arg == "--iterations") { config.iterations = std::atoi(value); }
+        else if (arg == "--parses")     { config.parses = std::atoi(value); }
+        else {
+            std::cerr << "Error: Unknown option '" << arg << "'." << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.days < 1 || config.days > 14 || config.iterations < 1 || config.parses < 1) {
+        std::cerr << "Error: --days must be 1-14; --iterations and --parses must be positive." << std::endl;
+        return 1;
+    }
+
+    // --- Payload ---
+    const std::string body = MockWeatherServer::makeForecastJson("48.85,2.35", config.days, 1700000000, 42);
+    const json data = json::parse(body);
+    std::vector<const json*> hours;
+    for (const auto& day : data["forecast"]["forecastday"]) {
+        for (const auto& hour : day["hour"]) { hours.push_back(&hour); }
+    }
+    std::cout << hours.size() << " hour blocks (" << hours[0]->size() << " members each), "
+              << READS_PER_HOUR << " field reads per hour, " << config.iterations << " passes\n" << std::endl;
+
+    // --- Field Access Strategies ---
+    double checksums[3] = {0.0, 0.0, 0.0};
+    const char* names[3] = {"contains + operator[]", "single find", "one-pass resolve"};
+    double perHour[3];
+    perHour[0] = timeStrategy(hours, config.iterations, readPrevious, checksums[0]);
+    perHour[1] = timeStrategy(hours, config.iterations, readSingleFind, checksums[1]);
+    perHour[2] = timeStrategy(hours, config.iterations, readResolved, checksums[2]);
+
+    std::cout << std::left << std::setw(24) << "Strategy" << std::right
+              << std::setw(12) << "ns/hour" << std::setw(12) << "ns/field" << std::setw(10) << "Speedup" << std::endl;
+    for (int s = 0; s < 3; ++s) {
+        std::cout << std::left << std::setw(24) << names[s] << std::right << std::fixed
+                  << std::setw(12) << std::setprecision(1) << perHour[s]
+                  << std::setw(12) << std::setprecision(1) << perHour[s] / READS_PER_HOUR
+                  << std::setw(9) << std::setprecision(2) << perHour[0] / perHour[s] << "x" << std::endl;
+    }
+    if (checksums[0] != checksums[1] || checksums[0] != checksums[2]) {
+        std::cerr << "Error: Strategies read different values." << std::endl;
+        return 1;
+    }
+
+    // --- End to End (parse + build, eager decoding) ---
+    const WeatherQuery query("bench", "bench", "Metric");
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < config.parses; ++i) {
+        if (!APIConverter::parseForecastReport(body, query, ForecastReport::DetailLevel::HOURLY)) {
+            std::cerr << "Error: Forecast failed to parse." << std::endl;
+            return 1;
+        }
+    }
+    double parseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / config.parses;
+    std::cout << "\nparseForecastReport: " << std::setprecision(3) << parseMs << " ms per "
+              << body.size() / 1024 << " KiB response" << std::endl;
+    return 0;
+}
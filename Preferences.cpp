@@ -1,12 +1,15 @@
 // Preferences.cpp
 #include "Preferences.h"
-#include <fstream>   // For file stream operations (ifstream, ofstream)
+#include "AtomicFileWriter.h" // Atomic saves
+#include "BudgetCache.h"      // Eviction policy names
+#include <fstream>   // For reading the settings file (ifstream)
 #include <iostream>  // For error/info messages (cerr, cout)
-#include <sstream>   // For parsing lines from the settings file (istringstream)
+#include <sstream>   // For building the settings text (ostringstream)
 #include <string>    // For string operations
-#include <algorithm> // For std::transform (used in toLower)
+#include <algorithm> // For std::transform (used in toLower), std::min/max
 #include <cctype>    // For std::tolower
-#include <stdexcept> // For exception handling during string conversion (stoi)
+#include <cerrno>    // For errno (number range checks)
+#include <cstdlib>   // For std::strtoll, std::strtod
 
 // --- Internal Helper Functions (Anonymous Namespace) ---
 namespace {
@@ -27,6 +30,38 @@ namespace {
                        [](unsigned char c){ return std::tolower(c); });
         return lowerStr;
     }
+
+    // Whitespace as trimmed from keys and values.
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    // Narrows [begin, end) of 'text' to exclude surrounding whitespace.
+    void trimRange(const std::string& text, size_t& begin, size_t& end) {
+        while (begin < end && isSpace(text[begin])) { ++begin; }
+        while (end > begin && isSpace(text[end - 1])) { --end; }
+    }
+
+    // Parses a whole decimal integer. Returns false for empty, partial or out-of-range input.
+    bool parseInteger(const std::string& value, long long& result) {
+        char* end = nullptr;
+        errno = 0;
+        result = std::strtoll(value.c_str(), &end, 10);
+        return end != value.c_str() && *end == '\0' && errno != ERANGE;
+    }
+
+    // Parses a whole floating-point number, with the same rules as parseInteger.
+    bool parseDouble(const std::string& value, double& result) {
+        char* end = nullptr;
+        errno = 0;
+        result = std::strtod(value.c_str(), &end);
+        return end != value.c_str() && *end == '\0' && errno != ERANGE;
+    }
+
+    // Prints the warning for a malformed number in the settings file.
+    void warnNumber(const std::string& key, const std::string& value) {
+        std::cerr << "Warning: Invalid number format for '" << key << "' ('" << value << "') in settings file." << std::endl;
+    }
 } // end anonymous namespace
 
 // --- Private Class Helpers (Calling internal helpers) ---
@@ -43,12 +78,29 @@ void Preferences::loadDefaults() {
     units = "Metric";     // Default units.
     datamode = "advanced";// Default data mode (currently unused).
     forecastDays = 3;     // Default number of forecast days.
+    apiBaseUrl = "http://api.weatherapi.com"; // Real WeatherAPI endpoint.
+    metricsPort = 0;      // Metrics endpoint disabled by default.
+    traceFile = "";       // Tracing disabled by default.
+    rateLimit = 5.0;      // At most 5 API calls per second.
+    monthlyQuota = 1000000; // WeatherAPI free plan allowance.
+    cacheTtl = 0;         // Every request goes to the API by default.
+    ioThreads = 8;        // Matches the TaskScheduler default.
+    cpuThreads = 0;       // One worker per core.
+    profiles.clear();     // No saved locations.
+    activeProfile = "";
+    watchlist.clear();    // Empty dashboard.
+    refreshInterval = 300; // Dashboard entries are refetched after 5 minutes.
+    cacheBudgetMb = 64;   // Each cache stays under 64 MiB.
+    cachePolicy = "lru";  // Least recently used goes first.
+    locationGrid = 0.01;  // Coordinates snap to ~1 km cells.
+    locationRadius = 2.0; // Coordinate queries within 2 km of a known site reuse it.
 }
 
 // --- Constructor ---
 
 // Initializes preferences: loads defaults, then attempts to load from file.
-Preferences::Preferences(const std::string& filename) : settingsFilename(filename) {
+Preferences::Preferences(const std::string& filename)
+    : settingsFilename(filename) {
     loadDefaults(); // Establish baseline defaults.
     loadSettings(); // Override defaults with values from file, if successful.
 }
@@ -59,13 +111,40 @@ const std::string& Preferences::getLocation() const { return location; }
 const std::string& Preferences::getUnits() const { return units; }
 const std::string& Preferences::getDataMode() const { return datamode; }
 int Preferences::getForecastDays() const { return forecastDays; }
+const std::string& Preferences::getApiBaseUrl() const { return apiBaseUrl; }
+int Preferences::getMetricsPort() const { return metricsPort; }
+const std::string& Preferences::getTraceFile() const { return traceFile; }
+double Preferences::getRateLimit() const { return rateLimit; }
+long long Preferences::getMonthlyQuota() const { return monthlyQuota; }
+int Preferences::getCacheTtl() const { return cacheTtl; }
+int Preferences::getIoThreads() const { return ioThreads; }
+int Preferences::getCpuThreads() const { return cpuThreads; }
+const std::vector<LocationProfile>& Preferences::getProfiles() const { return profiles; }
+const std::string& Preferences::getActiveProfile() const { return activeProfile; }
+const std::vector<std::string>& Preferences::getWatchlist() const { return watchlist; }
+int Preferences::getRefreshInterval() const { return refreshInterval; }
+int Preferences::getCacheBudgetMb() const { return cacheBudgetMb; }
+const std::string& Preferences::getCachePolicy() const { return cachePolicy; }
+double Preferences::getLocationGrid() const { return locationGrid; }
+double Preferences::getLocationRadius() const { return locationRadius; }
+const std::string& Preferences::getSettingsFilename() const { return settingsFilename; }
+
+// Replaces the file name part of 'settingsFilename' with 'filename'.
+std::string Preferences::pathNextToSettings(const std::string& filename) const {
+    size_t slash = settingsFilename.find_last_of("/\\");
+    if (slash == std::string::npos) { return filename; }
+    return settingsFilename.substr(0, slash + 1) + filename;
+}
 
 // --- Setters ---
 
 // Sets the API key directly.
 void Preferences::setApiKey(const std::string& key) { apiKey = key; }
-// Sets the location after trimming whitespace.
-void Preferences::setLocation(const std::string& loc) { location = trimInternal(loc); }
+// Sets the location after trimming whitespace. A location set by hand ends the active profile.
+void Preferences::setLocation(const std::string& loc) {
+    location = trimInternal(loc);
+    activeProfile.clear();
+}
 
 // Sets the units if the provided string is valid ("Metric" or "Imperial").
 // Returns true if set successfully, false otherwise (prints warning).
@@ -95,85 +174,412 @@ bool Preferences::setForecastDays(int days) {
     return false;
 }
 
+// Sets the API base URL after trimming whitespace, falling back to the real WeatherAPI endpoint.
+void Preferences::setApiBaseUrl(const std::string& url) {
+    std::string trimmedUrl = trimInternal(url);
+    apiBaseUrl = trimmedUrl.empty() ? "http://api.weatherapi.com" : trimmedUrl;
+}
+
+// Sets the metrics port if the value is a valid TCP port or 0 (disabled).
+// Returns true if set successfully, false otherwise (prints warning).
+bool Preferences::setMetricsPort(int port) {
+    if (port >= 0 && port <= 65535) {
+        metricsPort = port;
+        return true;
+    }
+    std::cerr << "Warning: Invalid metrics port '" << port << "' (must be 0-65535). Metrics port remains '" << metricsPort << "'." << std::endl;
+    return false;
+}
+
+// Sets the trace output path after trimming whitespace.
+void Preferences::setTraceFile(const std::string& path) { traceFile = trimInternal(path); }
+
+// Sets the API call rate limit if the value is positive.
+// Returns true if set successfully, false otherwise (prints warning).
+bool Preferences::setRateLimit(double callsPerSecond) {
+    if (callsPerSecond > 0.0) {
+        rateLimit = callsPerSecond;
+        return true;
+    }
+    std::cerr << "Warning: Invalid rate limit '" << callsPerSecond << "' (must be > 0). Rate limit remains '" << rateLimit << "'." << std::endl;
+    return false;
+}
+
+// Sets the monthly API call quota if the value is non-negative (0 = unlimited).
+// Returns true if set successfully, false otherwise (prints warning).
+bool Preferences::setMonthlyQuota(long long calls) {
+    if (calls >= 0) {
+        monthlyQuota = calls;
+        return true;
+    }
+    std::cerr << "Warning: Invalid monthly quota '" << calls << "' (must be >= 0). Monthly quota remains '" << monthlyQuota << "'." << std::endl;
+    return false;
+}
+
+// Sets the response cache lifetime if the value is within [0, 86400] seconds (0 = off).
+// Returns true if set successfully, false otherwise (prints warning).
+bool Preferences::setCacheTtl(int seconds) {
+    if (seconds >= 0 && seconds <= 86400) {
+        cacheTtl = seconds;
+        return true;
+    }
+    std::cerr << "Warning: Invalid cache TTL '" << seconds << "' (must be 0-86400). Cache TTL remains '" << cacheTtl << "'." << std::endl;
+    return false;
+}
+
+// Sets the I/O thread count if the value is within [1, 256].
+// Returns true if set successfully, false otherwise (prints warning).
+bool Preferences::setIoThreads(int count) {
+    if (count >= 1 && count <= 256) {
+        ioThreads = count;
+        return true;
+    }
+    std::cerr << "Warning: Invalid I/O thread count '" << count << "' (must be 1-256). I/O threads remain '" << ioThreads << "'." << std::endl;
+    return false;
+}
+
+// Sets the CPU thread count if the value is within [0, 256] (0 = one per core).
+// Returns true if set successfully, false otherwise (prints warning).
+bool Preferences::setCpuThreads(int count) {
+    if (count >= 0 && count <= 256) {
+        cpuThreads = count;
+        return true;
+    }
+    std::cerr << "Warning: Invalid CPU thread count '" << count << "' (must be 0-256). CPU threads remain '" << cpuThreads << "'." << std::endl;
+    return false;
+}
+
+// Sets the dashboard refresh interval if the value is within [1, 86400] seconds.
+// Returns true if set successfully, false otherwise (prints warning).
+bool Preferences::setRefreshInterval(int seconds) {
+    if (seconds >= 1 && seconds <= 86400) {
+        refreshInterval = seconds;
+        return true;
+    }
+    std::cerr << "Warning: Invalid refresh interval '" << seconds << "' (must be 1-86400). Refresh interval remains '" << refreshInterval << "'." << std::endl;
+    return false;
+}
+
+// Sets the per-cache memory budget if the value is within [0, 1048576] MiB (0 = unlimited).
+// Returns true if set successfully, false otherwise (prints warning).
+bool Preferences::setCacheBudgetMb(int megabytes) {
+    if (megabytes >= 0 && megabytes <= 1048576) {
+        cacheBudgetMb = megabytes;
+        return true;
+    }
+    std::cerr << "Warning: Invalid cache budget '" << megabytes << "' (must be 0-1048576 MiB). Cache budget remains '" << cacheBudgetMb << "'." << std::endl;
+    return false;
+}
+
+// Sets the cache eviction policy if the name is known ("lru", "lfu" or "ttl").
+// Returns true if set successfully, false otherwise (prints warning).
+bool Preferences::setCachePolicy(const std::string& policy) {
+    std::string name = toLowerInternal(trimInternal(policy));
+    EvictionPolicy parsed;
+    if (parseEvictionPolicy(name, parsed)) {
+        cachePolicy = name;
+        return true;
+    }
+    std::cerr << "Warning: Invalid cache policy '" << policy << "' (must be lru, lfu or ttl). Cache policy remains '" << cachePolicy << "'." << std::endl;
+    return false;
+}
+
+// Sets the coordinate snapping grid if the value is within [0, 1] degrees (0 = off).
+// Returns true if set successfully, false otherwise (prints warning).
+bool Preferences::setLocationGrid(double degrees) {
+    if (degrees >= 0.0 && degrees <= 1.0) {
+        locationGrid = degrees;
+        return true;
+    }
+    std::cerr << "Warning: Invalid location grid '" << degrees << "' (must be 0-1 degrees). Location grid remains '" << locationGrid << "'." << std::endl;
+    return false;
+}
+
+// Sets the known-site reuse radius if the value is within [0, 50] km (0 = off).
+// Returns true if set successfully, false otherwise (prints warning).
+bool Preferences::setLocationRadius(double kilometres) {
+    if (kilometres >= 0.0 && kilometres <= 50.0) {
+        locationRadius = kilometres;
+        return true;
+    }
+    std::cerr << "Warning: Invalid location radius '" << kilometres << "' (must be 0-50 km). Location radius remains '" << locationRadius << "'." << std::endl;
+    return false;
+}
+
+// --- Location Profiles ---
+
+// Adds profile 'name', replacing an existing profile of the same (case-insensitive) name.
+bool Preferences::addProfile(const std::string& name, const std::string& loc, const std::string& unit) {
+    LocationProfile profile{toLowerInternal(trimInternal(name)), trimInternal(loc), trimInternal(unit)};
+    if (profile.name.empty() || profile.location.empty() || profile.name.find('|') != std::string::npos) {
+        std::cerr << "Warning: Invalid profile '" << name << "' (needs a name without '|' and a location)." << std::endl;
+        return false;
+    }
+    if (!profile.units.empty() && profile.units != "Metric" && profile.units != "Imperial") {
+        std::cerr << "Warning: Invalid unit '" << unit << "' for profile '" << profile.name << "'." << std::endl;
+        return false;
+    }
+    for (auto& existing : profiles) {
+        if (existing.name == profile.name) {
+            existing = profile;
+            return true;
+        }
+    }
+    profiles.push_back(profile);
+    return true;
+}
+
+// Removes profile 'name'; ends it if it was active.
+bool Preferences::removeProfile(const std::string& name) {
+    std::string key = toLowerInternal(trimInternal(name));
+    for (auto it = profiles.begin(); it != profiles.end(); ++it) {
+        if (it->name == key) {
+            profiles.erase(it);
+            if (activeProfile == key) { activeProfile.clear(); }
+            return true;
+        }
+    }
+    return false;
+}
+
+// Applies profile 'name' to the location (and units) used by the next request.
+bool Preferences::useProfile(const std::string& name) {
+    std::string key = toLowerInternal(trimInternal(name));
+    for (const auto& profile : profiles) {
+        if (profile.name == key) {
+            location = profile.location;
+            if (!profile.units.empty()) { units = profile.units; }
+            activeProfile = profile.name;
+            return true;
+        }
+    }
+    return false;
+}
+
+// --- Watchlist ---
+
+// Appends 'loc' unless it is already listed.
+bool Preferences::addToWatchlist(const std::string& loc) {
+    std::string trimmed = trimInternal(loc);
+    if (trimmed.empty()) { return false; }
+    std::string key = toLowerInternal(trimmed);
+    for (const auto& existing : watchlist) {
+        if (toLowerInternal(existing) == key) { return false; }
+    }
+    watchlist.push_back(trimmed);
+    return true;
+}
+
+// Removes 'loc', keeping the order of the others.
+bool Preferences::removeFromWatchlist(const std::string& loc) {
+    std::string key = toLowerInternal(trimInternal(loc));
+    for (auto it = watchlist.begin(); it != watchlist.end(); ++it) {
+        if (toLowerInternal(*it) == key) {
+            watchlist.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
 // --- File Operations ---
 
-// Loads settings from the file specified by 'settingsFilename'.
-// Parses lines in "key:value" format.
-bool Preferences::loadSettings() {
-    std::ifstream infile(settingsFilename);
-    if (!infile.is_open()) {
-        // Informative message if file doesn't exist or can't be opened.
-        std::cerr << "Info: Could not open settings file '" << settingsFilename << "'. Using default/current settings." << std::endl;
-        // Optionally, create a default file here on first run if desired: saveSettings();
-        return false; // Indicate file wasn't read, though not necessarily an error state.
+// Reads the whole file with one read, so parsing works on a single in-memory buffer.
+bool Preferences::readSettingsFile(std::string& text) const {
+    std::ifstream infile(settingsFilename, std::ios::binary);
+    if (!infile.is_open()) { return false; }
+    infile.seekg(0, std::ios::end);
+    std::streamoff size = infile.tellg();
+    if (size < 0) { return false; }
+    text.resize(static_cast<size_t>(size));
+    infile.seekg(0, std::ios::beg);
+    infile.read(&text[0], size);
+    text.resize(static_cast<size_t>(infile.gcount()));
+    return true;
+}
+
+// Applies one "key:value" setting. Numbers go through the validating setters.
+bool Preferences::applySetting(const std::string& key, const std::string& value) {
+    long long number = 0;
+    if (key == "apikey")        { setApiKey(value); return true; }
+    if (key == "location")      { location = trimInternal(value); return true; } // Keeps the active profile.
+    if (key == "units")         { return setUnits(value); }
+    if (key == "datamode")      { setDataMode(value); return true; }
+    if (key == "apiurl")        { setApiBaseUrl(value); return true; }
+    if (key == "tracefile")     { setTraceFile(value); return true; }
+    if (key == "cachepolicy")   { return setCachePolicy(value); }
+    if (key == "ratelimit" || key == "locationgrid" || key == "locationradius") {
+        double decimal = 0.0;
+        if (!parseDouble(value, decimal)) {
+            warnNumber(key, value);
+            return false;
+        }
+        if (key == "locationgrid")   { return setLocationGrid(decimal); }
+        if (key == "locationradius") { return setLocationRadius(decimal); }
+        return setRateLimit(decimal);
+    }
+    if (key == "forecastdays" || key == "metricsport" || key == "monthlyquota" || key == "cachettl" ||
+        key == "iothreads" || key == "cputhreads" || key == "refreshinterval" || key == "cachebudget") {
+        if (!parseInteger(value, number)) {
+            warnNumber(key, value);
+            return false;
+        }
+        if (key == "monthlyquota") { return setMonthlyQuota(number); }
+        // Out-of-int-range values are rejected by the setters' range checks.
+        int clamped = static_cast<int>(std::max<long long>(-1, std::min<long long>(number, 1000000000LL)));
+        if (key == "forecastdays") { return setForecastDays(clamped); }
+        if (key == "metricsport")  { return setMetricsPort(clamped); }
+        if (key == "cachettl")     { return setCacheTtl(clamped); }
+        if (key == "iothreads")    { return setIoThreads(clamped); }
+        if (key == "refreshinterval") { return setRefreshInterval(clamped); }
+        if (key == "cachebudget")  { return setCacheBudgetMb(clamped); }
+        return setCpuThreads(clamped);
+    }
+    if (key == "watch") { return addToWatchlist(value); } // One line per watchlist location.
+    if (key == "profile") { // "profile:<name>|<location>[|<units>]"
+        size_t first = value.find('|');
+        if (first == std::string::npos) {
+            std::cerr << "Warning: Invalid profile '" << value << "' in settings file (expected name|location[|units])." << std::endl;
+            return false;
+        }
+        size_t second = value.find('|', first + 1);
+        std::string unit = (second == std::string::npos) ? "" : value.substr(second + 1);
+        return addProfile(value.substr(0, first), value.substr(first + 1, second - first - 1), unit);
     }
+    return false; // Silently ignore unknown keys.
+}
+
+// Parses the file contents in one pass over the buffer: each line is split at its first ':'
+// by index, and only the trimmed key and value are copied (into buffers reused across lines).
+bool Preferences::applySettingsText(const std::string& text) {
+    bool loadedSomething = false;
+    std::string key, value;
+    std::string profileName;  // From an "activeprofile" line, applied once all profiles are known.
+    bool sawProfileName = false;
+    std::vector<LocationProfile> previousProfiles;
+    previousProfiles.swap(profiles); // The file's profile list replaces the current one.
+    watchlist.clear();                // So does its watchlist.
 
-    std::string line;
-    bool loadedSomething = false; // Track if any valid settings were loaded.
-    // Read file line by line.
-    while (getline(infile, line)) {
-        std::istringstream linestream(line);
-        std::string key;
-        // Split line at the first colon ':'.
-        if (getline(linestream, key, ':')) {
-            std::string value;
-            getline(linestream, value); // Read the rest of the line as the value.
-            std::string lowerKey = toLowerInternal(trimInternal(key)); // Normalize key.
-            value = trimInternal(value); // Trim value.
-
-            if (value.empty()) continue; // Skip lines with keys but no values.
-
-            // Update corresponding preference based on the lowercase key.
-            if (lowerKey == "apikey")       { setApiKey(value); loadedSomething = true; }
-            else if (lowerKey == "location") { setLocation(value); loadedSomething = true; }
-            else if (lowerKey == "units")    { if(setUnits(value)) loadedSomething = true; } // Use validating setter
-            else if (lowerKey == "datamode") { setDataMode(value); loadedSomething = true; }
-            else if (lowerKey == "forecastdays") {
-                try {
-                    int days = std::stoi(value); // Convert string value to int.
-                    if(setForecastDays(days)) loadedSomething = true; // Use validating setter
-                } catch (const std::invalid_argument&) {
-                    std::cerr << "Warning: Invalid number format for 'forecastdays' ('" << value << "') in settings file." << std::endl;
-                } catch (const std::out_of_range&) {
-                     std::cerr << "Warning: Value for 'forecastdays' ('" << value << "') out of range in settings file." << std::endl;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t lineEnd = text.find('\n', pos);
+        if (lineEnd == std::string::npos) { lineEnd = text.size(); }
+        size_t colon = text.find(':', pos);
+        if (colon < lineEnd) {
+            size_t keyBegin = pos, keyEnd = colon;
+            size_t valueBegin = colon + 1, valueEnd = lineEnd;
+            trimRange(text, keyBegin, keyEnd);
+            trimRange(text, valueBegin, valueEnd);
+            if (valueBegin < valueEnd) { // Skip lines with keys but no values.
+                key.assign(text, keyBegin, keyEnd - keyBegin);
+                for (char& c : key) { c = static_cast<char>(std::tolower(static_cast<unsigned char>(c))); }
+                value.assign(text, valueBegin, valueEnd - valueBegin);
+                if (key == "activeprofile") {
+                    profileName = toLowerInternal(value);
+                    sawProfileName = true;
+                } else if (applySetting(key, value)) {
+                    loadedSomething = true;
                 }
             }
-            // Silently ignore unknown keys.
         }
+        pos = lineEnd + 1;
     }
-    infile.close(); // Close the file stream.
 
-    if (loadedSomething) {
+    // A newly selected (or redefined) profile overrides the file's location/units; an
+    // unchanged one leaves a hand-edited "location" line in effect.
+    bool profileChanged = (profileName != activeProfile);
+    for (const auto& before : previousProfiles) {
+        if (before.name != profileName) { continue; }
+        for (const auto& after : profiles) {
+            if (after.name == profileName) {
+                profileChanged = profileChanged || after.location != before.location || after.units != before.units;
+            }
+        }
+    }
+    if (sawProfileName && profileChanged) {
+        if (useProfile(profileName)) {
+            loadedSomething = true;
+        } else {
+            std::cerr << "Warning: Unknown active profile '" << profileName << "' in settings file." << std::endl;
+        }
+    } else if (!sawProfileName) {
+        activeProfile.clear();
+    }
+    // A profile that was removed from the file can no longer be active.
+    if (!activeProfile.empty()) {
+        bool found = false;
+        for (const auto& profile : profiles) { found = found || profile.name == activeProfile; }
+        if (!found) { activeProfile.clear(); }
+    }
+    return loadedSomething;
+}
+
+// Loads settings from the file specified by 'settingsFilename'.
+bool Preferences::loadSettings() {
+    std::string text;
+    if (!readSettingsFile(text)) {
+        // Informative message if file doesn't exist or can't be opened.
+        std::cerr << "Info: Could not open settings file '" << settingsFilename << "'. Using default/current settings." << std::endl;
+        return false; // Indicate file wasn't read, though not necessarily an error state.
+    }
+    lastFileText = text;
+    if (applySettingsText(text)) {
         std::cout << "Settings loaded successfully from '" << settingsFilename << "'" << std::endl;
     }
     // Return true indicating the load process completed (even if file was empty or only had warnings).
     return true;
 }
 
-// Saves the current preference values to the file specified by 'settingsFilename'.
-// Overwrites the existing file content.
-bool Preferences::saveSettings() const {
-    std::ofstream outfile(settingsFilename);
-    if (!outfile.is_open()) {
-        std::cerr << "Error: Could not open settings file '" << settingsFilename << "' for saving." << std::endl;
-        return false; // Indicate failure to open file.
-    }
-
-    // Write each setting in "key:value" format.
-    outfile << "apikey:" << apiKey << std::endl;
-    outfile << "location:" << location << std::endl;
-    outfile << "units:" << units << std::endl;
-    outfile << "datamode:" << datamode << std::endl;
-    outfile << "forecastdays:" << forecastDays << std::endl;
-
-    outfile.close(); // Close the file stream.
+// Applies an externally edited settings file.
+bool Preferences::reloadSettings() {
+    std::string text;
+    if (!readSettingsFile(text) || text == lastFileText) { return false; }
+    lastFileText = text;
+    if (!applySettingsText(text)) { return false; }
+    std::cout << "Settings reloaded from '" << settingsFilename << "'" << std::endl;
+    return true;
+}
 
-    // Check the stream state *after* closing to catch potential write errors.
-    if (!outfile) {
-         std::cerr << "Error: Failed to write all data to settings file '" << settingsFilename << "'." << std::endl;
-         return false; // Indicate write failure.
+// Writes each setting in "key:value" format, followed by the profiles.
+std::string Preferences::toSettingsText() const {
+    std::ostringstream out;
+    out << "apikey:" << apiKey << '\n';
+    out << "location:" << location << '\n';
+    out << "units:" << units << '\n';
+    out << "datamode:" << datamode << '\n';
+    out << "forecastdays:" << forecastDays << '\n';
+    out << "apiurl:" << apiBaseUrl << '\n';
+    out << "metricsport:" << metricsPort << '\n';
+    out << "tracefile:" << traceFile << '\n';
+    out << "ratelimit:" << rateLimit << '\n';
+    out << "monthlyquota:" << monthlyQuota << '\n';
+    out << "cachettl:" << cacheTtl << '\n';
+    out << "iothreads:" << ioThreads << '\n';
+    out << "cputhreads:" << cpuThreads << '\n';
+    out << "refreshinterval:" << refreshInterval << '\n';
+    out << "cachebudget:" << cacheBudgetMb << '\n';
+    out << "cachepolicy:" << cachePolicy << '\n';
+    out << "locationgrid:" << locationGrid << '\n';
+    out << "locationradius:" << locationRadius << '\n';
+    for (const auto& profile : profiles) {
+        out << "profile:" << profile.name << '|' << profile.location;
+        if (!profile.units.empty()) { out << '|' << profile.units; }
+        out << '\n';
     }
+    out << "activeprofile:" << activeProfile << '\n';
+    for (const auto& watched : watchlist) { out << "watch:" << watched << '\n'; }
+    return out.str();
+}
 
-    std::cout << "Settings saved successfully to '" << settingsFilename << "'" << std::endl;
-    return true; // Indicate successful save operation.
-}
\ No newline at end of file
+// Writes the serialized settings in place of the file. The write is synchronous so the
+// caller (the menu) can tell the user whether it was saved; the file is a few hundred bytes.
+bool Preferences::saveSettings() const {
+    std::string text = toSettingsText();
+    std::string error;
+    if (!AtomicFileWriter::writeFile(settingsFilename, text, error)) {
+        std::cerr << "Error: Could not save settings to '" << settingsFilename << "': " << error << std::endl;
+        return false;
+    }
+    lastFileText = text; // Only a written file is ours to ignore on reload.
+    return true;
+}
@@ -3,8 +3,16 @@
 #define PREFERENCES_H
 
 #include <string> // For storing preference values
+#include <vector> // For location profiles
 #include <fstream> // Used in .cpp for file I/O, not needed here directly
 
+// A named location (and optionally unit system) that can be switched to with one command.
+struct LocationProfile {
+    std::string name;     // e.g. "home", "office" (stored lowercase)
+    std::string location; // Any WeatherAPI location query
+    std::string units;    // "Metric", "Imperial", or empty to keep the current units
+};
+
 // Manages user preferences and application settings, handling loading/saving from a file.
 class Preferences {
 private:
@@ -14,9 +22,26 @@ private:
     std::string units;       // Expected: "Metric" or "Imperial"
     std::string datamode;    // Currently unused setting ("basic", "advanced")
     int forecastDays;        // Number of days for forecast (e.g., 1-3)
+    std::string apiBaseUrl;  // WeatherAPI base URL (can point at a local mock server)
+    int metricsPort;         // Port for the Prometheus "/metrics" endpoint (0 = disabled)
+    std::string traceFile;   // Chrome trace output path written on exit (empty = tracing disabled)
+    double rateLimit;        // Client-side limit on API calls per second
+    long long monthlyQuota;  // API calls allowed per month (0 = unlimited)
+    int cacheTtl;            // Seconds a fetched response is reused without a new API call (0 = off)
+    int ioThreads;           // Threads for concurrent API requests
+    int cpuThreads;          // Threads for parsing/building forecasts (0 = one per core)
+    std::vector<LocationProfile> profiles; // Saved locations, in file order
+    std::string activeProfile;             // Name of the profile in use (empty = none)
+    std::vector<std::string> watchlist;    // Locations shown on the dashboard, in file order
+    int refreshInterval;     // Seconds before a dashboard entry is fetched again
+    int cacheBudgetMb;       // Memory budget of each in-process cache, in MiB (0 = unlimited)
+    std::string cachePolicy; // What a full cache evicts first: "lru", "lfu" or "ttl"
+    double locationGrid;     // Degrees coordinate queries are snapped to (0 = as typed)
+    double locationRadius;   // Kilometres within which a coordinate query reuses a known site (0 = never)
 
     // File handling variable.
     std::string settingsFilename; // Name of the file to load/save settings.
+    mutable std::string lastFileText; // File contents last loaded or saved (to ignore our own writes).
 
     // --- Private Helper Methods (Implementation in .cpp) ---
 
@@ -26,6 +51,14 @@ private:
     std::string toLower(const std::string& str);
     // Sets the member variables to their default values.
     void loadDefaults();
+    // Reads the whole settings file into 'text'. Returns false if it cannot be opened.
+    bool readSettingsFile(std::string& text) const;
+    // Applies every "key:value" line of 'text'. Returns true if any setting was applied.
+    bool applySettingsText(const std::string& text);
+    // Applies one setting; 'key' is already lowercase. Returns true if it was applied.
+    bool applySetting(const std::string& key, const std::string& value);
+    // Serializes the current settings in file format.
+    std::string toSettingsText() const;
 
 public:
     // Constructor: Initializes defaults and attempts to load from the specified file.
@@ -41,6 +74,27 @@ public:
     const std::string& getUnits() const;
     const std::string& getDataMode() const; // Although unused, keep getter if defined
     int getForecastDays() const;
+    const std::string& getApiBaseUrl() const;
+    int getMetricsPort() const;
+    const std::string& getTraceFile() const;
+    double getRateLimit() const;
+    long long getMonthlyQuota() const;
+    int getCacheTtl() const;
+    int getIoThreads() const;
+    int getCpuThreads() const;
+    const std::vector<LocationProfile>& getProfiles() const;
+    const std::string& getActiveProfile() const;
+    const std::vector<std::string>& getWatchlist() const;
+    int getRefreshInterval() const;
+    int getCacheBudgetMb() const;
+    const std::string& getCachePolicy() const;
+    double getLocationGrid() const;
+    double getLocationRadius() const;
+    // Returns the path of the settings file.
+    const std::string& getSettingsFilename() const;
+    // Returns the path of 'filename' in the same directory as the settings file
+    // (used for companion files such as "quota.txt").
+    std::string pathNextToSettings(const std::string& filename) const;
 
     // --- Setters (Allow modification of settings, with validation) ---
 
@@ -54,14 +108,63 @@ public:
     void setDataMode(const std::string& mode);
     // Sets the forecast days if within valid range (1-14), returns success status.
     bool setForecastDays(int days);
+    // Sets the API base URL (trims input). Empty input restores the default.
+    void setApiBaseUrl(const std::string& url);
+    // Sets the metrics port if within [0, 65535] (0 disables the endpoint), returns success status.
+    bool setMetricsPort(int port);
+    // Sets the trace output path (trims input). Empty disables tracing.
+    void setTraceFile(const std::string& path);
+    // Sets the API call rate limit if positive, returns success status.
+    bool setRateLimit(double callsPerSecond);
+    // Sets the monthly API call quota if non-negative (0 = unlimited), returns success status.
+    bool setMonthlyQuota(long long calls);
+    // Sets the response cache lifetime in seconds if within [0, 86400] (0 = off), returns success status.
+    bool setCacheTtl(int seconds);
+    // Sets the I/O thread count if within [1, 256], returns success status.
+    bool setIoThreads(int count);
+    // Sets the CPU thread count if within [0, 256] (0 = one per core), returns success status.
+    bool setCpuThreads(int count);
+    // Sets the dashboard refresh interval in seconds if within [1, 86400], returns success status.
+    bool setRefreshInterval(int seconds);
+    // Sets the per-cache memory budget in MiB if within [0, 1048576] (0 = unlimited), returns success status.
+    bool setCacheBudgetMb(int megabytes);
+    // Sets the cache eviction policy if it is "lru", "lfu" or "ttl" (case-insensitive), returns success status.
+    bool setCachePolicy(const std::string& policy);
+    // Sets the coordinate snapping grid if within [0, 1] degrees (0 = off), returns success status.
+    bool setLocationGrid(double degrees);
+    // Sets the known-site reuse radius if within [0, 50] km (0 = off), returns success status.
+    bool setLocationRadius(double kilometres);
+
+    // --- Location Profiles ---
+
+    // Adds or replaces profile 'name' (case-insensitive). 'units' may be empty.
+    // Returns false (prints warning) if the name or location is empty, or the units are invalid.
+    bool addProfile(const std::string& name, const std::string& loc, const std::string& unit = "");
+    // Removes profile 'name'. Returns false if there is no such profile.
+    bool removeProfile(const std::string& name);
+    // Switches location (and units, if the profile has them) to profile 'name'.
+    // Returns false (prints warning) if there is no such profile.
+    bool useProfile(const std::string& name);
+
+    // --- Watchlist ---
+
+    // Adds 'loc' to the dashboard watchlist. Returns false if it is empty or already listed
+    // (case-insensitive).
+    bool addToWatchlist(const std::string& loc);
+    // Removes 'loc' (case-insensitive). Returns false if it is not listed.
+    bool removeFromWatchlist(const std::string& loc);
 
     // --- File Operations ---
 
     // Attempts to load settings from the 'settingsFilename'.
     // Returns true on success (even if file not found/empty), false on read error.
     bool loadSettings();
-    // Attempts to save the current settings to 'settingsFilename'.
-    // Returns true on success, false on write error.
+    // Re-reads 'settingsFilename' after it changed on disk (see SettingsWatcher), applying its
+    // values over the current ones. Returns true if anything was applied; false if the file is
+    // unchanged, unreadable, or holds exactly what this instance last saved.
+    bool reloadSettings();
+    // Replaces 'settingsFilename' with the current settings atomically (temporary file +
+    // rename). Returns true on success, false on write error (reported on cerr).
     bool saveSettings() const;
 };
 
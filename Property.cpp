@@ -7,18 +7,18 @@
 Property::Property() : name("N/A"), value(0.0), unit("N/A") {}
 
 // Parameterized constructor implementation. Uses initializer list for efficiency.
-Property::Property(const std::string& name, double value, const std::string& unit)
+Property::Property(InternedString name, double value, InternedString unit)
     : name(name), value(value), unit(unit) {}
 
 // --- Getters ---
-std::string Property::getName() const { return this->name; }
+const std::string& Property::getName() const { return this->name; }
 double Property::getValue() const { return this->value; }
-std::string Property::getUnit() const { return this->unit; }
+const std::string& Property::getUnit() const { return this->unit; }
 
 // --- Setters ---
-void Property::setName(const std::string& name) { this->name = name; }
+void Property::setName(InternedString name) { this->name = name; }
 void Property::setValue(double value) { this->value = value; }
-void Property::setUnit(const std::string& unit) { this->unit = unit; }
+void Property::setUnit(InternedString unit) { this->unit = unit; }
 
 // Implementation of the friend overloaded stream insertion operator.
 // Defines how a Property object is formatted when sent to an output stream.
@@ -2,33 +2,38 @@
 #ifndef PROPERTY_H
 #define PROPERTY_H
 
+#include "InternedString.h" // Shared name and unit strings
 #include <iostream> // For friend ostream operator
 #include <string>   // For name and unit strings
 
 // Represents a single weather property (like temperature, humidity) with its value and unit.
+// The name and unit are interned: every hour's "Temperature" points at the same string.
 class Property {
  // Use private for encapsulation, grant access via public methods.
  private:
- std::string name;  // Descriptive name of the property (e.g., "Temperature").
- double value;      // Numerical value of the property.
- std::string unit;  // Unit of measurement (e.g., "°C", "%", "km/h").
+ InternedString name; // Descriptive name of the property (e.g., "Temperature").
+ double value;        // Numerical value of the property.
+ InternedString unit; // Unit of measurement (e.g., "°C", "%", "km/h").
 
  public:
  // Default constructor: Initializes with placeholder values.
  Property();
 
  // Parameterized constructor: Initializes with specific name, value, and unit.
- Property(const std::string& name, double value, const std::string& unit);
+ // Strings are interned here; pass InternedString constants on hot paths to skip the lookup.
+ Property(InternedString name, double value, InternedString unit);
 
- // --- Getters (Provide read-only access) ---
- std::string getName() const;
+ // --- Getters (Provide read-only access; no copies) ---
+ const std::string& getName() const;
  double getValue() const;
- std::string getUnit() const;
+ const std::string& getUnit() const;
+ // The unit as a handle (compare with == without reading the text).
+ InternedString getUnitHandle() const { return unit; }
 
  // --- Setters (Allow modification) ---
- void setName(const std::string& name);
+ void setName(InternedString name);
  void setValue(double value);
- void setUnit(const std::string& unit);
+ void setUnit(InternedString unit);
 
  // Friend function to allow direct printing of Property objects using std::cout.
  friend std::ostream& operator<<(std::ostream& os, const Property& prop);
@@ -0,0 +1,165 @@
+// RateLimiter.cpp
+#include "RateLimiter.h"
+
+#include <fstream>   // For persisting usage
+#include <iostream>  // For error output (cerr)
+#include <ctime>     // For the current calendar month (UTC)
+#include <algorithm> // For std::min
+#include <cstdlib>   // For atoll
+
+// --- Internal Helper Functions (Anonymous Namespace) ---
+namespace {
+    // Returns the current calendar month in UTC as "YYYY-MM".
+    std::string currentMonthKey() {
+        time_t now = std::time(nullptr);
+        std::tm timeinfo = {};
+        #ifdef _WIN32 // Platform-specific safe time conversion.
+            gmtime_s(&timeinfo, &now);
+        #else
+            gmtime_r(&now, &timeinfo); // POSIX version
+        #endif
+        char buffer[8];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m", &timeinfo);
+        return buffer;
+    }
+
+    const int SAVE_EVERY_CALLS = 20; // Persist usage after this many calls (and on exit).
+} // end anonymous namespace
+
+// --- Constructor / Destructor ---
+
+RateLimiter::RateLimiter(const RateLimitConfig& cfg, const std::string& quotaFile)
+    : config(cfg), quotaFilename(quotaFile), tokens(cfg.burst), lastRefill(std::chrono::steady_clock::now()),
+      waitingInteractive(0), usageMonth(currentMonthKey()), usedThisMonth(0), unsavedCalls(0) {
+    if (config.requestsPerSecond <= 0.0) { config.requestsPerSecond = 1.0; }
+    if (config.burst < 1.0) { config.burst = 1.0; tokens = 1.0; }
+    loadUsage();
+}
+
+RateLimiter::~RateLimiter() {
+    flush();
+}
+
+// --- Private Helpers ---
+
+void RateLimiter::refill(std::chrono::steady_clock::time_point now) {
+    double elapsed = std::chrono::duration<double>(now - lastRefill).count();
+    tokens = std::min(config.burst, tokens + elapsed * config.requestsPerSecond);
+    lastRefill = now;
+}
+
+void RateLimiter::rollMonth() {
+    std::string month = currentMonthKey();
+    if (month != usageMonth) {
+        usageMonth = month;
+        usedThisMonth = 0;
+        unsavedCalls = 1; // Force the reset to be persisted with the next save.
+    }
+}
+
+// Writes usage in the same "key:value" format as settings.txt.
+bool RateLimiter::saveUsage() const {
+    if (quotaFilename.empty()) { return true; }
+    std::ofstream outfile(quotaFilename);
+    if (!outfile.is_open()) {
+        std::cerr << "Error: Could not open quota file '" << quotaFilename << "' for saving." << std::endl;
+        return false;
+    }
+    outfile << "month:" << usageMonth << std::endl;
+    outfile << "used:" << usedThisMonth << std::endl;
+    outfile.close();
+    return static_cast<bool>(outfile);
+}
+
+void RateLimiter::loadUsage() {
+    if (quotaFilename.empty()) { return; }
+    std::ifstream infile(quotaFilename);
+    if (!infile.is_open()) { return; } // First run: nothing used yet.
+
+    std::string line, month;
+    long long used = 0;
+    while (std::getline(infile, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) { continue; }
+        std::string key = line.substr(0, colon);
+        std::string value = line.substr(colon + 1);
+        if (key == "month") { month = value; }
+        else if (key == "used") { used = std::atoll(value.c_str()); }
+    }
+    // Usage from a previous month no longer counts.
+    if (month == usageMonth && used > 0) {
+        usedThisMonth = used;
+    }
+}
+
+// --- Public Interface ---
+
+bool RateLimiter::acquire(RequestPriority priority, std::string& reason) {
+    std::unique_lock<std::mutex> lock(mutex);
+    rollMonth();
+
+    // Shed early if the monthly budget cannot accommodate this request.
+    if (config.monthlyQuota > 0) {
+        long long remaining = config.monthlyQuota - usedThisMonth;
+        if (remaining <= 0) {
+            reason = " Monthly API quota exhausted (" + std::to_string(usedThisMonth) + " of "
+                   + std::to_string(config.monthlyQuota) + " calls used).";
+            return false;
+        }
+        if (priority == RequestPriority::BACKGROUND
+            && remaining <= static_cast<long long>(config.monthlyQuota * config.backgroundReserve)) {
+            reason = " Background request shed: remaining API quota is reserved for interactive use.";
+            return false;
+        }
+    }
+
+    bool interactive = (priority == RequestPriority::INTERACTIVE);
+    auto deadline = std::chrono::steady_clock::now() + (interactive ? config.interactiveMaxWait : config.backgroundMaxWait);
+    if (interactive) { ++waitingInteractive; }
+
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        refill(now);
+        // Background callers yield to any queued interactive caller.
+        if (tokens >= 1.0 && (interactive || waitingInteractive == 0)) {
+            tokens -= 1.0;
+            break;
+        }
+        if (now >= deadline) {
+            if (interactive) { --waitingInteractive; tokenAvailable.notify_all(); }
+            reason = " Client-side rate limit: no request slot available in time.";
+            return false;
+        }
+        // Sleep until the next token is due (or the deadline), whichever is first.
+        auto untilToken = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>((1.0 - tokens) / config.requestsPerSecond));
+        tokenAvailable.wait_until(lock, std::min(deadline, now + untilToken));
+    }
+
+    if (interactive) {
+        --waitingInteractive;
+        tokenAvailable.notify_all(); // Let queued background callers re-check.
+    }
+
+    ++usedThisMonth;
+    if (++unsavedCalls >= SAVE_EVERY_CALLS) {
+        unsavedCalls = 0;
+        saveUsage();
+    }
+    return true;
+}
+
+long long RateLimiter::getMonthlyUsage() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return usedThisMonth;
+}
+
+long long RateLimiter::getMonthlyQuota() const {
+    return config.monthlyQuota;
+}
+
+bool RateLimiter::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    unsavedCalls = 0;
+    return saveUsage();
+}
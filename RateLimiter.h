@@ -0,0 +1,76 @@
+// RateLimiter.h
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <chrono>             // For refill timing and wait limits
+#include <condition_variable> // For queueing callers until a token is available
+#include <mutex>              // For guarding bucket and quota state
+#include <string>             // For the quota file path and month key
+
+// Who is asking for a request slot. Interactive requests (a user waiting at the menu)
+// always go before background work such as scheduled refreshes.
+enum class RequestPriority { INTERACTIVE, BACKGROUND };
+
+// Settings for the limiter.
+struct RateLimitConfig {
+    double requestsPerSecond = 5.0;      // Sustained request rate (token refill rate).
+    double burst = 10.0;                 // Bucket size: requests allowed back-to-back.
+    long long monthlyQuota = 1000000;    // API calls allowed per calendar month (0 = unlimited).
+    double backgroundReserve = 0.1;      // Fraction of the monthly quota kept for interactive use.
+    std::chrono::milliseconds interactiveMaxWait{10000}; // Longest an interactive request queues.
+    std::chrono::milliseconds backgroundMaxWait{60000};  // Longest a background request queues.
+};
+
+// Client-side token bucket shared by every request path, plus monthly quota accounting
+// persisted to a small file (by default "quota.txt" next to "settings.txt").
+// Requests that would exceed the budget are queued (up to a per-priority wait limit) or shed.
+class RateLimiter {
+  private:
+  RateLimitConfig config;                           // Limits in effect.
+  std::string quotaFilename;                        // Where usage is persisted.
+
+  mutable std::mutex mutex;                         // Guards all state below.
+  std::condition_variable tokenAvailable;           // Signalled when a waiter should re-check.
+  double tokens;                                    // Tokens currently in the bucket.
+  std::chrono::steady_clock::time_point lastRefill; // When 'tokens' was last topped up.
+  int waitingInteractive;                           // Interactive callers currently queued.
+  std::string usageMonth;                           // "YYYY-MM" the usage count belongs to.
+  long long usedThisMonth;                          // API calls made in 'usageMonth'.
+  int unsavedCalls;                                 // Calls since usage was last persisted.
+
+  // --- Private Helpers (caller holds 'mutex') ---
+
+  // Adds tokens earned since the last refill, capped at the burst size.
+  void refill(std::chrono::steady_clock::time_point now);
+  // Resets the usage count when a new calendar month (UTC) starts.
+  void rollMonth();
+  // Writes usage to the quota file. Returns false on write error.
+  bool saveUsage() const;
+  // Reads usage from the quota file (missing file = no usage yet).
+  void loadUsage();
+
+  public:
+  // Constructor: Starts with a full bucket and loads persisted usage from 'quotaFile'.
+  RateLimiter(const RateLimitConfig& cfg, const std::string& quotaFile);
+  // Destructor: Persists usage.
+  ~RateLimiter();
+
+  // Disable copy operations (holds synchronization primitives and file state).
+  RateLimiter(const RateLimiter&) = delete;
+  RateLimiter& operator=(const RateLimiter&) = delete;
+
+  // Waits for permission to send one API call.
+  // Returns false if the request was shed: monthly quota exhausted, background request while
+  // the quota is inside the interactive reserve, or the priority's wait limit expired.
+  // On false, 'reason' describes why.
+  bool acquire(RequestPriority priority, std::string& reason);
+
+  // Returns API calls counted in the current month.
+  long long getMonthlyUsage() const;
+  // Returns the configured monthly quota (0 = unlimited).
+  long long getMonthlyQuota() const;
+  // Persists usage now. Returns false on write error.
+  bool flush();
+};
+
+#endif // RATELIMITER_H
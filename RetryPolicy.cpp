@@ -0,0 +1,35 @@
+// RetryPolicy.cpp
+#include "RetryPolicy.h"
+
+#include <random>    // For jitter
+#include <algorithm> // For std::min
+#include <cstdlib>   // For strtol
+#include <cctype>    // For isspace
+
+// Full jitter: uniform in [0, min(maxDelay, baseDelay * 2^(retry-1))].
+std::chrono::milliseconds RetryPolicy::backoffDelay(int retry) const {
+    if (retry < 1) { retry = 1; }
+    long long cap = baseDelay.count();
+    for (int i = 1; i < retry && cap < maxDelay.count(); ++i) {
+        cap *= 2;
+    }
+    cap = std::min(cap, static_cast<long long>(maxDelay.count()));
+    if (cap <= 0) { return std::chrono::milliseconds(0); }
+
+    thread_local std::mt19937_64 engine{std::random_device{}()};
+    std::uniform_int_distribution<long long> distribution(0, cap);
+    return std::chrono::milliseconds(distribution(engine));
+}
+
+bool RetryPolicy::isRetryableStatus(int status) {
+    return status == 408 || status == 429 || status == 500 || status == 502 || status == 503 || status == 504;
+}
+
+std::chrono::milliseconds RetryPolicy::parseRetryAfter(const std::string& headerValue) {
+    const char* start = headerValue.c_str();
+    while (*start != '\0' && std::isspace(static_cast<unsigned char>(*start))) { ++start; }
+    char* end = nullptr;
+    long seconds = std::strtol(start, &end, 10);
+    if (end == start || seconds < 0) { return std::chrono::milliseconds(-1); }
+    return std::chrono::milliseconds(seconds * 1000LL);
+}
@@ -0,0 +1,29 @@
+// RetryPolicy.h
+#ifndef RETRYPOLICY_H
+#define RETRYPOLICY_H
+
+#include <chrono> // For delay durations
+#include <string> // For parsing Retry-After header values
+
+// Describes how failed idempotent GET requests are retried.
+// Delays grow exponentially from 'baseDelay' and use "full jitter" (a random delay between
+// zero and the exponential cap) so that many clients do not retry in lock-step.
+struct RetryPolicy {
+    int maxAttempts = 3;                                  // Total attempts including the first (1 = no retries).
+    std::chrono::milliseconds baseDelay{200};             // Backoff cap before the first retry.
+    std::chrono::milliseconds maxDelay{5000};             // Upper bound for any single backoff delay.
+    std::chrono::milliseconds maxRetryAfter{10000};       // Longest Retry-After (429/503) we are willing to honour.
+    std::chrono::milliseconds totalBudget{15000};         // Give up once this much time has been spent on one call.
+
+    // Returns the jittered delay before retry number 'retry' (1 = first retry).
+    std::chrono::milliseconds backoffDelay(int retry) const;
+
+    // Returns true for statuses worth retrying: 408, 429 and the transient 5xx codes.
+    static bool isRetryableStatus(int status);
+
+    // Parses a Retry-After header given in seconds. Returns a negative duration if the
+    // value is missing or not a number (HTTP-date values fall back to normal backoff).
+    static std::chrono::milliseconds parseRetryAfter(const std::string& headerValue);
+};
+
+#endif // RETRYPOLICY_H
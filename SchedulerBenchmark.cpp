@@ -0,0 +1,141 @@
+// SchedulerBenchmark.cpp - Measures fetch -> parse -> render throughput across CPU worker counts
+#include "TaskScheduler.h"     // The scheduler under test
+#include "APIConverter.h"      // Forecast parsing (parseForecastReport)
+#include "ForecastReport.h"    // Rendering (display)
+#include "MockWeatherServer.h" // Synthetic forecast payloads
+#include "WeatherQuery.h"      // Units for parsing
+
+#include <iostream>  // For console output (cout, cerr)
+#include <iomanip>   // For table formatting
+#include <sstream>   // For rendering into memory
+#include <string>    // For payloads and argument parsing
+#include <vector>    // For payloads and thread counts
+#include <atomic>    // For the failure counter
+#include <chrono>    // For timing and simulated latency
+#include <thread>    // For hardware_concurrency and sleep_for
+#include <cstdlib>   // For atoi
+
+namespace {
+    // Benchmark settings (overridable from the command line).
+    struct BenchmarkConfig {
+        int responses = 10000;   // Forecast responses processed per run.
+        int days = 3;            // Days per forecast payload.
+        int latencyMs = 2;       // Simulated network wait per response (on the I/O pool).
+        unsigned ioThreads = 64; // I/O pool size (enough that latency is not the bottleneck).
+        unsigned maxCpu = 0;     // Largest CPU worker count to try (0 = hardware threads).
+        int distinctPayloads = 64; // Payloads generated up front and reused round-robin.
+    };
+
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "  --responses N   Forecast responses per run (default 10000)\n"
+                  << "  --days N        Days per forecast payload (default 3)\n"
+                  << "  --latency MS    Simulated network wait per response (default 2)\n"
+                  << "  --io-threads N  I/O pool size (default 64)\n"
+                  << "  --max-cpu N     Largest CPU worker count to try (default: hardware threads)\n";
+    }
+
+    // Processes every response once with 'cpuThreads' CPU workers; returns elapsed seconds.
+    double runOnce(const BenchmarkConfig& config, const std::vector<std::string>& payloads,
+                   unsigned cpuThreads, std::uint64_t& steals, int& failures) {
+        const WeatherQuery query("bench", "bench", "Metric");
+        std::atomic<int> failed(0);
+        auto start = std::chrono::steady_clock::now();
+        {
+            TaskScheduler scheduler(config.ioThreads, cpuThreads);
+            TaskGroup group;
+            group.add(config.responses);
+            for (int i = 0; i < config.responses; ++i) {
+                const std::string* body = &payloads[i % payloads.size()];
+                scheduler.submitIo([&, body]() {
+                    // Stand-in for client->Get: blocks an I/O thread, not a CPU worker.
+                    std::this_thread::sleep_for(std::chrono::milliseconds(config.latencyMs));
+                    scheduler.submitCpu([&, body]() {
+                        auto report = APIConverter::parseForecastReport(*body, query, ForecastReport::DetailLevel::HOURLY);
+                        if (report) {
+                            std::ostringstream rendered;
+                            report->display(rendered);
+                        } else {
+                            ++failed;
+                        }
+                        group.done();
+                    });
+                });
+            }
+            group.wait();
+            steals = scheduler.getStealCount();
+        }
+        failures = failed.load();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+} // end anonymous namespace
+
+int main(int argc, char* argv[]) {
+    BenchmarkConfig config;
+
+    // --- Argument Parsing ---
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for option '" << arg << "'." << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "--responses")       { config.responses = std::atoi(value); }
+        else if (arg == "--days")       { config.days = std::atoi(value); }
+        else if (arg == "--latency")    { config.latencyMs = std::atoi(value); }
+        else if (arg == "--io-threads") { config.ioThreads = static_cast<unsigned>(std::atoi(value)); }
+        else if (arg == "--max-cpu")    { config.maxCpu = static_cast<unsigned>(std::atoi(value)); }
+        else {
+            std::cerr << "Error: Unknown option '" << arg << "'." << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.responses < 1 || config.days < 1 || config.latencyMs < 0) {
+        std::cerr << "Error: --responses and --days must be positive, --latency non-negative." << std::endl;
+        return 1;
+    }
+    if (config.maxCpu == 0) { config.maxCpu = std::thread::hardware_concurrency(); }
+    if (config.maxCpu == 0) { config.maxCpu = 1; }
+
+    // --- Payload Generation ---
+    std::vector<std::string> payloads;
+    for (int i = 0; i < config.distinctPayloads; ++i) {
+        std::string location = std::to_string(-60 + i * 2) + "," + std::to_string(-170 + i * 5);
+        payloads.push_back(MockWeatherServer::makeForecastJson(location, config.days, 1700000000, 42 + i));
+    }
+    std::cout << config.responses << " forecast responses, " << config.days << " day(s) each ("
+              << payloads[0].size() / 1024 << " KiB), " << config.latencyMs << " ms simulated latency, "
+              << config.ioThreads << " I/O threads\n" << std::endl;
+
+    // --- Runs ---
+    std::vector<unsigned> cpuCounts;
+    for (unsigned n = 1; n < config.maxCpu; n *= 2) { cpuCounts.push_back(n); }
+    cpuCounts.push_back(config.maxCpu);
+
+    std::cout << std::left << std::setw(12) << "CPU workers" << std::right
+              << std::setw(12) << "Seconds" << std::setw(14) << "Responses/s"
+              << std::setw(10) << "Speedup" << std::setw(10) << "Steals" << std::endl;
+    double baseline = 0.0;
+    for (unsigned cpu : cpuCounts) {
+        std::uint64_t steals = 0;
+        int failures = 0;
+        double seconds = runOnce(config, payloads, cpu, steals, failures);
+        if (baseline == 0.0) { baseline = seconds; }
+        std::cout << std::left << std::setw(12) << cpu << std::right << std::fixed
+                  << std::setw(12) << std::setprecision(3) << seconds
+                  << std::setw(14) << std::setprecision(0) << config.responses / seconds
+                  << std::setw(9) << std::setprecision(2) << baseline / seconds << "x"
+                  << std::setw(10) << steals << std::endl;
+        if (failures > 0) {
+            std::cerr << "Warning: " << failures << " responses failed to parse." << std::endl;
+        }
+    }
+    return 0;
+}
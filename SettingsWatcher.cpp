@@ -0,0 +1,120 @@
+// SettingsWatcher.cpp
+#include "SettingsWatcher.h"
+
+#include <cstring>      // For std::strcmp
+#include <sys/stat.h>   // For stat (polling fallback)
+
+#ifdef __linux__
+#include <sys/inotify.h> // For inotify_init1, inotify_add_watch
+#include <poll.h>        // For poll
+#include <unistd.h>      // For read, write, pipe, close
+#include <fcntl.h>       // For O_CLOEXEC
+#endif
+
+// --- Constructor / Destructor ---
+
+SettingsWatcher::SettingsWatcher(const std::string& filePath, std::chrono::milliseconds interval)
+    : path(filePath), pollInterval(interval), changed(false), inotifyFd(-1), stopping(false) {
+    stopPipe[0] = stopPipe[1] = -1;
+    size_t slash = path.find_last_of("/\\");
+    if (slash == std::string::npos) {
+        directory = ".";
+        filename = path;
+    } else {
+        directory = (slash == 0) ? "/" : path.substr(0, slash);
+        filename = path.substr(slash + 1);
+    }
+}
+
+SettingsWatcher::~SettingsWatcher() { stop(); }
+
+// --- Start / Stop ---
+
+bool SettingsWatcher::start() {
+    if (thread.joinable()) { return false; }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = false;
+    }
+#ifdef __linux__
+    // Watch the directory: atomic saves replace the file (a new inode), which a watch on the
+    // file itself would miss.
+    inotifyFd = inotify_init1(IN_CLOEXEC);
+    if (inotifyFd >= 0 &&
+        (inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0 ||
+         pipe2(stopPipe, O_CLOEXEC) != 0)) {
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+    if (inotifyFd >= 0) {
+        thread = std::thread(&SettingsWatcher::runInotify, this);
+        return true;
+    }
+#endif
+    thread = std::thread(&SettingsWatcher::runPolling, this);
+    return true;
+}
+
+void SettingsWatcher::stop() {
+    if (!thread.joinable()) { return; }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    stopSignal.notify_all();
+#ifdef __linux__
+    if (stopPipe[1] >= 0) {
+        char wake = 1;
+        (void)!write(stopPipe[1], &wake, 1);
+    }
+#endif
+    thread.join();
+#ifdef __linux__
+    if (inotifyFd >= 0) { close(inotifyFd); inotifyFd = -1; }
+    for (int& fd : stopPipe) {
+        if (fd >= 0) { close(fd); fd = -1; }
+    }
+#endif
+}
+
+// --- Watcher Loops ---
+
+void SettingsWatcher::runInotify() {
+#ifdef __linux__
+    // Aligned for struct inotify_event; holds several events per read.
+    alignas(struct inotify_event) char buffer[4096];
+    pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {stopPipe[0], POLLIN, 0}};
+    while (true) {
+        if (poll(fds, 2, -1) < 0) { continue; } // EINTR
+        if (fds[1].revents != 0) { return; }     // stop()
+        if ((fds[0].revents & POLLIN) == 0) { continue; }
+
+        ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        for (ssize_t offset = 0; offset < length; ) {
+            const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            if (event->len > 0 && std::strcmp(event->name, filename.c_str()) == 0) {
+                changed.store(true);
+            }
+            offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+        }
+    }
+#endif
+}
+
+void SettingsWatcher::runPolling() {
+    long long lastStamp = fileStamp();
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopSignal.wait_for(lock, pollInterval, [this] { return stopping; })) {
+        long long stamp = fileStamp();
+        if (stamp != lastStamp) {
+            lastStamp = stamp;
+            changed.store(true);
+        }
+    }
+}
+
+long long SettingsWatcher::fileStamp() const {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) { return -1; }
+    return static_cast<long long>(info.st_mtime) * 1000003LL + static_cast<long long>(info.st_size);
+}
@@ -0,0 +1,60 @@
+// SettingsWatcher.h
+#ifndef SETTINGSWATCHER_H
+#define SETTINGSWATCHER_H
+
+#include <atomic>             // For the change flag
+#include <chrono>             // For the polling interval
+#include <condition_variable> // For stopping the polling fallback
+#include <mutex>              // For stopping the polling fallback
+#include <string>             // For paths
+#include <thread>             // For the watcher thread
+
+// Notices when a file (e.g., settings.txt) is changed on disk, so a long-running process can
+// reload it without a restart.
+// On Linux it blocks on inotify (watching the file's directory, so editors and atomic
+// renames that replace the file are seen) and uses no CPU while idle; elsewhere it compares
+// the file's modification time and size every 'pollInterval'.
+// Changes are only flagged: the owner picks them up with takeChange() on its own thread and
+// reloads there, so settings are never modified behind its back.
+class SettingsWatcher {
+  public:
+  explicit SettingsWatcher(const std::string& path,
+                           std::chrono::milliseconds pollInterval = std::chrono::milliseconds(1000));
+  // Stops watching.
+  ~SettingsWatcher();
+
+  SettingsWatcher(const SettingsWatcher&) = delete;
+  SettingsWatcher& operator=(const SettingsWatcher&) = delete;
+
+  // Starts the watcher thread. Returns false if it is already running.
+  bool start();
+  // Stops and joins the watcher thread.
+  void stop();
+  // Returns true (once) if the file changed since the last call.
+  bool takeChange() { return changed.exchange(false); }
+  // Returns true if changes are detected with inotify rather than by polling.
+  bool usesInotify() const { return inotifyFd >= 0; }
+
+  private:
+  std::string path;
+  std::string directory;  // Directory holding the file ("." if none given).
+  std::string filename;   // File name within 'directory'.
+  std::chrono::milliseconds pollInterval;
+  std::atomic<bool> changed;
+  std::thread thread;
+
+  int inotifyFd;          // inotify instance (-1 = polling).
+  int stopPipe[2];        // Written by stop() to wake the inotify loop.
+
+  bool stopping;          // Guarded by 'mutex' (polling loop).
+  std::mutex mutex;
+  std::condition_variable stopSignal;
+
+  // Watcher loops.
+  void runInotify();
+  void runPolling();
+  // Modification time and size of the file, combined into one comparable value (-1 if missing).
+  long long fileStamp() const;
+};
+
+#endif // SETTINGSWATCHER_H
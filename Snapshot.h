@@ -0,0 +1,37 @@
+// Snapshot.h
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <memory> // For std::shared_ptr and its atomic access functions
+
+// Holds the latest published version of an immutable object (e.g., a weather report).
+// Writers build a complete new object off to the side and publish it with a single pointer
+// swap; readers take their own shared_ptr<const T> and keep using it for as long as they
+// like, even after a newer version lands. Readers never wait for a writer to finish
+// building, and old versions are freed when their last reader drops them.
+template <typename T>
+class Snapshot {
+private:
+    std::shared_ptr<const T> current; // Only accessed through std::atomic_load/atomic_store.
+
+public:
+    Snapshot() = default;
+    explicit Snapshot(std::shared_ptr<const T> initial) : current(std::move(initial)) {}
+
+    // Disable copy operations (a slot is shared by reference, its contents by shared_ptr).
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    // Returns the current version (nullptr if nothing has been published yet).
+    std::shared_ptr<const T> load() const { return std::atomic_load(&current); }
+
+    // Replaces the current version. 'next' must not be modified after publishing.
+    void publish(std::shared_ptr<const T> next) { std::atomic_store(&current, std::move(next)); }
+
+    // Replaces the current version and returns the one it replaced.
+    std::shared_ptr<const T> exchange(std::shared_ptr<const T> next) {
+        return std::atomic_exchange(&current, std::move(next));
+    }
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,126 @@
+// SpatialIndex.cpp
+#include "SpatialIndex.h"
+#include <algorithm> // For std::sort, std::min, std::max
+#include <cmath>     // For trigonometry, floor, ceil
+
+// --- Internal Helper Functions (Anonymous Namespace) ---
+namespace {
+    const double PI = 3.14159265358979323846;
+    const double EARTH_RADIUS_KM = 6371.0088; // Mean radius.
+    const double KM_PER_DEGREE = EARTH_RADIUS_KM * PI / 180.0; // Along a meridian.
+
+    double radians(double degrees) { return degrees * PI / 180.0; }
+
+    // Keeps a longitude in [-180, 180).
+    double wrapLongitude(double longitude) {
+        double wrapped = std::fmod(longitude + 180.0, 360.0);
+        if (wrapped < 0) { wrapped += 360.0; }
+        return wrapped - 180.0;
+    }
+} // end anonymous namespace
+
+// --- Constructor ---
+
+SpatialIndex::SpatialIndex(double cell) : cellDegrees(cell > 0.0 ? std::min(cell, 90.0) : 0.25) {
+    rowCount = static_cast<int>(std::ceil(180.0 / cellDegrees));
+    columnCount = static_cast<int>(std::ceil(360.0 / cellDegrees));
+}
+
+// --- Cells ---
+
+int SpatialIndex::rowFor(double latitude) const {
+    int row = static_cast<int>(std::floor((std::max(-90.0, std::min(90.0, latitude)) + 90.0) / cellDegrees));
+    return std::min(row, rowCount - 1);
+}
+
+int SpatialIndex::columnFor(double longitude) const {
+    int column = static_cast<int>(std::floor((wrapLongitude(longitude) + 180.0) / cellDegrees));
+    return std::min(column, columnCount - 1);
+}
+
+// --- Updates ---
+
+void SpatialIndex::insert(std::size_t id, double latitude, double longitude) {
+    remove(id);
+    std::uint64_t key = cellKey(rowFor(latitude), columnFor(longitude));
+    cells[key].push_back(Point{id, latitude, wrapLongitude(longitude)});
+    cellOf[id] = key;
+}
+
+bool SpatialIndex::remove(std::size_t id) {
+    auto found = cellOf.find(id);
+    if (found == cellOf.end()) { return false; }
+    auto bucket = cells.find(found->second);
+    std::vector<Point>& points = bucket->second;
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        if (points[i].id == id) {
+            points[i] = points.back(); // Order within a cell does not matter.
+            points.pop_back();
+            break;
+        }
+    }
+    if (points.empty()) { cells.erase(bucket); }
+    cellOf.erase(found);
+    return true;
+}
+
+void SpatialIndex::clear() {
+    cells.clear();
+    cellOf.clear();
+}
+
+// --- Queries ---
+
+double SpatialIndex::distanceKm(double lat1, double lon1, double lat2, double lon2) {
+    double dLat = radians(lat2 - lat1);
+    double dLon = radians(lon2 - lon1);
+    double a = std::sin(dLat / 2) * std::sin(dLat / 2)
+             + std::cos(radians(lat1)) * std::cos(radians(lat2)) * std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 2.0 * EARTH_RADIUS_KM * std::asin(std::sqrt(std::min(1.0, a)));
+}
+
+std::vector<SpatialIndex::Neighbor> SpatialIndex::nearest(double latitude, double longitude, std::size_t k,
+                                                          double maxKm) const {
+    std::vector<Neighbor> found;
+    if (k == 0 || maxKm < 0.0 || cells.empty()) { return found; }
+    auto consider = [&](const Point& point) {
+        double distance = distanceKm(latitude, longitude, point.latitude, point.longitude);
+        if (distance <= maxKm) { found.push_back(Neighbor{point.id, distance}); }
+    };
+
+    // Cells the radius can reach: rows by latitude, columns widened for the narrowest
+    // (most poleward) row in range.
+    double spanDegrees = maxKm / KM_PER_DEGREE;
+    int rowRadius = static_cast<int>(std::ceil(spanDegrees / cellDegrees));
+    double poleward = std::min(90.0, std::fabs(latitude) + spanDegrees);
+    double cosine = std::cos(radians(poleward));
+    int columnRadius = (cosine > 1e-6) ? static_cast<int>(std::ceil(spanDegrees / cosine / cellDegrees)) : columnCount;
+    bool allColumns = 2 * columnRadius + 1 >= columnCount;
+
+    int row = rowFor(latitude), column = columnFor(longitude);
+    int firstRow = std::max(0, row - rowRadius), lastRow = std::min(rowCount - 1, row + rowRadius);
+    int columnsScanned = allColumns ? columnCount : 2 * columnRadius + 1;
+    double cellsScanned = static_cast<double>(lastRow - firstRow + 1) * columnsScanned;
+
+    if (cellsScanned >= static_cast<double>(cells.size())) {
+        // Sparse index (or huge radius): checking every point is cheaper.
+        for (const auto& cell : cells) {
+            for (const Point& point : cell.second) { consider(point); }
+        }
+    } else {
+        for (int r = firstRow; r <= lastRow; ++r) {
+            for (int offset = 0; offset < columnsScanned; ++offset) {
+                int c = allColumns ? offset : ((column - columnRadius + offset) % columnCount + columnCount) % columnCount;
+                auto bucket = cells.find(cellKey(r, c));
+                if (bucket == cells.end()) { continue; }
+                for (const Point& point : bucket->second) { consider(point); }
+            }
+        }
+    }
+
+    std::size_t keep = std::min(k, found.size());
+    std::partial_sort(found.begin(), found.begin() + static_cast<std::ptrdiff_t>(keep), found.end(),
+                      [](const Neighbor& a, const Neighbor& b) { return a.distanceKm < b.distanceKm; });
+    found.resize(keep);
+    return found;
+}
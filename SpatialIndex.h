@@ -0,0 +1,59 @@
+// SpatialIndex.h
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <cstddef>       // For size_t
+#include <cstdint>       // For cell keys
+#include <unordered_map> // For the cell buckets
+#include <vector>        // For bucket contents and query results
+
+// Points on the globe (latitude/longitude in degrees) bucketed by grid cell, for "which known
+// sites are near here" queries. A query scans only the cells its search radius can reach
+// (wrapping across the antimeridian), or every point when that would touch more cells than
+// there are occupied ones. Distances are great-circle kilometres. Not thread-safe: owners
+// lock around it.
+class SpatialIndex {
+  public:
+  // A point found by nearest().
+  struct Neighbor {
+      std::size_t id;    // As passed to insert().
+      double distanceKm; // Great-circle distance from the query point.
+  };
+
+  // 'cellDegrees': bucket size; about the typical search radius works best.
+  explicit SpatialIndex(double cellDegrees = 0.25);
+
+  // Adds (or moves) point 'id'.
+  void insert(std::size_t id, double latitude, double longitude);
+  // Removes point 'id'. Returns false if it is not in the index.
+  bool remove(std::size_t id);
+  void clear();
+  std::size_t size() const { return cellOf.size(); }
+
+  // Returns up to 'k' points within 'maxKm' of (latitude, longitude), nearest first.
+  std::vector<Neighbor> nearest(double latitude, double longitude, std::size_t k, double maxKm) const;
+
+  // Great-circle (haversine) distance between two points, in kilometres.
+  static double distanceKm(double lat1, double lon1, double lat2, double lon2);
+
+  private:
+  struct Point {
+      std::size_t id;
+      double latitude;
+      double longitude;
+  };
+
+  double cellDegrees;
+  int rowCount;    // Cells from pole to pole.
+  int columnCount; // Cells around the globe.
+  std::unordered_map<std::uint64_t, std::vector<Point>> cells;
+  std::unordered_map<std::size_t, std::uint64_t> cellOf; // Where each id is stored.
+
+  int rowFor(double latitude) const;
+  int columnFor(double longitude) const;
+  static std::uint64_t cellKey(int row, int column) {
+      return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(row)) << 32) | static_cast<std::uint32_t>(column);
+  }
+};
+
+#endif // SPATIALINDEX_H
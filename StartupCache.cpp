@@ -0,0 +1,97 @@
+// StartupCache.cpp
+#include "StartupCache.h"
+#include "Trace.h"   // Optional span tracing of the load
+#include <cstdio>    // For std::snprintf, std::sscanf
+#include <cstring>   // For std::strcmp
+#include <fstream>   // For reading the cache file
+#include <utility>   // For std::move
+
+// --- Helper Functions (Anonymous Namespace) ---
+namespace {
+    // First line: format tag and version, kind, days, detail, fetch time and body size.
+    const char* const FORMAT_TAG = "weatherapp-report";
+    const int FORMAT_VERSION = 1;
+
+    // Reads the whole file with one read.
+    bool readFile(const std::string& path, std::string& text) {
+        std::ifstream infile(path, std::ios::binary);
+        if (!infile.is_open()) { return false; }
+        infile.seekg(0, std::ios::end);
+        std::streamoff size = infile.tellg();
+        if (size < 0) { return false; }
+        text.resize(static_cast<size_t>(size));
+        infile.seekg(0, std::ios::beg);
+        infile.read(&text[0], size);
+        text.resize(static_cast<size_t>(infile.gcount()));
+        return true;
+    }
+
+    // Takes the line starting at 'pos' (without its '\n') and advances 'pos' past it.
+    bool takeLine(const std::string& text, size_t& pos, std::string& line) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string::npos) { return false; }
+        line.assign(text, pos, end - pos);
+        pos = end + 1;
+        return true;
+    }
+} // end anonymous namespace
+
+// --- Constructor ---
+
+StartupCache::StartupCache(std::string cachePath) : path(std::move(cachePath)) {}
+
+// --- Load / Save ---
+
+bool StartupCache::load(CachedReport& report) const {
+    TRACE_SCOPE("StartupCache::load", "startup");
+    std::string text;
+    if (!readFile(path, text)) { return false; }
+
+    size_t pos = 0;
+    std::string header;
+    if (!takeLine(text, pos, header)) { return false; }
+    char tag[32], kind[16], detail[16];
+    int version = 0, days = 0;
+    long long fetchedEpoch = 0;
+    unsigned long long bodyBytes = 0;
+    if (std::sscanf(header.c_str(), "%31s %d %15s %d %15s %lld %llu", tag, &version, kind, &days, detail,
+                    &fetchedEpoch, &bodyBytes) != 7
+        || std::strcmp(tag, FORMAT_TAG) != 0 || version != FORMAT_VERSION) {
+        return false;
+    }
+    CachedReport loaded;
+    if (std::strcmp(kind, "current") == 0) {
+        loaded.kind = CachedReport::Kind::CURRENT;
+    } else if (std::strcmp(kind, "forecast") == 0) {
+        loaded.kind = CachedReport::Kind::FORECAST;
+    } else {
+        return false;
+    }
+    loaded.days = days;
+    loaded.detail = (std::strcmp(detail, "hourly") == 0) ? ForecastReport::DetailLevel::HOURLY
+                                                         : ForecastReport::DetailLevel::DAILY;
+    loaded.fetchedEpoch = fetchedEpoch;
+    if (!takeLine(text, pos, loaded.units) || !takeLine(text, pos, loaded.location)) { return false; }
+    if (text.size() - pos != bodyBytes) { return false; } // Truncated or appended to.
+    loaded.body.assign(text, pos, std::string::npos);
+
+    report = std::move(loaded);
+    return true;
+}
+
+void StartupCache::save(const CachedReport& report) {
+    char header[160];
+    std::snprintf(header, sizeof(header), "%s %d %s %d %s %lld %llu\n", FORMAT_TAG, FORMAT_VERSION,
+                  report.kind == CachedReport::Kind::CURRENT ? "current" : "forecast", report.days,
+                  report.detail == ForecastReport::DetailLevel::HOURLY ? "hourly" : "daily",
+                  report.fetchedEpoch, static_cast<unsigned long long>(report.body.size()));
+    std::string contents;
+    contents.reserve(sizeof(header) + report.units.size() + report.location.size() + report.body.size() + 2);
+    contents += header;
+    contents += report.units;
+    contents += '\n';
+    contents += report.location;
+    contents += '\n';
+    contents += report.body;
+    writer.submit(path, std::move(contents));
+}
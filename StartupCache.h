@@ -0,0 +1,47 @@
+// StartupCache.h
+#ifndef STARTUPCACHE_H
+#define STARTUPCACHE_H
+
+#include "AtomicFileWriter.h" // Background atomic saves
+#include "ForecastReport.h"   // DetailLevel of cached forecasts
+#include <string>             // For the path and response body
+
+// The last report shown, as the API response it was built from.
+struct CachedReport {
+    enum class Kind { CURRENT, FORECAST };
+
+    Kind kind = Kind::CURRENT;
+    int days = 0;                                                           // Forecast days (forecasts only).
+    ForecastReport::DetailLevel detail = ForecastReport::DetailLevel::DAILY; // Forecasts only.
+    std::string location;     // Query the response answered.
+    std::string units;
+    long long fetchedEpoch = 0; // Unix time the response was received.
+    std::string body;         // Raw API response (parsed again on load).
+};
+
+// Keeps the last shown report on disk, so the next run can show it before constructing its
+// thread pools and HTTP clients and before its first network request. The API key is not stored.
+// Saves replace the file atomically on a background thread.
+class StartupCache {
+  public:
+  explicit StartupCache(std::string path);
+
+  StartupCache(const StartupCache&) = delete;
+  StartupCache& operator=(const StartupCache&) = delete;
+
+  // Reads the cached report with one file read. Returns false if there is none or the file is
+  // damaged (e.g., truncated).
+  bool load(CachedReport& report) const;
+  // Queues 'report' to replace the cached one (written in the background).
+  void save(const CachedReport& report);
+  // Blocks until queued saves are on disk (the destructor also waits).
+  void flush() { writer.flush(); }
+
+  const std::string& getPath() const { return path; }
+
+  private:
+  std::string path;
+  AtomicFileWriter writer;
+};
+
+#endif // STARTUPCACHE_H
@@ -0,0 +1,186 @@
+// TaskScheduler.cpp
+#include "TaskScheduler.h"
+#include "Trace.h"     // For naming worker threads in traces
+
+#include <iostream>    // For error output (cerr)
+#include <exception>   // For std::exception
+#include <string>      // For thread names
+#include <utility>     // For std::move
+
+// --- Internal State (Anonymous Namespace) ---
+namespace {
+    // Identifies the CPU worker running on this thread, so nested submissions stay local.
+    thread_local const TaskScheduler* currentScheduler = nullptr;
+    thread_local unsigned currentWorker = 0;
+} // end anonymous namespace
+
+// --- Constructor / Destructor ---
+
+TaskScheduler::TaskScheduler(unsigned ioThreadCount, unsigned cpuThreadCount)
+    : ioStopping(false), cpuQueued(0), cpuStopping(false), nextWorker(0), steals(0) {
+    if (cpuThreadCount == 0) { cpuThreadCount = std::thread::hardware_concurrency(); }
+    if (cpuThreadCount == 0) { cpuThreadCount = 1; } // hardware_concurrency() may be unknown.
+    if (ioThreadCount == 0) { ioThreadCount = 1; }
+
+    for (unsigned i = 0; i < cpuThreadCount; ++i) {
+        workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+    for (unsigned i = 0; i < cpuThreadCount; ++i) {
+        cpuThreads.emplace_back(&TaskScheduler::cpuLoop, this, i);
+    }
+    for (unsigned i = 0; i < ioThreadCount; ++i) {
+        ioThreads.emplace_back(&TaskScheduler::ioLoop, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    // I/O first: its tasks may still hand work to the CPU pool.
+    {
+        std::lock_guard<std::mutex> lock(ioMutex);
+        ioStopping = true;
+    }
+    ioReady.notify_all();
+    for (auto& thread : ioThreads) { thread.join(); }
+
+    cpuStopping.store(true);
+    { std::lock_guard<std::mutex> lock(cpuMutex); } // Order the flag with sleepers' predicate checks.
+    cpuReady.notify_all();
+    for (auto& thread : cpuThreads) { thread.join(); }
+}
+
+// --- Submission ---
+
+void TaskScheduler::submitIo(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(ioMutex);
+        ioTasks.push_back(std::move(task));
+    }
+    ioReady.notify_one();
+}
+
+void TaskScheduler::submitCpu(Task task) {
+    unsigned target = (currentScheduler == this)
+        ? currentWorker
+        : nextWorker.fetch_add(1, std::memory_order_relaxed) % static_cast<unsigned>(workers.size());
+    {
+        std::lock_guard<std::mutex> lock(workers[target]->mutex);
+        workers[target]->tasks.push_back(std::move(task));
+    }
+    cpuQueued.fetch_add(1);
+    { std::lock_guard<std::mutex> lock(cpuMutex); } // Avoid a lost wakeup (see cpuLoop).
+    cpuReady.notify_one();
+}
+
+void TaskScheduler::wait(TaskGroup& group) {
+    if (currentScheduler != this) {
+        group.wait();
+        return;
+    }
+    Task task;
+    while (!group.waitFor(std::chrono::microseconds(0))) {
+        if (takeCpuTask(currentWorker, task)) {
+            runTask(task, "CPU");
+            task = nullptr;
+        } else {
+            group.waitFor(std::chrono::microseconds(200)); // Remaining tasks are running elsewhere.
+        }
+    }
+}
+
+// --- Worker Loops ---
+
+void TaskScheduler::runTask(Task& task, const char* pool) {
+    try {
+        task();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Unhandled exception in " << pool << " task: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Error: Unknown exception in " << pool << " task." << std::endl;
+    }
+}
+
+void TaskScheduler::ioLoop(unsigned index) {
+    Trace::setThreadName("io-" + std::to_string(index));
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(ioMutex);
+            ioReady.wait(lock, [this] { return ioStopping || !ioTasks.empty(); });
+            if (ioTasks.empty()) { return; } // Stopping and drained.
+            task = std::move(ioTasks.front());
+            ioTasks.pop_front();
+        }
+        runTask(task, "I/O");
+    }
+}
+
+bool TaskScheduler::takeCpuTask(unsigned index, Task& task) {
+    // Own deque, newest first.
+    {
+        Worker& own = *workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            cpuQueued.fetch_sub(1);
+            return true;
+        }
+    }
+    // Steal the oldest task from the next non-empty sibling.
+    unsigned count = static_cast<unsigned>(workers.size());
+    for (unsigned offset = 1; offset < count; ++offset) {
+        Worker& victim = *workers[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            cpuQueued.fetch_sub(1);
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::cpuLoop(unsigned index) {
+    currentScheduler = this;
+    currentWorker = index;
+    Trace::setThreadName("cpu-" + std::to_string(index));
+
+    Task task;
+    while (true) {
+        if (takeCpuTask(index, task)) {
+            runTask(task, "CPU");
+            task = nullptr; // Release captures before possibly sleeping.
+            continue;
+        }
+        // Submitters bump cpuQueued before taking cpuMutex to notify, so checking it
+        // under the same mutex cannot miss a wakeup.
+        std::unique_lock<std::mutex> lock(cpuMutex);
+        cpuReady.wait(lock, [this] { return cpuQueued.load() > 0 || cpuStopping.load(); });
+        if (cpuStopping.load() && cpuQueued.load() <= 0) { break; }
+    }
+    currentScheduler = nullptr;
+}
+
+// --- TaskGroup ---
+
+void TaskGroup::add(int count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending += count;
+}
+
+void TaskGroup::done() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--pending <= 0) { finished.notify_all(); }
+}
+
+void TaskGroup::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return pending <= 0; });
+}
+
+bool TaskGroup::waitFor(std::chrono::microseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return finished.wait_for(lock, timeout, [this] { return pending <= 0; });
+}
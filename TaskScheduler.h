@@ -0,0 +1,108 @@
+// TaskScheduler.h
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <atomic>             // For counters and the shutdown flag
+#include <chrono>             // For TaskGroup::waitFor
+#include <condition_variable> // For idle workers and TaskGroup::wait
+#include <cstdint>            // For fixed-width counters
+#include <deque>              // For per-worker task deques and the I/O queue
+#include <functional>         // For std::function task type
+#include <memory>             // For std::unique_ptr (workers)
+#include <mutex>              // For queue locks
+#include <thread>             // For worker threads
+#include <vector>             // For thread lists
+
+class TaskGroup;
+
+// Small two-pool scheduler for the fetch -> parse -> render pipeline.
+// I/O tasks (blocking HTTP calls) run on a dedicated FIFO pool, so a slow upstream only ever
+// occupies an I/O thread. CPU tasks (JSON parse, report building, formatting) run on one
+// worker per core, each with its own deque: a worker pops its newest task (cache-warm),
+// and idle workers steal the oldest task from a busy worker's deque.
+class TaskScheduler {
+  public:
+  using Task = std::function<void()>;
+
+  private:
+  // One CPU worker's deque. The owner pushes/pops at the back; thieves take from the front.
+  struct Worker {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers; // One entry per CPU thread.
+  std::vector<std::thread> cpuThreads;
+  std::vector<std::thread> ioThreads;
+
+  std::mutex ioMutex;                  // Guards ioTasks and ioStopping.
+  std::condition_variable ioReady;     // Signalled when an I/O task is queued or on shutdown.
+  std::deque<Task> ioTasks;            // Pending I/O tasks (FIFO).
+  bool ioStopping;
+
+  std::mutex cpuMutex;                 // Guards sleeping on cpuReady (tasks live in the workers).
+  std::condition_variable cpuReady;    // Signalled when a CPU task is queued or on shutdown.
+  std::atomic<std::int64_t> cpuQueued; // CPU tasks pushed but not yet taken.
+  std::atomic<bool> cpuStopping;
+  std::atomic<unsigned> nextWorker;    // Round-robin target for tasks submitted from outside.
+  std::atomic<std::uint64_t> steals;   // Tasks taken from another worker's deque.
+
+  // --- Private Helpers ---
+  void ioLoop(unsigned index);
+  void cpuLoop(unsigned index);
+  // Takes a task for worker 'index': its own newest first, else the oldest from a sibling.
+  bool takeCpuTask(unsigned index, Task& task);
+  // Runs a task, reporting (not propagating) exceptions so a worker never dies.
+  static void runTask(Task& task, const char* pool);
+
+  public:
+  // Constructor: Starts 'ioThreadCount' I/O threads and 'cpuThreadCount' CPU workers
+  // (0 = one per hardware thread).
+  explicit TaskScheduler(unsigned ioThreadCount = 8, unsigned cpuThreadCount = 0);
+  // Destructor: Finishes all queued I/O tasks, then all CPU tasks (including ones they
+  // submitted), and joins every thread.
+  ~TaskScheduler();
+
+  // Disable copy operations (owns threads).
+  TaskScheduler(const TaskScheduler&) = delete;
+  TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+  // Queues a blocking task (e.g. an HTTP request) on the I/O pool.
+  void submitIo(Task task);
+  // Queues a CPU-bound task. Called from a CPU worker, it goes onto that worker's own deque.
+  void submitCpu(Task task);
+  // Waits for 'group' to finish. On a CPU worker of this scheduler, keeps running queued
+  // CPU tasks while waiting (so nested fork/join cannot starve the pool); elsewhere, blocks.
+  void wait(TaskGroup& group);
+
+  // --- Statistics ---
+  unsigned getIoThreadCount() const { return static_cast<unsigned>(ioThreads.size()); }
+  unsigned getCpuThreadCount() const { return static_cast<unsigned>(cpuThreads.size()); }
+  std::uint64_t getStealCount() const { return steals.load(std::memory_order_relaxed); }
+};
+
+// Counts outstanding tasks so a caller can wait for a batch to finish.
+// Call add() before submitting, done() exactly once when each task (including any follow-up
+// stage it hands off to) completes. From a CPU worker, wait through TaskScheduler::wait.
+class TaskGroup {
+  private:
+  std::mutex mutex;
+  std::condition_variable finished;
+  int pending;
+
+  public:
+  TaskGroup() : pending(0) {}
+
+  // Disable copy operations (holds a mutex).
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  void add(int count = 1);
+  void done();
+  // Blocks until every added task has called done().
+  void wait();
+  // Blocks until done or until 'timeout' passes; returns true if done.
+  bool waitFor(std::chrono::microseconds timeout);
+};
+
+#endif // TASKSCHEDULER_H
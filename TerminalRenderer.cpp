@@ -0,0 +1,162 @@
+// TerminalRenderer.cpp
+#include "TerminalRenderer.h"
+#include "Trace.h"    // Optional span tracing of frame output
+#include <cstdio>     // For std::snprintf, std::fwrite
+#include <cstdlib>    // For std::getenv, std::system
+#include <cstring>    // For std::strcmp
+#include <iostream>   // For flushing std::cout before raw writes
+#include <utility>    // For std::move
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>  // For console modes and size
+#else
+#include <cerrno>     // For EINTR
+#include <sys/ioctl.h> // For TIOCGWINSZ
+#include <unistd.h>   // For write, isatty
+#endif
+
+// --- Helper Functions (Anonymous Namespace) ---
+namespace {
+    // Appends "move the cursor to 'row', 'column'" (both 1-based).
+    void appendMove(std::string& out, std::size_t row, std::size_t column = 1) {
+        char code[32];
+        std::snprintf(code, sizeof(code), "\033[%lu;%luH", static_cast<unsigned long>(row), static_cast<unsigned long>(column));
+        out += code;
+    }
+
+    // Splits 'frame' into lines (a trailing '\n' does not start another line).
+    std::vector<std::string> splitLines(const std::string& frame) {
+        std::vector<std::string> lines;
+        std::size_t start = 0;
+        while (start < frame.size()) {
+            std::size_t end = frame.find('\n', start);
+            if (end == std::string::npos) { end = frame.size(); }
+            lines.emplace_back(frame, start, end - start);
+            start = end + 1;
+        }
+        return lines;
+    }
+
+    // Length of the common leading ASCII bytes of 'a' and 'b' (where bytes and columns agree).
+    std::size_t asciiPrefix(const std::string& a, const std::string& b) {
+        std::size_t n = 0;
+        std::size_t limit = a.size() < b.size() ? a.size() : b.size();
+        while (n < limit && a[n] == b[n] && static_cast<unsigned char>(a[n]) < 0x80) { ++n; }
+        return n;
+    }
+
+    // Checks once whether standard output is a terminal that understands escape codes.
+    bool detectAnsi() {
+#ifdef _WIN32
+        HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+        DWORD mode = 0;
+        if (console == INVALID_HANDLE_VALUE || !GetConsoleMode(console, &mode)) { return false; }
+        // Windows 10+ consoles interpret ANSI codes once VT processing is switched on.
+        return SetConsoleMode(console, mode | 0x0004 /* ENABLE_VIRTUAL_TERMINAL_PROCESSING */) != 0;
+#else
+        const char* term = std::getenv("TERM");
+        return isatty(STDOUT_FILENO) && !(term != nullptr && std::strcmp(term, "dumb") == 0);
+#endif
+    }
+} // end anonymous namespace
+
+// --- Constructor ---
+
+TerminalRenderer::TerminalRenderer() : previousValid(false), ansi(detectAnsi()) {}
+
+// --- Output ---
+
+int TerminalRenderer::terminalRows() {
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) { return 0; }
+    return info.srWindow.Bottom - info.srWindow.Top + 1;
+#else
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0) { return 0; }
+    return size.ws_row;
+#endif
+}
+
+void TerminalRenderer::writeOut(const std::string& data) {
+    std::cout.flush(); // Anything already printed goes first.
+#ifdef _WIN32
+    std::fwrite(data.data(), 1, data.size(), stdout);
+    std::fflush(stdout);
+#else
+    std::size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = ::write(STDOUT_FILENO, data.data() + written, data.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) { continue; }
+            return; // Terminal gone (e.g., SSH dropped); nothing useful to do.
+        }
+        written += static_cast<std::size_t>(n);
+    }
+#endif
+}
+
+void TerminalRenderer::buildUpdate(const std::vector<std::string>& lines, int rows, std::string& out) const {
+    // Rows scrolled off the top can't be addressed, so frames as tall as the screen are redrawn.
+    const bool full = !previousValid || (rows > 0 && lines.size() >= static_cast<std::size_t>(rows));
+    if (full) {
+        out += "\033[H\033[2J";
+        for (const auto& line : lines) {
+            out += line;
+            out += "\r\n"; // Also correct when the terminal is in raw mode.
+        }
+        return; // The cursor is already on the line below the frame.
+    }
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        if (i < previous.size() && previous[i] == lines[i]) { continue; }
+        // Rewrite from the first changed column to the end of the line.
+        std::size_t skip = (i < previous.size()) ? asciiPrefix(previous[i], lines[i]) : 0;
+        appendMove(out, i + 1, skip + 1);
+        out.append(lines[i], skip, std::string::npos);
+        out += "\033[K"; // Erase what is left of a longer old line.
+    }
+    // Leave the cursor below the frame, erasing old lines below it if the frame got shorter.
+    appendMove(out, lines.size() + 1);
+    if (lines.size() < previous.size()) { out += "\033[J"; }
+}
+
+std::size_t TerminalRenderer::present(const std::string& frame) {
+    TRACE_SCOPE("TerminalRenderer::present", "render");
+    std::vector<std::string> lines = splitLines(frame);
+    if (!ansi) {
+        writeOut(frame);
+        previousValid = false;
+        return frame.size();
+    }
+    const int rows = terminalRows();
+    std::string out;
+    out.reserve(frame.size() + 64);
+    buildUpdate(lines, rows, out);
+    writeOut(out);
+
+    previousValid = !(rows > 0 && lines.size() >= static_cast<std::size_t>(rows));
+    previous = std::move(lines);
+    return out.size();
+}
+
+void TerminalRenderer::clear() {
+    previous.clear();
+    if (ansi) {
+        writeOut("\033[H\033[2J\033[3J"); // Home, clear the screen, clear the scrollback.
+        previousValid = true;             // The screen now matches an empty frame.
+        return;
+    }
+    previousValid = false;
+#ifdef _WIN32
+    std::cout.flush();
+    std::system("CLS"); // Consoles without VT processing (before Windows 10).
+#endif
+}
+
+void TerminalRenderer::write(const std::string& text) {
+    writeOut(text);
+    previousValid = false;
+}
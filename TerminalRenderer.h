@@ -0,0 +1,51 @@
+// TerminalRenderer.h
+#ifndef TERMINALRENDERER_H
+#define TERMINALRENDERER_H
+
+#include <cstddef> // For size_t
+#include <string>  // For frames
+#include <vector>  // For the lines of the previous frame
+
+// Draws full-screen text frames on a terminal with ANSI escape codes.
+// The renderer keeps the previous frame (double buffering). Each present() compares the new
+// frame line by line and rewrites only the lines that changed, so an auto-refreshing view
+// sends a few hundred bytes per update instead of a whole screen. Everything for one frame
+// goes out in a single write() (no per-line flushing). If output is not a terminal, or the
+// terminal does not understand ANSI codes, frames are written as plain text. Not thread-safe.
+class TerminalRenderer {
+  public:
+  // Renders to standard output.
+  TerminalRenderer();
+
+  TerminalRenderer(const TerminalRenderer&) = delete;
+  TerminalRenderer& operator=(const TerminalRenderer&) = delete;
+
+  // Shows 'frame' ('\n'-separated lines) as the whole screen, starting at the top-left
+  // corner, and leaves the cursor on the line below it. Returns the bytes written.
+  std::size_t present(const std::string& frame);
+  // Clears the screen and its scrollback.
+  void clear();
+  // Writes 'text' at the cursor (e.g., a report below the menu). The next present() redraws
+  // the whole screen, since the text may have scrolled it.
+  void write(const std::string& text);
+  // Forgets the previous frame, so the next present() clears and redraws everything (call
+  // after something else, such as a prompt, has written to the screen).
+  void invalidate() { previousValid = false; }
+
+  // True if escape codes are in use (a terminal, with VT processing on Windows).
+  bool usesAnsi() const { return ansi; }
+  // Number of rows on the terminal, or 0 if unknown.
+  static int terminalRows();
+
+  private:
+  std::vector<std::string> previous; // Lines of the frame on screen.
+  bool previousValid;                // 'previous' matches the screen.
+  bool ansi;
+
+  // Appends the escape codes and text that turn the screen into 'lines' ('rows': terminal height, 0 = unknown).
+  void buildUpdate(const std::vector<std::string>& lines, int rows, std::string& out) const;
+  // Flushes std::cout (keeping output order), then writes all of 'data'.
+  static void writeOut(const std::string& data);
+};
+
+#endif // TERMINALRENDERER_H
@@ -0,0 +1,135 @@
+// TimeFormat.cpp
+#include "TimeFormat.h"
+
+#include <cstdlib> // For std::llabs
+
+// --- Internal Helper Functions (Anonymous Namespace) ---
+namespace {
+    const long long SECONDS_PER_DAY = 86400;
+
+    // Day names indexed by weekday (0 = Sunday), plus the fallback at index 7.
+    const std::string DAY_NAMES[8] = {"Sunday", "Monday", "Tuesday", "Wednesday",
+                                      "Thursday", "Friday", "Saturday", "Unknown Day"};
+
+    // Floor division for possibly negative epoch values.
+    long long floorDiv(long long a, long long b) {
+        return (a >= 0) ? a / b : -((-a + b - 1) / b);
+    }
+
+    // Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's algorithm).
+    long long daysFromCivil(int y, int m, int d) {
+        y -= (m <= 2) ? 1 : 0;
+        const long long era = (y >= 0 ? y : y - 399) / 400;
+        const long long yoe = y - era * 400;
+        const long long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        const long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    // Inverse of daysFromCivil.
+    void civilFromDays(long long z, int& y, int& m, int& d) {
+        z += 719468;
+        const long long era = (z >= 0 ? z : z - 146096) / 146097;
+        const long long doe = z - era * 146097;
+        const long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const long long mp = (5 * doy + 2) / 153;
+        d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+        m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+        y = static_cast<int>(yoe + era * 400 + (m <= 2 ? 1 : 0));
+    }
+
+    // Reads a run of 'minDigits'..'maxDigits' decimal digits starting at 'pos'.
+    bool readNumber(const std::string& s, size_t& pos, size_t minDigits, size_t maxDigits, int& value) {
+        size_t start = pos;
+        value = 0;
+        while (pos < s.size() && pos - start < maxDigits && s[pos] >= '0' && s[pos] <= '9') {
+            value = value * 10 + (s[pos] - '0');
+            ++pos;
+        }
+        return pos - start >= minDigits;
+    }
+
+    // Parses "YYYY-MM-DD" into its parts.
+    bool parseDate(const std::string& s, size_t& pos, int& y, int& m, int& d) {
+        return readNumber(s, pos, 4, 4, y) && pos < s.size() && s[pos++] == '-'
+            && readNumber(s, pos, 1, 2, m) && pos < s.size() && s[pos++] == '-'
+            && readNumber(s, pos, 1, 2, d) && m >= 1 && m <= 12 && d >= 1 && d <= 31;
+    }
+
+    // Writes 'value' as two digits.
+    void putTwoDigits(char* out, int value) {
+        out[0] = static_cast<char>('0' + value / 10);
+        out[1] = static_cast<char>('0' + value % 10);
+    }
+} // end anonymous namespace
+
+// --- Offsets ---
+
+int TimeFormat::utcOffsetFromLocal(long long epoch, const std::string& localTime, int fallback) {
+    size_t pos = 0;
+    int y, m, d, hour, minute;
+    if (!parseDate(localTime, pos, y, m, d)) { return fallback; }
+    while (pos < localTime.size() && (localTime[pos] == ' ' || localTime[pos] == 'T')) { ++pos; }
+    if (!readNumber(localTime, pos, 1, 2, hour) || pos >= localTime.size() || localTime[pos++] != ':'
+        || !readNumber(localTime, pos, 2, 2, minute) || hour > 23 || minute > 59) {
+        return fallback;
+    }
+
+    long long localAsUtc = daysFromCivil(y, m, d) * SECONDS_PER_DAY + hour * 3600 + minute * 60;
+    long long offset = localAsUtc - epoch;
+    // The local string has minute precision (and the epoch may be a few seconds later);
+    // real offsets are multiples of 15 minutes.
+    const long long quarter = 15 * 60;
+    offset = floorDiv(offset + quarter / 2, quarter) * quarter;
+    if (std::llabs(offset) > 18 * 3600) { return fallback; } // Outside any real zone.
+    return static_cast<int>(offset);
+}
+
+// --- Formatting ---
+
+std::string TimeFormat::formatHourMinute(long long epoch, int offsetSeconds) {
+    long long local = epoch + offsetSeconds;
+    long long secs = local - floorDiv(local, SECONDS_PER_DAY) * SECONDS_PER_DAY;
+    char buf[5];
+    putTwoDigits(buf, static_cast<int>(secs / 3600));
+    buf[2] = ':';
+    putTwoDigits(buf + 3, static_cast<int>((secs % 3600) / 60));
+    return std::string(buf, 5);
+}
+
+std::string TimeFormat::formatDateTime(long long epoch, int offsetSeconds) {
+    long long local = epoch + offsetSeconds;
+    long long days = floorDiv(local, SECONDS_PER_DAY);
+    long long secs = local - days * SECONDS_PER_DAY;
+    int y, m, d;
+    civilFromDays(days, y, m, d);
+    if (y < 0 || y > 9999) { return "(time out of range)"; }
+
+    char buf[19]; // "YYYY-MM-DD HH:MM:SS"
+    putTwoDigits(buf, y / 100);
+    putTwoDigits(buf + 2, y % 100);
+    buf[4] = '-';
+    putTwoDigits(buf + 5, m);
+    buf[7] = '-';
+    putTwoDigits(buf + 8, d);
+    buf[10] = ' ';
+    putTwoDigits(buf + 11, static_cast<int>(secs / 3600));
+    buf[13] = ':';
+    putTwoDigits(buf + 14, static_cast<int>((secs % 3600) / 60));
+    buf[16] = ':';
+    putTwoDigits(buf + 17, static_cast<int>(secs % 60));
+    return std::string(buf, 19);
+}
+
+// --- Day Names ---
+
+const std::string& TimeFormat::dayName(const std::string& date) {
+    size_t pos = 0;
+    int y, m, d;
+    if (!parseDate(date, pos, y, m, d)) { return DAY_NAMES[7]; }
+    long long days = daysFromCivil(y, m, d);
+    // 1970-01-01 was a Thursday (index 4).
+    long long weekday = (days % 7 + 7 + 4) % 7;
+    return DAY_NAMES[weekday];
+}
@@ -0,0 +1,47 @@
+// TimeFormat.h
+#ifndef TIMEFORMAT_H
+#define TIMEFORMAT_H
+
+#include "InternedString.h" // Shared location strings
+#include <string> // For formatted results
+
+// Time-zone information for a forecast location, taken from the API's "location" block.
+// Times are shown in the location's own zone rather than the host's. The strings are interned
+// (many forecasts share a region, country and zone).
+struct LocationInfo {
+    InternedString name;     // City/place name.
+    InternedString region;   // Region/state.
+    InternedString country;  // Country.
+    InternedString tzId;     // IANA zone id (e.g., "Europe/London"), used as a display label.
+    int utcOffsetSeconds;    // Local time minus UTC at the time of the request.
+    double latitude;         // Degrees north (valid when hasCoordinates).
+    double longitude;        // Degrees east (valid when hasCoordinates).
+    bool hasCoordinates;     // The block gave both "lat" and "lon".
+
+    LocationInfo() : utcOffsetSeconds(0), latitude(0.0), longitude(0.0), hasCoordinates(false) {}
+};
+
+// Arithmetic date/time formatting for API timestamps. Avoids localtime/strftime/mktime
+// (locale, TZ lookups and global state) on hot paths: a UTC offset is derived once per
+// location and every timestamp is then formatted with integer math.
+class TimeFormat {
+  public:
+  // Delete constructor to prevent instantiation of this utility class.
+  TimeFormat() = delete;
+
+  // Returns the UTC offset implied by an epoch and the same instant's local wall time
+  // ("YYYY-MM-DD H:MM" or "YYYY-MM-DD HH:MM", as in the API's "localtime"/"time" fields),
+  // rounded to the nearest 15 minutes. Returns 'fallback' if 'localTime' is malformed.
+  static int utcOffsetFromLocal(long long epoch, const std::string& localTime, int fallback = 0);
+
+  // Formats 'epoch' shifted by 'offsetSeconds' as "HH:MM".
+  static std::string formatHourMinute(long long epoch, int offsetSeconds);
+  // Formats 'epoch' shifted by 'offsetSeconds' as "YYYY-MM-DD HH:MM:SS".
+  static std::string formatDateTime(long long epoch, int offsetSeconds);
+
+  // Returns the weekday name for a "YYYY-MM-DD" date (e.g., "Tuesday"), or "Unknown Day".
+  // The returned reference points into a static table and stays valid.
+  static const std::string& dayName(const std::string& date);
+};
+
+#endif // TIMEFORMAT_H
@@ -0,0 +1,172 @@
+// Trace.cpp
+#include "Trace.h"
+
+#include <chrono>       // For the monotonic clock
+#include <memory>       // For std::unique_ptr (ring buffer storage)
+#include <mutex>        // For thread name registration and export
+#include <map>          // For thread id -> name lookup
+#include <fstream>      // For writing the trace file
+#include <iostream>     // For error output (cerr)
+
+// --- Static Member Definition ---
+std::atomic<bool> Trace::enabled(false);
+
+// --- Internal Storage (Anonymous Namespace) ---
+namespace {
+    // One ring buffer slot. Fields are atomics so the exporter can read while threads record;
+    // 'sequence' works as a seqlock (odd = being written, 2*index+2 = complete for 'index').
+    struct Event {
+        std::atomic<std::uint64_t> sequence;
+        std::atomic<const char*> name;
+        std::atomic<const char*> category;
+        std::atomic<std::int64_t> startMicros;
+        std::atomic<std::int64_t> durationMicros; // -1 for instant events
+        std::atomic<std::uint32_t> threadId;
+    };
+
+    std::unique_ptr<Event[]> buffer;             // Ring buffer (replaced only by enable()).
+    std::size_t capacity = 0;                    // Number of slots in 'buffer'.
+    std::atomic<std::uint64_t> nextIndex(0);     // Total events ever claimed since enable().
+    std::atomic<std::int64_t> originTicks(0);    // steady_clock ticks at enable().
+    std::atomic<std::uint32_t> nextThreadId(1);  // Source of small, stable thread ids.
+
+    std::mutex namesMutex;                       // Guards 'threadNames'.
+    std::map<std::uint32_t, std::string> threadNames;
+
+    // Returns the calling thread's small trace id (assigned on first use).
+    std::uint32_t currentThreadId() {
+        thread_local std::uint32_t id = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
+    // Claims the next slot and fills it.
+    void writeEvent(const char* name, const char* category, std::int64_t start, std::int64_t duration) {
+        if (capacity == 0) { return; }
+        std::uint64_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+        Event& slot = buffer[index % capacity];
+        slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.category.store(category, std::memory_order_relaxed);
+        slot.startMicros.store(start, std::memory_order_relaxed);
+        slot.durationMicros.store(duration, std::memory_order_relaxed);
+        slot.threadId.store(currentThreadId(), std::memory_order_relaxed);
+        slot.sequence.store(2 * index + 2, std::memory_order_release);
+    }
+
+    // Writes 's' as a JSON string literal (names are usually literals, but thread names are not).
+    void writeJsonString(std::ostream& os, const std::string& s) {
+        os << '"';
+        for (char c : s) {
+            if (c == '"' || c == '\\') { os << '\\' << c; }
+            else if (static_cast<unsigned char>(c) < 0x20) { os << ' '; }
+            else { os << c; }
+        }
+        os << '"';
+    }
+} // end anonymous namespace
+
+// --- Control ---
+
+// Allocates a fresh ring buffer and starts recording.
+// Intended to be called at startup, before worker threads begin producing spans.
+void Trace::enable(std::size_t cap) {
+    enabled.store(false, std::memory_order_relaxed);
+    capacity = cap > 0 ? cap : 1;
+    buffer.reset(new Event[capacity]);
+    for (std::size_t i = 0; i < capacity; ++i) {
+        buffer[i].sequence.store(0, std::memory_order_relaxed);
+    }
+    nextIndex.store(0, std::memory_order_relaxed);
+    originTicks.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    enabled.store(true, std::memory_order_release);
+}
+
+void Trace::disable() {
+    enabled.store(false, std::memory_order_release);
+}
+
+// --- Recording ---
+
+std::int64_t Trace::nowMicros() {
+    auto ticks = std::chrono::steady_clock::now().time_since_epoch().count() - originTicks.load(std::memory_order_relaxed);
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::duration(ticks)).count();
+}
+
+void Trace::recordSpan(const char* name, const char* category, std::int64_t startMicros, std::int64_t durationMicros) {
+    if (!isEnabled()) { return; }
+    writeEvent(name, category, startMicros, durationMicros < 0 ? 0 : durationMicros);
+}
+
+void Trace::recordInstant(const char* name, const char* category) {
+    if (!isEnabled()) { return; }
+    writeEvent(name, category, nowMicros(), -1);
+}
+
+void Trace::setThreadName(const std::string& name) {
+    std::lock_guard<std::mutex> lock(namesMutex);
+    threadNames[currentThreadId()] = name;
+}
+
+// --- Export ---
+
+void Trace::writeChromeJson(std::ostream& os) {
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    // Thread name metadata so viewers label each track.
+    {
+        std::lock_guard<std::mutex> lock(namesMutex);
+        for (const auto& entry : threadNames) {
+            os << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << entry.first
+               << ",\"args\":{\"name\":";
+            writeJsonString(os, entry.second);
+            os << "}}";
+            first = false;
+        }
+    }
+
+    // Events from oldest to newest that are still in the ring buffer.
+    std::uint64_t total = nextIndex.load(std::memory_order_acquire);
+    std::uint64_t begin = total > capacity ? total - capacity : 0;
+    for (std::uint64_t index = begin; index < total && capacity > 0; ++index) {
+        const Event& slot = buffer[index % capacity];
+        std::uint64_t expected = 2 * index + 2;
+        if (slot.sequence.load(std::memory_order_acquire) != expected) { continue; } // Incomplete or overwritten.
+        const char* name = slot.name.load(std::memory_order_relaxed);
+        const char* category = slot.category.load(std::memory_order_relaxed);
+        std::int64_t start = slot.startMicros.load(std::memory_order_relaxed);
+        std::int64_t duration = slot.durationMicros.load(std::memory_order_relaxed);
+        std::uint32_t tid = slot.threadId.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != expected) { continue; } // Overwritten while reading.
+
+        os << (first ? "" : ",") << "\n{\"name\":";
+        writeJsonString(os, name ? name : "?");
+        os << ",\"cat\":";
+        writeJsonString(os, category ? category : "");
+        if (duration < 0) {
+            os << ",\"ph\":\"i\",\"s\":\"t\",\"ts\":" << start;
+        } else {
+            os << ",\"ph\":\"X\",\"ts\":" << start << ",\"dur\":" << duration;
+        }
+        os << ",\"pid\":1,\"tid\":" << tid << "}";
+        first = false;
+    }
+    os << "\n]}" << std::endl;
+}
+
+bool Trace::writeChromeJson(const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open trace file '" << path << "' for writing." << std::endl;
+        return false;
+    }
+    writeChromeJson(out);
+    out.close();
+    if (!out) {
+        std::cerr << "Error: Failed to write trace file '" << path << "'." << std::endl;
+        return false;
+    }
+    return true;
+}
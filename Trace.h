@@ -0,0 +1,76 @@
+// Trace.h
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>  // For the global enabled flag
+#include <cstdint> // For fixed-width timestamp types
+#include <cstddef> // For size_t
+#include <ostream> // For the export method parameter
+#include <string>  // For the export file path
+
+// Optional event tracer producing Chrome "trace_event" JSON (viewable in chrome://tracing
+// or ui.perfetto.dev). Spans are written into a fixed-size ring buffer without locks;
+// when the buffer wraps, the oldest events are overwritten.
+// While disabled, each span costs a single relaxed atomic load.
+class Trace {
+  private:
+  static std::atomic<bool> enabled; // Whether spans are currently being recorded.
+
+  public:
+  // Delete constructor to prevent instantiation of this utility class.
+  Trace() = delete;
+
+  // --- Control ---
+
+  // Starts recording into a ring buffer holding up to 'capacity' events.
+  // Discards any previously recorded events.
+  static void enable(std::size_t capacity = 65536);
+  // Stops recording. Recorded events are kept until the next enable().
+  static void disable();
+  // Returns true if spans are being recorded (cheap; safe to call on hot paths).
+  static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+  // --- Recording ---
+
+  // Returns microseconds since tracing was enabled (monotonic clock).
+  static std::int64_t nowMicros();
+  // Records a complete span. 'name' and 'category' must be string literals (not copied).
+  static void recordSpan(const char* name, const char* category, std::int64_t startMicros, std::int64_t durationMicros);
+  // Records an instantaneous event (e.g. "socket ready"). Same lifetime rule as recordSpan.
+  static void recordInstant(const char* name, const char* category);
+  // Names the calling thread in the trace output (e.g. "io-0", "cpu-3"). The name is copied.
+  static void setThreadName(const std::string& name);
+
+  // --- Export ---
+
+  // Writes all recorded events as Chrome trace_event JSON.
+  static void writeChromeJson(std::ostream& os);
+  // Writes all recorded events to 'path'. Returns false if the file cannot be written.
+  static bool writeChromeJson(const std::string& path);
+};
+
+// RAII span: records the time from construction to destruction when tracing is enabled.
+class TraceSpan {
+  private:
+  const char* name;          // Span name (string literal).
+  const char* category;      // Span category (string literal).
+  std::int64_t startMicros;  // Start timestamp, or -1 if tracing was disabled at construction.
+
+  public:
+  TraceSpan(const char* n, const char* c)
+      : name(n), category(c), startMicros(Trace::isEnabled() ? Trace::nowMicros() : -1) {}
+  ~TraceSpan() {
+      if (startMicros >= 0) { Trace::recordSpan(name, category, startMicros, Trace::nowMicros() - startMicros); }
+  }
+
+  // Disable copy operations (each span records exactly once).
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+// Helper macros to declare a uniquely named span covering the rest of the enclosing scope.
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name, category) TraceSpan TRACE_CONCAT(traceSpan_, __LINE__)(name, category)
+
+#endif // TRACE_H
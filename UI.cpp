@@ -2,57 +2,121 @@
 #include "UI.h"
 #include "IDisplayable.h" // Needed for displayReport parameter type
 #include "Preferences.h"  // Needed for displayPreferences parameter type
+#include "Metrics.h"      // For render timing and the metrics summary
+#include "TerminalRenderer.h" // Screen output in single writes
 #include <iostream>       // For console I/O (cout, cin)
+#include <sstream>        // For building screens in memory
 #include <limits>         // For numeric_limits (used in input validation)
 #include <string>         // For string manipulation
-#include <cstdlib>        // For system() calls (clear, pause) - Platform dependent
 
 // Use standard namespace for convenience.
 using namespace std;
 
+// --- Helper Functions (Anonymous Namespace) ---
+namespace {
+    // Writes the settings block shown above the menu.
+    void writePreferences(ostream& os, const Preferences& prefs) {
+        os << "--- Current Settings ---\n";
+        os << "Location:      " << prefs.getLocation() << '\n';
+        if (!prefs.getWatchlist().empty()) {
+            os << "Watchlist:     " << prefs.getWatchlist().size() << " location(s)\n";
+        }
+        if (!prefs.getActiveProfile().empty()) {
+            os << "Profile:       " << prefs.getActiveProfile() << '\n';
+        }
+        os << "Units:         " << prefs.getUnits() << '\n';
+        os << "Forecast Days: " << prefs.getForecastDays() << '\n';
+        // Indicate whether the API key has been set (without displaying the key itself).
+        os << "API Key Set:   " << (prefs.getApiKey().empty() ? "No" : "Yes") << '\n';
+        os << "------------------------\n";
+    }
+
+    // Writes the main menu options.
+    void writeMenu(ostream& os) {
+        os << "\n=== Weather App Menu ===\n"
+           << "1. Get Current Weather\n"
+           << "2. Get Hourly Forecast\n"
+           << "3. Get Daily Forecast\n"
+           << "4. Update Location\n"
+           << "5. Update Units (Metric/Imperial)\n"
+           << "6. Update Forecast Days (1-14)\n"
+           << "7. View Performance Metrics\n"
+           << "8. View Watchlist Dashboard\n"
+           << "9. Edit Watchlist\n"
+           << "10. Export Forecasts (CSV/NDJSON/Arrow)\n"
+           << "11. Live Mode (auto-refresh)\n"
+           << "12. Exit\n"
+           << "========================\n";
+    }
+} // end anonymous namespace
+
+// The application's terminal (one per process).
+TerminalRenderer& UI::terminal() {
+    static TerminalRenderer renderer;
+    return renderer;
+}
+
 // --- Display Methods ---
 
 // Displays a report by leveraging the overloaded << operator for IDisplayable.
+// The report is formatted in memory and written in one piece.
 void UI::displayReport(const IDisplayable& report) {
-    cout << report; // Polymorphic call to the report's display() method via operator<<
+    ScopedTimer renderTimer(MetricStage::RENDER);
+    ostringstream text;
+    text << report; // Polymorphic call to the report's display() method via operator<<
+    terminal().write(text.str());
+}
+
+// Prints how old a cached report is, so it is not mistaken for live data.
+void UI::displayCachedReportNotice(long long ageSeconds) {
+    if (ageSeconds < 0) { ageSeconds = 0; } // Clock changed since it was saved.
+    cout << "(Saved report from ";
+    if (ageSeconds < 60) { cout << ageSeconds << " s"; }
+    else if (ageSeconds < 3600) { cout << ageSeconds / 60 << " min"; }
+    else if (ageSeconds < 2 * 86400) { cout << ageSeconds / 3600 << " h"; }
+    else { cout << ageSeconds / 86400 << " days"; }
+    cout << " ago. Choose an option to fetch live data.)" << endl;
+}
+
+// Prints the collected performance metrics (latency per stage, bytes, cache and errors).
+void UI::displayMetrics() {
+    ostringstream text;
+    Metrics::writeSummary(text);
+    terminal().write(text.str());
 }
 
 // Prints the main menu options to the console.
 void UI::displayMenu() {
-    cout << "\n=== Weather App Menu ===" << endl;
-    cout << "1. Get Current Weather" << endl;
-    cout << "2. Get Hourly Forecast" << endl;
-    cout << "3. Get Daily Forecast" << endl;
-    cout << "4. Update Location" << endl;
-    cout << "5. Update Units (Metric/Imperial)" << endl;
-    cout << "6. Update Forecast Days (1-3)" << endl;
-    cout << "7. Exit" << endl;
-    cout << "========================" << endl;
+    ostringstream text;
+    writeMenu(text);
+    terminal().write(text.str());
 }
 
 // Prints the current preference settings from the Preferences object.
 void UI::displayPreferences(const Preferences& prefs) {
-     cout << "--- Current Settings ---" << endl;
-     cout << "Location:      " << prefs.getLocation() << endl;
-     cout << "Units:         " << prefs.getUnits() << endl;
-     cout << "Forecast Days: " << prefs.getForecastDays() << endl;
-     // Indicate whether the API key has been set (without displaying the key itself).
-     cout << "API Key Set:   " << (prefs.getApiKey().empty() ? "No" : "Yes") << endl;
-     cout << "------------------------" << endl;
+    ostringstream text;
+    writePreferences(text, prefs);
+    terminal().write(text.str());
+}
+
+// Shows the settings and the menu as one screen (one write, clearing first unless asked not to).
+void UI::displayMainScreen(const Preferences& prefs, bool clearFirst) {
+    ostringstream text;
+    writePreferences(text, prefs);
+    writeMenu(text);
+    if (clearFirst) {
+        terminal().invalidate(); // Prompts and reports scrolled the screen since the last frame.
+        terminal().present(text.str());
+    } else {
+        terminal().write(text.str());
+    }
 }
 
 // --- Console Utilities ---
 
-// Clears the console screen using platform-specific commands.
+// Clears the console screen with ANSI escape codes (no shell or child process).
 void UI::clearConsole() {
-    // Ensure output buffer is flushed before calling system command.
-    cout << flush;
-#ifdef _WIN32 // Windows-specific command
-    system("CLS");
-#else // Assumed POSIX-compliant (Linux, macOS) - uses ANSI escape or 'clear' command.
-    // system("printf '\\33c'"); // Alternative using ANSI reset code
-    system("clear"); // More common POSIX command
-#endif
+    terminal().clear();
 }
 
 // Pauses execution and waits for user input (Enter key).
@@ -91,14 +155,14 @@ string UI::getTextInput(const string& prompt) {
     return input;
 }
 
-// Gets the desired number of forecast days from the user, validating the range [1, 3].6
+// Gets the desired number of forecast days from the user, validating the range [1, 14].
 
 int UI::getForecastDaysInput() {
      int days = 0;
-     cout << "Enter new number of forecast days (1-3): ";
-     // Loop until valid integer input within the range [1, 3] is received.
-      while (!(cin >> days) || days < 1 || days > 3) {
-        cout << "Invalid input. Please enter a number between 1 and 3: ";
+     cout << "Enter new number of forecast days (1-14): ";
+     // Loop until valid integer input within the range [1, 14] is received.
+      while (!(cin >> days) || days < 1 || days > 14) {
+        cout << "Invalid input. Please enter a number between 1 and 14: ";
         cin.clear();
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
     }
@@ -7,6 +7,7 @@
 // Forward declarations of classes used by UI functions (reduces header dependencies).
 class IDisplayable; // Interface for objects that can be displayed.
 class Preferences;  // Class holding application settings.
+class TerminalRenderer; // Buffered ANSI screen output.
 
 // Provides static methods for handling console-based User Interface interactions.
 // Designed as a utility class (no instances needed).
@@ -27,11 +28,24 @@ class UI {
     // Displays the current settings stored in the Preferences object.
     static void displayPreferences(const Preferences& prefs);
 
+    // Displays the settings and the menu as one screen in a single write, clearing the
+    // console first if 'clearFirst' is set.
+    static void displayMainScreen(const Preferences& prefs, bool clearFirst = true);
+
+    // Introduces a report loaded from the on-disk cache, fetched 'ageSeconds' ago.
+    static void displayCachedReportNotice(long long ageSeconds);
+
+    // Displays the collected performance metrics summary.
+    static void displayMetrics();
+
     // --- Console Utility Methods ---
 
-    // Clears the console screen (platform-dependent implementation).
+    // Clears the console screen (ANSI escape codes; CLS on older Windows consoles).
     static void clearConsole();
 
+    // The renderer all screen output goes through (so it knows what is on screen).
+    static TerminalRenderer& terminal();
+
     // Pauses execution and waits for the user to press Enter (platform-dependent).
     static void pauseScreen();
 
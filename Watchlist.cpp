@@ -0,0 +1,193 @@
+// Watchlist.cpp
+#include "Watchlist.h"
+#include "APIConverter.h"  // Concurrent forecast fetches
+#include "AlertEngine.h"   // Alert rules checked against fetched forecasts
+#include "TaskScheduler.h" // I/O and CPU pools
+#include "Property.h"      // Values and units of the dashboard columns
+#include "Trace.h"         // Optional span tracing
+#include <ctime>           // For std::time (alert evaluation)
+#include <limits>          // For quiet_NaN
+#include <map>             // For reusing entries by location
+#include <utility>         // For std::move
+
+// --- Internal Helper Functions (Anonymous Namespace) ---
+namespace {
+    const double NOT_AVAILABLE = std::numeric_limits<double>::quiet_NaN();
+    // Today and tomorrow, so the next hour exists late in the evening.
+    const int DASHBOARD_DAYS = 2;
+
+    // Value of 'index' in 'weather', or NaN if unset.
+    double valueOf(const Weather* weather, PropertyIndex index) {
+        const Property* property = (weather != nullptr) ? weather->getProperty(index) : nullptr;
+        return (property != nullptr) ? property->getValue() : NOT_AVAILABLE;
+    }
+
+    // Unit of 'index' in 'weather', or empty if unset.
+    std::string unitOf(const Weather* weather, PropertyIndex index) {
+        const Property* property = (weather != nullptr) ? weather->getProperty(index) : nullptr;
+        return (property != nullptr) ? property->getUnit() : std::string();
+    }
+} // end anonymous namespace
+
+// --- Constructor ---
+
+Watchlist::Watchlist(std::chrono::seconds maxAge) : maxAgeSeconds(maxAge), forecasts("watchlist") {}
+
+void Watchlist::setCacheLimits(std::size_t budgetBytes, EvictionPolicy policy) {
+    forecasts.setPolicy(policy);
+    forecasts.setBudget(budgetBytes);
+}
+
+void Watchlist::clear() {
+    entries.clear();
+    forecasts.clear();
+}
+
+void Watchlist::setDataKey(const std::string& key) {
+    if (key == dataKey) { return; }
+    forecasts.clear(); // Every entry is now stale.
+    dataKey = key;
+}
+
+void Watchlist::setAlerts(AlertEngine* engine, AlertSink* sink) {
+    alerts = engine;
+    alertSink = sink;
+}
+
+// --- Locations ---
+
+void Watchlist::setLocations(const std::vector<std::string>& locations) {
+    std::map<std::string, Entry> previous;
+    for (auto& entry : entries) {
+        std::string key = entry.location;
+        previous.emplace(std::move(key), std::move(entry));
+    }
+    entries.clear();
+    entries.reserve(locations.size());
+    for (const auto& location : locations) {
+        auto found = previous.find(location);
+        if (found != previous.end()) {
+            entries.push_back(std::move(found->second));
+            previous.erase(found);
+        } else {
+            Entry entry;
+            entry.location = location;
+            entries.push_back(std::move(entry));
+        }
+    }
+    for (const auto& dropped : previous) { forecasts.erase(dropped.first); }
+}
+
+// --- Refresh ---
+
+bool Watchlist::isStale(const Entry& entry, std::chrono::steady_clock::time_point now) const {
+    return entry.failed || now - entry.fetchedAt >= maxAgeSeconds || !forecasts.contains(entry.location);
+}
+
+std::size_t Watchlist::staleCount(std::chrono::steady_clock::time_point now) const {
+    std::size_t count = 0;
+    for (const auto& entry : entries) {
+        if (isStale(entry, now)) { ++count; }
+    }
+    return count;
+}
+
+FieldMask Watchlist::dashboardFields() {
+    return FieldMask::of({TEMPERATURE, WIND_SPEED, PRECIPITATION, PRECIP_PROBABILITY});
+}
+
+std::size_t Watchlist::refresh(APIConverter& api, const WeatherQuery& base, TaskScheduler& scheduler) {
+    TRACE_SCOPE("Watchlist::refresh", "api");
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::size_t> stale;
+    std::vector<WeatherQuery> queries;
+    // Only the dashboard columns (and those alert rules read) are decoded. Decoding is eager,
+    // so a kept forecast holds no response document and its size is what the cache charges.
+    const bool checkAlerts = alerts != nullptr && alertSink != nullptr && !alerts->getRules().empty();
+    const WeatherQuery dashboardQuery =
+        base.withFields(checkAlerts ? dashboardFields() | alerts->getFields() : dashboardFields());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        if (isStale(entries[i], now)) {
+            stale.push_back(i);
+            queries.push_back(dashboardQuery.withLocation(entries[i].location));
+        }
+    }
+    if (queries.empty()) { return 0; }
+
+    std::vector<std::unique_ptr<ForecastReport>> reports =
+        api.getForecastReports(queries, DASHBOARD_DAYS, ForecastReport::DetailLevel::HOURLY, scheduler);
+
+    std::size_t updated = 0;
+    auto fetchedAt = std::chrono::steady_clock::now();
+    const long long nowEpoch = static_cast<long long>(std::time(nullptr));
+    for (std::size_t k = 0; k < stale.size(); ++k) {
+        Entry& entry = entries[stale[k]];
+        if (reports[k]) {
+            if (checkAlerts) { alerts->evaluate(entry.location, reports[k]->getForecast(), nowEpoch, *alertSink); }
+            std::size_t bytes = reports[k]->sizeBytes();
+            forecasts.put(entry.location, std::shared_ptr<const ForecastReport>(std::move(reports[k])), bytes,
+                          fetchedAt + maxAgeSeconds);
+            entry.fetchedAt = fetchedAt;
+            entry.failed = false;
+            ++updated;
+        } else {
+            entry.failed = true; // Keep showing the previous forecast, marked stale.
+        }
+    }
+    return updated;
+}
+
+// --- Dashboard ---
+
+std::unique_ptr<DashboardReport> Watchlist::buildReport(long long nowEpoch) const {
+    TRACE_SCOPE("Watchlist::buildReport", "render");
+    auto now = std::chrono::steady_clock::now();
+    std::vector<DashboardRow> rows;
+    rows.reserve(entries.size());
+    std::string temperatureUnit, windUnit, precipUnit;
+
+    for (const auto& entry : entries) {
+        DashboardRow row;
+        row.location = entry.location;
+        std::shared_ptr<const ForecastReport> forecast;
+        row.hasData = forecasts.get(entry.location, forecast);
+        row.stale = entry.failed && row.hasData;
+        row.temperature = row.windSpeed = row.precipitation = NOT_AVAILABLE;
+        row.temperatureChange = row.windChange = row.nextPrecipChance = NOT_AVAILABLE;
+        row.ageSeconds = row.hasData
+            ? std::chrono::duration_cast<std::chrono::seconds>(now - entry.fetchedAt).count() : 0;
+        if (!row.hasData) {
+            rows.push_back(std::move(row));
+            continue;
+        }
+
+        // The hour containing 'nowEpoch' (the first hour if the forecast starts later) and the one after.
+        const Weather* current = nullptr;
+        const Weather* next = nullptr;
+        for (const auto& day : forecast->getForecast().getDailyForecasts()) {
+            for (const auto& hour : day.getHourlyForecasts()) {
+                if (current == nullptr || hour.getEpoch() <= nowEpoch) {
+                    current = &hour.getWeather();
+                } else {
+                    next = &hour.getWeather();
+                    break;
+                }
+            }
+            if (next != nullptr) { break; }
+        }
+
+        row.temperature = valueOf(current, TEMPERATURE);
+        row.windSpeed = valueOf(current, WIND_SPEED);
+        row.precipitation = valueOf(current, PRECIPITATION);
+        row.temperatureChange = valueOf(next, TEMPERATURE) - row.temperature;
+        row.windChange = valueOf(next, WIND_SPEED) - row.windSpeed;
+        row.nextPrecipChance = valueOf(next, PRECIP_PROBABILITY);
+        if (temperatureUnit.empty()) {
+            temperatureUnit = unitOf(current, TEMPERATURE);
+            windUnit = unitOf(current, WIND_SPEED);
+            precipUnit = unitOf(current, PRECIPITATION);
+        }
+        rows.push_back(std::move(row));
+    }
+    return std::unique_ptr<DashboardReport>(new DashboardReport(std::move(rows), temperatureUnit, windUnit, precipUnit));
+}
@@ -0,0 +1,79 @@
+// Watchlist.h
+#ifndef WATCHLIST_H
+#define WATCHLIST_H
+
+#include "DashboardReport.h" // Built from the entries
+#include "ForecastReport.h"  // Latest forecast per location
+#include "WeatherQuery.h"    // Request parameters (key, units, priority)
+#include "BudgetCache.h"     // Memory-budgeted forecast store
+#include <chrono>            // For entry ages
+#include <memory>            // For std::shared_ptr, std::unique_ptr
+#include <string>            // For locations
+#include <vector>            // For the entries
+
+class APIConverter;
+class TaskScheduler;
+class AlertEngine;
+class AlertSink;
+
+// Keeps the latest forecast for each watchlist location and refreshes only the ones that are
+// out of date. Stale entries are fetched concurrently (on the scheduler's I/O pool, parsed on
+// its CPU pool), so a refresh takes about as long as its slowest fetch when the I/O pool has a
+// thread per stale entry. Forecasts are held in a memory-budgeted cache ("watchlist" in
+// metrics); an evicted forecast counts as stale and is fetched again on the next refresh.
+// With alerts set, each fetched forecast is checked against the rules under its location.
+// Not thread-safe: refresh and build reports from one thread.
+class Watchlist {
+  public:
+  // One watched location (its forecast, if any, is in the cache under 'location').
+  struct Entry {
+      std::string location;
+      std::chrono::steady_clock::time_point fetchedAt;
+      bool failed = false;                            // The last fetch failed.
+  };
+
+  // 'maxAge': how long a fetched forecast is used before it is fetched again.
+  explicit Watchlist(std::chrono::seconds maxAge = std::chrono::seconds(300));
+
+  // Replaces the watched locations (in display order). Entries for locations that stay on
+  // the list keep their forecasts.
+  void setLocations(const std::vector<std::string>& locations);
+  void setMaxAge(std::chrono::seconds maxAge) { maxAgeSeconds = maxAge; }
+  // Sets the memory budget for the kept forecasts (0 = unlimited) and what is evicted first.
+  void setCacheLimits(std::size_t budgetBytes, EvictionPolicy policy);
+  // Drops every location and forecast.
+  void clear();
+  // Drops every kept forecast when 'key' (what the forecasts depend on, e.g. the API key and
+  // units) differs from the last one, so a dashboard never shows or mixes stale unit systems.
+  void setDataKey(const std::string& key);
+  // Checks every forecast fetched by refresh() against 'engine''s rules (whose properties are
+  // then fetched too) and reports to 'sink'. nullptr for either turns alerts off. Both must
+  // stay valid while refresh() runs.
+  void setAlerts(AlertEngine* engine, AlertSink* sink);
+  const std::vector<Entry>& getEntries() const { return entries; }
+
+  // Returns the number of entries that need fetching: never fetched, failed last time, or
+  // older than the maximum age at 'now'.
+  std::size_t staleCount(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) const;
+  // Fetches every stale entry concurrently, using 'base' for the key, units and priority.
+  // Returns the number of entries updated; failed entries keep their previous forecast.
+  std::size_t refresh(APIConverter& api, const WeatherQuery& base, TaskScheduler& scheduler);
+  // Builds the dashboard for Unix time 'nowEpoch' from the current entries.
+  std::unique_ptr<DashboardReport> buildReport(long long nowEpoch) const;
+
+  // Properties decoded for dashboard forecasts.
+  static FieldMask dashboardFields();
+
+  private:
+  std::vector<Entry> entries;
+  std::chrono::seconds maxAgeSeconds;
+  std::string dataKey; // What the kept forecasts were fetched with (see setDataKey).
+  AlertEngine* alerts = nullptr;   // See setAlerts (nullptr: no alerts).
+  AlertSink* alertSink = nullptr;
+  // Latest forecast per location (mutable: reading one counts as a use for eviction).
+  mutable BudgetCache<std::shared_ptr<const ForecastReport>> forecasts;
+
+  bool isStale(const Entry& entry, std::chrono::steady_clock::time_point now) const;
+};
+
+#endif // WATCHLIST_H
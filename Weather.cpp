@@ -1,10 +1,10 @@
 // Weather.cpp
 #include "Weather.h"
 #include "Property.h" // Definition of Property needed for new/delete
+#include "TimeFormat.h" // Location-local formatting of LAST_UPDATED
 #include <iostream>   // For cerr (error output in setProperty)
 #include <iomanip>    // For stream manipulators (setw, setprecision, left, fixed)
 #include <vector>     // For grouping properties during display
-#include <ctime>      // For time formatting (strftime, localtime_s/r)
 #include <utility>    // For std::move (needed if implementing Rule of Five)
 #include <ostream>    // Included via header, good practice
 #include <string>     // For std::string
@@ -12,6 +12,12 @@
 
 // --- Internal Helper Functions (Anonymous Namespace) ---
 namespace {
+    // Label of a Weather whose time zone was never set (interned once, not per Weather).
+    InternedString utcLabel() {
+        static const InternedString label("UTC");
+        return label;
+    }
+
     // Converts wind direction degrees to a cardinal direction string (e.g., N, NE, E).
     std::string degreesToCardinal(double degrees) {
         degrees = std::fmod(degrees, 360.0);
@@ -25,28 +31,31 @@ namespace {
 
 // --- Private Helper Functions ---
 
+// Copies the properties decoded so far; lazy ones not yet decoded come from the shared source.
 void Weather::copyProperties(const Weather& other) {
     for (int i = 0; i < NUM_PROPERTIES; ++i) {
-        if (other.properties[i] != nullptr) {
-            this->properties[i] = new Property(*(other.properties[i]));
+        const Property* prop = other.properties[i].load(std::memory_order_acquire);
+        if (prop != nullptr) {
+            this->properties[i].store(new Property(*prop), std::memory_order_relaxed);
         } else {
-            this->properties[i] = nullptr;
+            this->properties[i].store(nullptr, std::memory_order_relaxed);
         }
     }
+    lazySource = other.lazySource;
+    lazyFields = other.lazyFields;
 }
 
 void Weather::deleteProperties() {
     for (int i = 0; i < NUM_PROPERTIES; ++i) {
-        delete properties[i];
-        properties[i] = nullptr;
+        delete properties[i].exchange(nullptr);
     }
 }
 
 // --- Constructor / Destructor ---
 
-Weather::Weather() {
+Weather::Weather() : utcOffsetSeconds(0), timeZone(utcLabel()) {
     for (int i = 0; i < NUM_PROPERTIES; ++i) {
-        properties[i] = nullptr;
+        properties[i].store(nullptr, std::memory_order_relaxed);
     }
 }
 
@@ -56,8 +65,8 @@ Weather::~Weather() {
 
 // --- Rule of Three Implementation ---
 
-Weather::Weather(const Weather& other) {
-    for (int i = 0; i < NUM_PROPERTIES; ++i) { properties[i] = nullptr; }
+Weather::Weather(const Weather& other)
+    : utcOffsetSeconds(other.utcOffsetSeconds), timeZone(other.timeZone) {
     copyProperties(other);
 }
 
@@ -65,6 +74,31 @@ Weather& Weather::operator=(const Weather& other) {
     if (this != &other) {
         deleteProperties();
         copyProperties(other);
+        utcOffsetSeconds = other.utcOffsetSeconds;
+        timeZone = other.timeZone;
+    }
+    return *this;
+}
+
+// --- Move Semantics ---
+
+Weather::Weather(Weather&& other) noexcept
+    : lazySource(std::move(other.lazySource)), lazyFields(other.lazyFields),
+      utcOffsetSeconds(other.utcOffsetSeconds), timeZone(std::move(other.timeZone)) {
+    for (int i = 0; i < NUM_PROPERTIES; ++i) {
+        properties[i].store(other.properties[i].exchange(nullptr), std::memory_order_relaxed);
+    }
+}
+
+Weather& Weather::operator=(Weather&& other) noexcept {
+    if (this != &other) {
+        for (int i = 0; i < NUM_PROPERTIES; ++i) {
+            delete properties[i].exchange(other.properties[i].exchange(nullptr));
+        }
+        lazySource = std::move(other.lazySource);
+        lazyFields = other.lazyFields;
+        utcOffsetSeconds = other.utcOffsetSeconds;
+        timeZone = std::move(other.timeZone);
     }
     return *this;
 }
@@ -73,21 +107,71 @@ Weather& Weather::operator=(const Weather& other) {
 
 void Weather::setProperty(PropertyIndex index, Property* property) {
     if (index >= 0 && index < NUM_PROPERTIES) {
-        delete properties[index];
-        properties[index] = property;
+        delete properties[index].exchange(property);
     } else {
         std::cerr << "Error: Invalid property index (" << index << ") in setProperty." << std::endl;
         delete property;
     }
 }
 
-Property* Weather::getProperty(PropertyIndex index) const {
-    if (index >= 0 && index < NUM_PROPERTIES) {
-        return properties[index];
+bool Weather::updateValue(PropertyIndex index, double value) {
+    if (index < 0 || index >= NUM_PROPERTIES) {
+        return false;
     }
-    return nullptr;
+    Property* prop = properties[index].load(std::memory_order_acquire);
+    if (prop == nullptr) {
+        return false;
+    }
+    prop->setValue(value);
+    return true;
 }
 
+const Property* Weather::getProperty(PropertyIndex index) const {
+    if (index < 0 || index >= NUM_PROPERTIES) {
+        return nullptr;
+    }
+    Property* prop = properties[index].load(std::memory_order_acquire);
+    if (prop != nullptr || !lazySource || !lazyFields.has(index)) {
+        return prop;
+    }
+    // Lazy mode: decode now. If another thread won the race, keep its copy and drop ours.
+    Property* decoded = lazySource->decode(index);
+    if (decoded == nullptr) {
+        return nullptr;
+    }
+    Property* expected = nullptr;
+    if (properties[index].compare_exchange_strong(expected, decoded, std::memory_order_acq_rel)) {
+        return decoded;
+    }
+    delete decoded;
+    return expected;
+}
+
+void Weather::setLazySource(std::shared_ptr<const PropertySource> source, FieldMask fields) {
+    lazySource = std::move(source);
+    lazyFields = fields;
+}
+
+
+// --- Size Accounting ---
+
+std::size_t Weather::sizeBytes() const {
+    std::size_t bytes = sizeof(Weather);
+    for (const auto& slot : properties) {
+        if (slot.load(std::memory_order_acquire) != nullptr) { bytes += sizeof(Property); }
+    }
+    return bytes;
+}
+
+// --- Time Zone ---
+
+void Weather::setTimeZone(int offsetSeconds, InternedString label) {
+    utcOffsetSeconds = offsetSeconds;
+    timeZone = label;
+}
+
+int Weather::getUtcOffsetSeconds() const { return utcOffsetSeconds; }
+const std::string& Weather::getTimeZone() const { return timeZone; }
 
 // --- Display Helper ---
 
@@ -98,8 +182,9 @@ void Weather::displayData(std::ostream& os) const {
     // Simpler grouping compared to previous subtitle version.
     const std::vector<PropertyIndex> displayOrder = {
         TEMPERATURE, FEELS_LIKE,
+        APPARENT_TEMP, HEAT_INDEX, WIND_CHILL, DEW_POINT, // Derived comfort group
         WIND_SPEED, GUST_SPEED, WIND_DIRECTION, // Wind group
-        PRECIPITATION, HUMIDITY, CLOUD, PRESSURE, // Conditions group
+        PRECIPITATION, PRECIP_PROBABILITY, HUMIDITY, CLOUD, PRESSURE, // Conditions group
         VISIBILITY, UV,                          // Other group
         LAST_UPDATED                             // Time group
     };
@@ -122,20 +207,9 @@ void Weather::displayData(std::ostream& os) const {
                    << " (" << std::fixed << std::setprecision(1) << prop->getValue() << "\370)"; // Using \370 for degree symbol
 
             } else if (index == LAST_UPDATED) {
-                // Format epoch time for Last Updated.
-                time_t epochTime = static_cast<time_t>(prop->getValue());
-                std::tm timeinfo = {};
-                #ifdef _WIN32
-                     localtime_s(&timeinfo, &epochTime);
-                #else // POSIX
-                     localtime_r(&epochTime, &timeinfo);
-                #endif
-                char time_buf[100];
-                if (std::strftime(time_buf, sizeof(time_buf), "%Y-%m-%d %H:%M:%S %Z", &timeinfo)) {
-                    os << time_buf;
-                } else {
-                    os << "(time formatting error)";
-                }
+                // Format epoch time for Last Updated in the location's own time zone.
+                os << TimeFormat::formatDateTime(static_cast<long long>(prop->getValue()), utcOffsetSeconds)
+                   << " " << timeZone;
             } else {
                 // Default formatting for numerical values.
                 os << std::fixed << std::setprecision(1) << prop->getValue();
@@ -143,12 +217,12 @@ void Weather::displayData(std::ostream& os) const {
                     os << " " << prop->getUnit();
                 }
             }
-            os << std::endl; // Newline after each property line
+            os << '\n'; // Newline after each property line
         }
     }
 
     // If no properties were found or displayed at all, print a placeholder message.
     if (!dataDisplayed) {
-        os << "  (No specific weather data available)" << std::endl;
+        os << "  (No specific weather data available)\n";
     }
 }
\ No newline at end of file
@@ -4,9 +4,14 @@
 
 #include "Property.h" // Defines the Property class used in the array
 #include <ostream>    // For the displayData method parameter
+#include "InternedString.h" // Shared time zone label
+#include <string>     // For the time zone label
 #include <vector>     // Used in displayData implementation
-#include <ctime>      // Used in displayData implementation for time formatting
 #include <iomanip>    // Used in displayData implementation for formatting
+#include <atomic>     // Property slots filled on first access
+#include <memory>     // For the shared lazy property source
+#include <initializer_list> // For FieldMask::of
+#include <cstddef>    // For sizeBytes
 
 // Enum defining indices for accessing specific weather properties in the array.
 // Provides type safety and readability compared to magic numbers.
@@ -23,15 +28,71 @@ enum PropertyIndex {
     PRECIPITATION,
     CLOUD,
     LAST_UPDATED,
+    // Derived values computed by DerivedMetrics (not reported by the API).
+    DEW_POINT,
+    HEAT_INDEX,
+    WIND_CHILL,
+    APPARENT_TEMP,
+    PRECIP_PROBABILITY, // Chance of precipitation (%); for a day, the rollup over its hours.
     NUM_PROPERTIES // Sentinel value indicating the total number of properties
 };
 
+// A set of PropertyIndex values (a field projection), e.g. "only temperature and precip".
+// Callers declare the fields they will read so parsers can skip decoding the rest.
+class FieldMask {
+private:
+    unsigned long bits; // Bit i is set when PropertyIndex i is included.
+    explicit constexpr FieldMask(unsigned long b) : bits(b) {}
+
+public:
+    // Default Constructor: the empty set.
+    constexpr FieldMask() : bits(0) {}
+    // Returns the set of every property.
+    static constexpr FieldMask all() { return FieldMask((1UL << NUM_PROPERTIES) - 1); }
+    // Returns the set of the listed properties, e.g. FieldMask::of({TEMPERATURE, PRECIPITATION}).
+    static FieldMask of(std::initializer_list<PropertyIndex> indices) {
+        FieldMask mask;
+        for (PropertyIndex index : indices) { mask = mask.with(index); }
+        return mask;
+    }
+
+    // Returns this set plus 'index' (invalid indices are ignored).
+    constexpr FieldMask with(PropertyIndex index) const {
+        return (index >= 0 && index < NUM_PROPERTIES) ? FieldMask(bits | (1UL << index)) : *this;
+    }
+    // Returns the union of both sets.
+    constexpr FieldMask operator|(FieldMask other) const { return FieldMask(bits | other.bits); }
+    // Returns true if 'index' is in the set.
+    constexpr bool has(PropertyIndex index) const {
+        return index >= 0 && index < NUM_PROPERTIES && ((bits >> index) & 1UL) != 0;
+    }
+    // Returns true if the set contains at least one of the properties in 'other'.
+    constexpr bool hasAny(FieldMask other) const { return (bits & other.bits) != 0; }
+};
+
+// Decodes properties on demand for a Weather in lazy mode (see Weather::setLazySource).
+// Implementations must be safe to call from several threads at once.
+class PropertySource {
+public:
+    virtual ~PropertySource() = default;
+    // Returns a newly allocated Property for 'index' (caller takes ownership), or nullptr if
+    // the source has no value for it.
+    virtual Property* decode(PropertyIndex index) const = 0;
+};
+
 // Represents a collection of weather properties at a specific point in time or for a summary period.
 // Manages the lifetime of Property objects stored within it.
 class Weather {
 private:
-    // Fixed-size array of pointers to Property objects.
-    Property* properties[NUM_PROPERTIES];
+    // Fixed-size array of pointers to Property objects. Slots are atomic because a lazy
+    // Weather fills them on first read, possibly from several threads (via const getProperty).
+    mutable std::atomic<Property*> properties[NUM_PROPERTIES];
+    // Lazy mode: where missing properties in 'lazyFields' are decoded from (nullptr = eager).
+    std::shared_ptr<const PropertySource> lazySource;
+    FieldMask lazyFields;
+    // Time zone of the location these readings belong to (used to show LAST_UPDATED).
+    int utcOffsetSeconds;
+    InternedString timeZone;
 
     // --- Private Helper Methods for Resource Management (Rule of Three/Five) ---
 
@@ -53,11 +114,11 @@ public:
     // Copy Assignment Operator: Handles self-assignment and performs a deep copy.
     Weather& operator=(const Weather& other);
 
-    // --- Rule of Five (Move Semantics - Optional but recommended for C++11+) ---
-    // Move Constructor (Optional): Efficiently transfers ownership of resources.
-    // Weather(Weather&& other) noexcept; // Declare if implementing
-    // Move Assignment Operator (Optional): Efficiently transfers ownership of resources.
-    // Weather& operator=(Weather&& other) noexcept; // Declare if implementing
+    // --- Rule of Five (Move Semantics) ---
+    // Move Constructor: Transfers ownership of the Property objects (no reallocation).
+    Weather(Weather&& other) noexcept;
+    // Move Assignment Operator: Releases this object's properties and takes the other's.
+    Weather& operator=(Weather&& other) noexcept;
 
 
     // --- Property Management ---
@@ -67,10 +128,32 @@ public:
     // Note: If index is invalid, the provided property is deleted to prevent leaks.
     void setProperty(PropertyIndex index, Property* property);
 
-    // Retrieves a non-owning (raw) pointer to the Property object at the specified index.
+    // Changes the value of an existing property in place, keeping its allocation.
+    // Returns false (and changes nothing) if no property is set at 'index'.
+    bool updateValue(PropertyIndex index, double value);
+
+    // Retrieves a non-owning, read-only pointer to the Property object at the specified index.
     // Returns nullptr if the index is invalid or no property is set at that index.
-    // The caller MUST NOT delete the returned pointer.
-    Property* getProperty(PropertyIndex index) const;
+    // In lazy mode, a property in the lazy field set is decoded by the first call that asks for it.
+    // The caller MUST NOT delete the returned pointer. Use setProperty to change a value.
+    const Property* getProperty(PropertyIndex index) const;
+
+    // Switches to lazy mode: properties in 'fields' that are not set are decoded from 'source'
+    // when first requested. Copies share the source.
+    void setLazySource(std::shared_ptr<const PropertySource> source, FieldMask fields);
+
+    // Returns the bytes this Weather holds: the object and every Property set or decoded so
+    // far. Interned names and units are shared, and so is a lazy source, so neither counts.
+    std::size_t sizeBytes() const;
+
+    // --- Time Zone ---
+
+    // Sets the location's UTC offset and a label for it (e.g., the API's tz_id).
+    void setTimeZone(int offsetSeconds, InternedString label);
+    // Returns the UTC offset in seconds (0 if never set).
+    int getUtcOffsetSeconds() const;
+    // Returns the time zone label ("UTC" if never set).
+    const std::string& getTimeZone() const;
 
     // --- Display Helper ---
 
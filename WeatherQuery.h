@@ -0,0 +1,68 @@
+// WeatherQuery.h
+#ifndef WEATHERQUERY_H
+#define WEATHERQUERY_H
+
+#include "RateLimiter.h" // RequestPriority enum
+#include "Weather.h"     // FieldMask (field projection)
+#include <string>        // For key, location and units
+#include <utility>       // For std::move
+
+// Immutable set of parameters for a single API request.
+// Passed by const reference to each APIConverter call, so one converter can serve
+// different locations/units from several threads without shared mutable state.
+class WeatherQuery {
+private:
+    std::string apiKey;       // API key for authentication.
+    std::string location;     // Target location (e.g., "City", "lat,lon").
+    std::string units;        // "Metric" or "Imperial" (anything else is treated as Metric).
+    RequestPriority priority; // Scheduling priority for the rate limiter.
+    FieldMask fields;         // Properties the caller will read; others are not decoded.
+    bool lazy;                // Decode forecast hours on first access instead of up front.
+
+public:
+    // Constructor: Captures all request parameters up front; there are no setters.
+    WeatherQuery(std::string key, std::string loc, std::string unit,
+                 RequestPriority prio = RequestPriority::INTERACTIVE)
+        : apiKey(std::move(key)), location(std::move(loc)), units(std::move(unit)), priority(prio),
+          fields(FieldMask::all()), lazy(false) {}
+
+    // --- Getters (read-only access) ---
+    const std::string& getApiKey() const { return apiKey; }
+    const std::string& getLocation() const { return location; }
+    const std::string& getUnits() const { return units; }
+    RequestPriority getPriority() const { return priority; }
+    FieldMask getFields() const { return fields; }
+    bool isLazy() const { return lazy; }
+    // Returns true if values should be requested in imperial units.
+    bool isImperial() const { return units == "Imperial"; }
+
+    // Returns a copy of this query for another location (e.g., one watchlist entry).
+    WeatherQuery withLocation(std::string loc) const {
+        WeatherQuery copy(*this);
+        copy.location = std::move(loc);
+        return copy;
+    }
+
+    // Returns a copy of this query with a different priority (e.g., for background refreshes).
+    WeatherQuery withPriority(RequestPriority prio) const {
+        WeatherQuery copy(*this);
+        copy.priority = prio;
+        return copy;
+    }
+    // Returns a copy of this query that only decodes 'projection' (e.g. for bulk consumers that
+    // read a few fields). Properties outside the projection are left unset in the result.
+    WeatherQuery withFields(FieldMask projection) const {
+        WeatherQuery copy(*this);
+        copy.fields = projection;
+        return copy;
+    }
+    // Returns a copy of this query whose forecast hours keep the parsed response and decode
+    // each property only when getProperty first asks for it.
+    WeatherQuery withLazyDecoding(bool enabled = true) const {
+        WeatherQuery copy(*this);
+        copy.lazy = enabled;
+        return copy;
+    }
+};
+
+#endif // WEATHERQUERY_H
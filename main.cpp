@@ -6,15 +6,49 @@
 #include "CurrentWeatherReport.h" // Concrete report for current weather
 #include "ForecastReport.h"    // Concrete report for forecast weather
 #include "IDisplayable.h"      // Interface for displayable objects (used by UI)
+#include "MetricsServer.h"     // Optional Prometheus endpoint
+#include "Trace.h"             // Optional Chrome trace recording
+#include "RateLimiter.h"       // Shared request budget and quota accounting
+#include "WeatherQuery.h"      // Immutable per-request parameters
+#include "Snapshot.h"          // Atomically published report versions
+#include "TaskScheduler.h"     // CPU pool for building large forecasts
+#include "AlertEngine.h"       // Threshold alerts evaluated over fetched forecasts
+#include "SettingsWatcher.h"   // Reloads settings.txt when it is edited
+#include "Watchlist.h"         // Multi-location dashboard
+#include "ForecastExporter.h"  // Columnar/text export of forecasts
+#include "StartupCache.h"      // Last shown report, kept on disk for the next start
+#include "LiveMode.h"          // Auto-refreshing screen driven by an event loop
+#include "Metrics.h"           // Time to first render
+#include "LocationResolver.h"  // Shares requests between nearby and same-place queries
 
 #include <iostream> // For console input/output (cout, cerr)
-#include <memory>   // For std::unique_ptr (manages report objects)
+#include <memory>   // For std::unique_ptr/shared_ptr (manages report objects)
 #include <string>   // For string manipulation
+#include <ctime>    // For the current time when evaluating alerts
+#include <chrono>   // For the response cache lifetime
+#include <vector>   // For export batches
+#include <algorithm> // For std::min, std::max
 
 int main() {
+    // Time to first render is measured from here.
+    const auto startTime = std::chrono::steady_clock::now();
+    bool firstRenderRecorded = false;
+    auto recordFirstRender = [&]() {
+        if (!firstRenderRecorded) {
+            firstRenderRecorded = true;
+            Metrics::recordLatency(MetricStage::STARTUP, std::chrono::steady_clock::now() - startTime);
+        }
+    };
+
     // --- Initialization Phase ---
     Preferences prefs; // Loads settings from "settings.txt" or uses defaults.
 
+    // Record spans for the whole session if a trace file is configured.
+    if (!prefs.getTraceFile().empty()) {
+        Trace::enable();
+        Trace::setThreadName("main");
+    }
+
     // Ensure the API key is present, prompt user if missing.
     if (prefs.getApiKey().empty()) {
         std::cout << "API Key not found or empty in settings.txt." << std::endl;
@@ -27,47 +61,165 @@ int main() {
         prefs.saveSettings(); // Attempt to save it back to the file
     }
 
-    // Create the API converter instance and configure it from preferences.
-    APIConverter apiConverter; // Uses default WeatherAPI base URL
-    apiConverter.setApiKey(prefs.getApiKey());
-    apiConverter.setLocation(prefs.getLocation());
-    apiConverter.setUnits(prefs.getUnits());
+    // Create the API converter instance. Key, location and units are passed per request.
+    // Cheap: HTTP clients (and any TLS context) are created by the first request.
+    APIConverter apiConverter(prefs.getApiBaseUrl()); // WeatherAPI, or a local mock server if configured
+
+    // Most recently fetched report. Published as an immutable snapshot so it can be read
+    // (e.g., by a future background refresher or renderer) while a newer one is being built.
+    Snapshot<WeatherReport> latestReport;
+
+    // --- First Render (from the on-disk cache) ---
+    // The last report shown for this location and units is displayed before the thread pools,
+    // servers and HTTP clients exist, and before any network request.
+    StartupCache startupCache(prefs.pathNextToSettings("lastreport.cache"));
+    bool showingCachedReport = false;
+    {
+        CachedReport cached;
+        if (startupCache.load(cached) && cached.location == prefs.getLocation() && cached.units == prefs.getUnits()) {
+            const WeatherQuery cachedQuery(prefs.getApiKey(), cached.location, cached.units);
+            UI::clearConsole();
+            UI::displayCachedReportNotice(static_cast<long long>(std::time(nullptr)) - cached.fetchedEpoch);
+            std::unique_ptr<WeatherReport> report;
+            if (cached.kind == CachedReport::Kind::CURRENT) {
+                report = APIConverter::parseCurrentWeather(cached.body, cachedQuery);
+            } else {
+                report = APIConverter::parseForecastReport(cached.body, cachedQuery.withLazyDecoding(), cached.detail);
+            }
+            if (report) {
+                latestReport.publish(std::move(report));
+                UI::displayReport(*latestReport.load());
+                recordFirstRender();
+                showingCachedReport = true;
+            }
+        }
+    }
+
+    // One limiter for every request path, with usage persisted next to settings.txt.
+    RateLimitConfig limitConfig;
+    limitConfig.requestsPerSecond = prefs.getRateLimit();
+    limitConfig.burst = prefs.getRateLimit() * 2.0;
+    limitConfig.monthlyQuota = prefs.getMonthlyQuota();
+    auto rateLimiter = std::make_shared<RateLimiter>(limitConfig, prefs.pathNextToSettings("quota.txt"));
+    apiConverter.setRateLimiter(rateLimiter);
+    // Long (8+ day) forecasts build their days in parallel (by default on one worker per core).
+    // The dashboard fetches its locations on the same pools.
+    int schedulerIoThreads = prefs.getIoThreads();
+    int schedulerCpuThreads = prefs.getCpuThreads();
+    auto taskScheduler = std::make_shared<TaskScheduler>(schedulerIoThreads, schedulerCpuThreads);
+    apiConverter.setTaskScheduler(taskScheduler);
+    apiConverter.setCacheTtl(std::chrono::seconds(prefs.getCacheTtl()));
+    // Nearby and same-place queries are sent as one location, so they share cached responses.
+    auto locationResolver = std::make_shared<LocationResolver>(prefs.getLocationGrid(), prefs.getLocationRadius());
+    apiConverter.setLocationResolver(locationResolver);
+
+    // Latest forecast per watchlist location; only out-of-date entries are refetched.
+    Watchlist watchlist(std::chrono::seconds(prefs.getRefreshInterval()));
+
+    // Live screen; keeps its last report per view between visits.
+    LiveMode liveMode(apiConverter, UI::terminal());
+
+    // Every in-process cache gets the configured memory budget and eviction policy.
+    auto applyCacheLimits = [&]() {
+        EvictionPolicy policy = EvictionPolicy::LRU;
+        parseEvictionPolicy(prefs.getCachePolicy(), policy);
+        std::size_t budgetBytes = static_cast<std::size_t>(prefs.getCacheBudgetMb()) * 1024 * 1024;
+        apiConverter.setCacheLimits(budgetBytes, policy);
+        watchlist.setCacheLimits(budgetBytes, policy);
+        liveMode.setCacheLimits(budgetBytes, policy);
+    };
+    applyCacheLimits();
+
+    // Applies settings that can change while running (after a reload of settings.txt).
+    // Location, units and forecast days are read per request; the converter, its caches and
+    // its connections are kept.
+    auto applyRuntimeSettings = [&]() {
+        apiConverter.setCacheTtl(std::chrono::seconds(prefs.getCacheTtl()));
+        watchlist.setMaxAge(std::chrono::seconds(prefs.getRefreshInterval()));
+        applyCacheLimits();
+        locationResolver->setGrid(prefs.getLocationGrid());
+        locationResolver->setRadius(prefs.getLocationRadius());
+        if (prefs.getIoThreads() != schedulerIoThreads || prefs.getCpuThreads() != schedulerCpuThreads) {
+            schedulerIoThreads = prefs.getIoThreads();
+            schedulerCpuThreads = prefs.getCpuThreads();
+            taskScheduler = std::make_shared<TaskScheduler>(schedulerIoThreads, schedulerCpuThreads);
+            apiConverter.setTaskScheduler(taskScheduler);
+        }
+    };
+
+    SettingsWatcher settingsWatcher(prefs.getSettingsFilename());
+    settingsWatcher.start();
+
+    // Expose metrics for scraping if a port is configured.
+    MetricsServer metricsServer;
+    if (prefs.getMetricsPort() > 0 && metricsServer.start("0.0.0.0", prefs.getMetricsPort())) {
+        std::cout << "Metrics available at http://localhost:" << prefs.getMetricsPort() << "/metrics" << std::endl;
+    }
+
+    // Optional alert rules (alerts.txt next to settings.txt), checked against each forecast.
+    AlertEngine alertEngine;
+    if (alertEngine.loadRules(prefs.pathNextToSettings("alerts.txt"))) {
+        std::cout << "Loaded " << alertEngine.getRules().size() << " alert rule(s)." << std::endl;
+    }
+    StreamAlertSink alertSink(std::cout);
+    // Watchlist forecasts are checked as they are fetched; Live Mode shows its alerts on screen.
+    watchlist.setAlerts(&alertEngine, &alertSink);
+    liveMode.setAlerts(&alertEngine);
 
     // --- Main Application Loop ---
     int choice = 0;
-    const int EXIT_CHOICE = 7; // Define the exit menu option number
+    const int EXIT_CHOICE = 12; // Define the exit menu option number
 
     do {
-        UI::clearConsole();          // Clear the screen for a fresh display
-        UI::displayPreferences(prefs); // Show current settings
-        UI::displayMenu();            // Show the main menu
+        // Pick up edits made to settings.txt since the last menu.
+        if (settingsWatcher.takeChange() && prefs.reloadSettings()) {
+            applyRuntimeSettings();
+        }
+
+        // Current settings and the menu, as one screen. The cached report stays above the first menu only.
+        UI::displayMainScreen(prefs, !showingCachedReport);
+        showingCachedReport = false;
+        recordFirstRender();          // No cached report: the menu is the first screen.
         choice = UI::getMenuChoice(1, EXIT_CHOICE); // Get valid user input
 
         // Use a smart pointer to manage the dynamically created report object.
         std::unique_ptr<WeatherReport> report = nullptr;
+        // What a successful fetch returned, kept on disk for the next start.
+        CachedReport fetched;
+        // Request parameters captured from the current preferences.
+        const WeatherQuery query(prefs.getApiKey(), prefs.getLocation(), prefs.getUnits());
 
         // Process the user's menu choice.
         switch (choice) {
             case 1: { // Get Current Weather - Braces optional here as no variables declared
                 std::cout << "\nFetching Current Weather..." << std::endl;
-                report = apiConverter.getCurrentWeather(); // Fetch and store report
+                report = apiConverter.getCurrentWeather(query, &fetched.body); // Fetch and store report
+                fetched.kind = CachedReport::Kind::CURRENT;
                 break;
             }
             case 2: { // Get Hourly Forecast - Braces optional here
                 std::cout << "\nFetching Hourly Forecast..." << std::endl;
-                report = apiConverter.getForecastReport(prefs.getForecastDays(), ForecastReport::DetailLevel::HOURLY);
+                // Lazy: the table decodes only the hourly fields it shows.
+                fetched.kind = CachedReport::Kind::FORECAST;
+                fetched.detail = ForecastReport::DetailLevel::HOURLY;
+                report = apiConverter.getForecastReport(query.withLazyDecoding(), prefs.getForecastDays(), fetched.detail, &fetched.body);
                 break;
             }
             case 3: { // Get Daily Forecast - Braces optional here
                 std::cout << "\nFetching Daily Forecast Summary..." << std::endl;
-                report = apiConverter.getForecastReport(prefs.getForecastDays(), ForecastReport::DetailLevel::DAILY);
+                // Lazy: the daily view never reads hourly data, so no hour is decoded.
+                fetched.kind = CachedReport::Kind::FORECAST;
+                fetched.detail = ForecastReport::DetailLevel::DAILY;
+                report = apiConverter.getForecastReport(query.withLazyDecoding(), prefs.getForecastDays(), fetched.detail, &fetched.body);
                 break;
             }
             case 4: { // Update Location - **ADDED BRACES**
-                std::string newLocation = UI::getTextInput("Enter new location (e.g., City, zip, lat,lon): ");
+                std::string newLocation = UI::getTextInput("Enter new location or profile name (e.g., City, zip, lat,lon, home): ");
                 if (!newLocation.empty()) {
-                    prefs.setLocation(newLocation);       // Update preferences object
-                    apiConverter.setLocation(newLocation); // Update API converter state
+                    // A saved profile name switches to that profile; anything else is a location.
+                    if (!prefs.useProfile(newLocation)) {
+                        prefs.setLocation(newLocation); // Used by the next request's query
+                    }
                     std::cout << (prefs.saveSettings() ? "Location updated and saved." : "Location updated for session, but failed to save.") << std::endl;
                 } else {
                     std::cout << "Location not changed (input was empty)." << std::endl;
@@ -77,8 +229,7 @@ int main() {
             } // ** END BRACE **
             case 5: { // Update Units - **ADDED BRACES**
                  std::string newUnits = UI::getUnitsInput(); // Get validated "Metric" or "Imperial"
-                 if (prefs.setUnits(newUnits)) { // Update prefs (validated)
-                      apiConverter.setUnits(newUnits); // Update API converter state
+                 if (prefs.setUnits(newUnits)) { // Update prefs (validated), used by the next query
                       std::cout << (prefs.saveSettings() ? "Units updated and saved." : "Units updated for session, but failed to save.") << std::endl;
                  } // else: setUnits already printed a warning
                  UI::pauseScreen();
@@ -93,6 +244,95 @@ int main() {
                  UI::pauseScreen();
                  continue; // Skip report display
             } // ** END BRACE **
+            case 7: { // View Performance Metrics
+                UI::displayMetrics();
+                std::cout << "  API calls this month: " << rateLimiter->getMonthlyUsage();
+                if (rateLimiter->getMonthlyQuota() > 0) { std::cout << " of " << rateLimiter->getMonthlyQuota(); }
+                std::cout << std::endl;
+                UI::pauseScreen();
+                continue; // Skip report display
+            }
+            case 8: { // Watchlist Dashboard
+                if (prefs.getWatchlist().empty()) {
+                    std::cout << "\nThe watchlist is empty. Add locations with option 9." << std::endl;
+                    UI::pauseScreen();
+                    continue; // Nothing to show
+                }
+                watchlist.setLocations(prefs.getWatchlist());
+                watchlist.setDataKey(query.getApiKey() + '\n' + query.getUnits()); // Refetch after a key or units change.
+                std::size_t stale = watchlist.staleCount();
+                if (stale > 0) {
+                    std::cout << "\nRefreshing " << stale << " of " << prefs.getWatchlist().size() << " location(s)..." << std::endl;
+                    watchlist.refresh(apiConverter, query, *taskScheduler);
+                }
+                report = watchlist.buildReport(static_cast<long long>(std::time(nullptr)));
+                break;
+            }
+            case 9: { // Edit Watchlist
+                std::string entry = UI::getTextInput("Enter a location to add to the watchlist (prefix with '-' to remove): ");
+                bool changed = false;
+                if (entry.size() > 1 && entry[0] == '-') {
+                    changed = prefs.removeFromWatchlist(entry.substr(1));
+                    std::cout << (changed ? "Removed from the watchlist." : "That location is not in the watchlist.") << std::endl;
+                } else if (!entry.empty()) {
+                    changed = prefs.addToWatchlist(entry);
+                    std::cout << (changed ? "Added to the watchlist." : "That location is already in the watchlist.") << std::endl;
+                } else {
+                    std::cout << "Watchlist not changed (input was empty)." << std::endl;
+                }
+                if (changed && !prefs.saveSettings()) {
+                    std::cout << "Watchlist updated for session, but failed to save." << std::endl;
+                }
+                UI::pauseScreen();
+                continue; // Skip report display
+            }
+            case 10: { // Export Forecasts
+                std::string path = UI::getTextInput("Export file (.csv, .ndjson or .arrow): ");
+                size_t dot = path.find_last_of('.');
+                ExportOptions exportOptions;
+                if (dot == std::string::npos || !ForecastExporter::parseFormat(path.substr(dot + 1), exportOptions.format)) {
+                    std::cout << "Unknown export format (use a .csv, .ndjson or .arrow file name)." << std::endl;
+                    UI::pauseScreen();
+                    continue;
+                }
+                // The watchlist, or the current location if it is empty.
+                std::vector<std::string> locations = prefs.getWatchlist();
+                if (locations.empty()) { locations.push_back(prefs.getLocation()); }
+
+                ForecastExporter exporter(path, exportOptions);
+                if (!exporter.isOpen()) {
+                    UI::pauseScreen();
+                    continue;
+                }
+                // Fetch a few locations at a time and write each as it arrives, so memory
+                // holds one batch of forecasts however long the list is.
+                const size_t batchSize = static_cast<size_t>(std::max(1, prefs.getIoThreads()));
+                size_t exported = 0;
+                for (size_t start = 0; start < locations.size(); start += batchSize) {
+                    size_t end = std::min(locations.size(), start + batchSize);
+                    std::vector<WeatherQuery> queries;
+                    for (size_t i = start; i < end; ++i) {
+                        queries.push_back(query.withLocation(locations[i]).withLazyDecoding());
+                    }
+                    auto forecasts = apiConverter.getForecastReports(queries, prefs.getForecastDays(),
+                                                                     ForecastReport::DetailLevel::HOURLY, *taskScheduler);
+                    for (size_t i = 0; i < forecasts.size(); ++i) {
+                        if (forecasts[i] && exporter.write(locations[start + i], forecasts[i]->getForecast())) { ++exported; }
+                    }
+                }
+                if (exporter.finish()) {
+                    std::cout << "Exported " << exporter.getRowCount() << " row(s) for " << exported << " of "
+                              << locations.size() << " location(s) to '" << path << "'." << std::endl;
+                }
+                UI::pauseScreen();
+                continue; // Skip report display
+            }
+            case 11: { // Live Mode
+                // Runs until 'q'; settings edited meanwhile apply when the menu returns.
+                liveMode.run(query, prefs.getForecastDays(), prefs.getWatchlist(),
+                             std::chrono::seconds(prefs.getRefreshInterval()), taskScheduler);
+                continue; // Back to the menu (no pause needed)
+            }
             case EXIT_CHOICE: { // Exit - Braces optional here
                 std::cout << "Exiting Weather App..." << std::endl;
                 continue; // Proceed to loop termination condition
@@ -106,9 +346,26 @@ int main() {
 
         // --- Display Report (if a report was generated) ---
         if (report) {
+            if (!fetched.body.empty()) {
+                fetched.days = prefs.getForecastDays();
+                fetched.location = query.getLocation();
+                fetched.units = query.getUnits();
+                fetched.fetchedEpoch = static_cast<long long>(std::time(nullptr));
+                startupCache.save(fetched); // Written in the background.
+            }
+            // Publish the finished report; from here on it is read-only.
+            latestReport.publish(std::move(report));
              // Use the UI's display method, which leverages the IDisplayable interface
              // for polymorphic display of the specific report type.
-            UI::displayReport(*report);
+            std::shared_ptr<const WeatherReport> shown = latestReport.load();
+            UI::displayReport(*shown);
+
+            // Report alert rules that started or stopped matching for this location.
+            const auto* forecastReport = dynamic_cast<const ForecastReport*>(shown.get());
+            if (forecastReport != nullptr && !alertEngine.getRules().empty()) {
+                alertEngine.evaluate(prefs.getLocation(), forecastReport->getForecast(),
+                                     static_cast<long long>(std::time(nullptr)), alertSink);
+            }
         } else if (choice != EXIT_CHOICE) {
              // If no report was generated (API call likely failed) and not exiting.
              std::cout << "\n*** Failed to retrieve or process the requested weather data. ***" << std::endl;
@@ -122,5 +379,10 @@ int main() {
 
     } while (choice != EXIT_CHOICE); // Loop continues until user chooses to exit
 
+    // Write the recorded spans (open in chrome://tracing or ui.perfetto.dev).
+    if (Trace::isEnabled() && Trace::writeChromeJson(prefs.getTraceFile())) {
+        std::cout << "Trace written to '" << prefs.getTraceFile() << "'." << std::endl;
+    }
+
     return 0; // Indicate successful execution
 }
\ No newline at end of file